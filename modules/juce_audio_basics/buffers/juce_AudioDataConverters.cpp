@@ -460,6 +460,331 @@ void AudioDataConverters::deinterleaveSamples (const float* source, float** dest
 }
 
 
+//==============================================================================
+//==============================================================================
+namespace BlockConversionHelpers
+{
+    // The block conversions below always have a native-endian Float32 or Int32 array on one side,
+    // and are only implemented for little-endian machines.
+    inline bool isNativeArray (int stride, bool isBigEndian) noexcept
+    {
+       #if JUCE_LITTLE_ENDIAN
+        return stride == 4 && ! isBigEndian;
+       #else
+        ignoreUnused (stride, isBigEndian);
+        return false;
+       #endif
+    }
+
+    inline uint32 readUnaligned32 (const char* p) noexcept   { uint32 v; memcpy (&v, p, sizeof (v)); return v; }
+    inline uint16 readUnaligned16 (const char* p) noexcept   { uint16 v; memcpy (&v, p, sizeof (v)); return v; }
+
+    constexpr float int32ToFloatScale = 1.0f / 2147483648.0f;
+
+   #if JUCE_USE_SSE_INTRINSICS
+    inline __m128i swapBytesInEachInt16 (__m128i v) noexcept
+    {
+        return _mm_or_si128 (_mm_slli_epi16 (v, 8), _mm_srli_epi16 (v, 8));
+    }
+
+    inline __m128i swapBytesInEachInt32 (__m128i v) noexcept
+    {
+        v = swapBytesInEachInt16 (v);
+        return _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (v, _MM_SHUFFLE (2, 3, 0, 1)), _MM_SHUFFLE (2, 3, 0, 1));
+    }
+
+    // Loads 4 packed 24-bit samples, shifted up to fill 32-bit ints. This reads the byte after
+    // each sample, and when they're contiguous it loads 16 bytes, so the caller must leave
+    // enough samples at the end of the block.
+    inline __m128i loadInt24x4 (const char* source, int stride, bool bigEndian) noexcept
+    {
+        __m128i v;
+
+        if (stride == 3)
+        {
+            auto bytes = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (source));
+            v = _mm_unpacklo_epi64 (_mm_unpacklo_epi32 (bytes, _mm_srli_si128 (bytes, 3)),
+                                    _mm_unpacklo_epi32 (_mm_srli_si128 (bytes, 6), _mm_srli_si128 (bytes, 9)));
+        }
+        else
+        {
+            v = _mm_setr_epi32 ((int) readUnaligned32 (source),
+                                (int) readUnaligned32 (source + stride),
+                                (int) readUnaligned32 (source + 2 * stride),
+                                (int) readUnaligned32 (source + 3 * stride));
+        }
+
+        return bigEndian ? _mm_and_si128 (swapBytesInEachInt32 (v), _mm_set1_epi32 ((int) 0xffffff00))
+                         : _mm_slli_epi32 (v, 8);
+    }
+
+    // Loads 4 16-bit samples, shifted up to fill 32-bit ints
+    inline __m128i loadInt16x4 (const char* source, int stride, bool bigEndian) noexcept
+    {
+        __m128i v;
+
+        if (stride == 2)
+            v = _mm_loadl_epi64 (reinterpret_cast<const __m128i*> (source));
+        else
+            v = _mm_setr_epi16 ((short) readUnaligned16 (source),
+                                (short) readUnaligned16 (source + stride),
+                                (short) readUnaligned16 (source + 2 * stride),
+                                (short) readUnaligned16 (source + 3 * stride), 0, 0, 0, 0);
+
+        return bigEndian ? swapBytesInEachInt32 (_mm_unpacklo_epi16 (v, _mm_setzero_si128()))
+                         : _mm_unpacklo_epi16 (_mm_setzero_si128(), v);
+    }
+
+    inline void store (int32* dest, __m128i v) noexcept   { _mm_storeu_si128 (reinterpret_cast<__m128i*> (dest), v); }
+    inline void store (float* dest, __m128i v) noexcept   { _mm_storeu_ps (dest, _mm_mul_ps (_mm_cvtepi32_ps (v), _mm_set1_ps (int32ToFloatScale))); }
+
+    // Converts 4 floats to 32-bit ints in the same way as Float32::getAsInt32LE()
+    inline __m128i floatToInt32 (const float* source) noexcept
+    {
+        auto v = _mm_loadu_ps (source);
+        v = _mm_and_ps (v, _mm_cmpord_ps (v, v)); // (NaNs become zero, as they do in roundToInt)
+        v = _mm_min_ps (_mm_max_ps (v, _mm_set1_ps (-1.0f)), _mm_set1_ps (1.0f));
+
+        auto scale = _mm_set1_pd ((double) 0x7fffffff);
+        auto lo = _mm_cvtpd_epi32 (_mm_mul_pd (_mm_cvtps_pd (v), scale));
+        auto hi = _mm_cvtpd_epi32 (_mm_mul_pd (_mm_cvtps_pd (_mm_movehl_ps (v, v)), scale));
+
+        return _mm_unpacklo_epi64 (lo, hi);
+    }
+
+   #elif JUCE_USE_ARM_NEON
+    inline uint32x4_t swapBytesInEachInt32 (uint32x4_t v) noexcept
+    {
+        return vreinterpretq_u32_u8 (vrev32q_u8 (vreinterpretq_u8_u32 (v)));
+    }
+
+    inline uint32x4_t loadInt24x4 (const char* source, int stride, bool bigEndian) noexcept
+    {
+        const uint32 raw[] = { readUnaligned32 (source),
+                               readUnaligned32 (source + stride),
+                               readUnaligned32 (source + 2 * stride),
+                               readUnaligned32 (source + 3 * stride) };
+
+        auto v = vld1q_u32 (raw);
+
+        return bigEndian ? vandq_u32 (swapBytesInEachInt32 (v), vdupq_n_u32 (0xffffff00))
+                         : vshlq_n_u32 (v, 8);
+    }
+
+    inline uint32x4_t loadInt16x4 (const char* source, int stride, bool bigEndian) noexcept
+    {
+        const uint32 raw[] = { readUnaligned16 (source),
+                               readUnaligned16 (source + stride),
+                               readUnaligned16 (source + 2 * stride),
+                               readUnaligned16 (source + 3 * stride) };
+
+        auto v = vld1q_u32 (raw);
+
+        return bigEndian ? swapBytesInEachInt32 (v)
+                         : vshlq_n_u32 (v, 16);
+    }
+
+    inline void store (int32* dest, uint32x4_t v) noexcept   { vst1q_s32 (dest, vreinterpretq_s32_u32 (v)); }
+    inline void store (float* dest, uint32x4_t v) noexcept   { vst1q_f32 (dest, vmulq_n_f32 (vcvtq_f32_s32 (vreinterpretq_s32_u32 (v)), int32ToFloatScale)); }
+   #endif
+
+    // Reads a block of packed 16 or 24-bit ints into an array of native 32-bit ints or floats.
+    template <class SourceFormat, typename DestType>
+    void readPackedInts (DestType* dest, const char* source, int stride, bool bigEndian, int numSamples) noexcept
+    {
+        int i = 0;
+
+       #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+        // The 24-bit loads read past the end of the last sample, so leave the last couple to the scalar loop
+        auto numToVectorise = numSamples - (SourceFormat::bytesPerSample == 3 ? (stride == 3 ? 2 : 1) : 0);
+
+        for (; i + 4 <= numToVectorise; i += 4)
+            store (dest + i, SourceFormat::bytesPerSample == 3 ? loadInt24x4 (source + i * stride, stride, bigEndian)
+                                                               : loadInt16x4 (source + i * stride, stride, bigEndian));
+       #endif
+
+        for (; i < numSamples; ++i)
+        {
+            SourceFormat s (const_cast<char*> (source + i * stride));
+
+            if (std::is_same<DestType, float>::value)
+                dest[i] = (DestType) (bigEndian ? s.getAsFloatBE() : s.getAsFloatLE());
+            else
+                dest[i] = (DestType) (bigEndian ? s.getAsInt32BE() : s.getAsInt32LE());
+        }
+    }
+
+    // Writes a block of ints to a packed 16 or 24-bit format. The ints are shifted down by
+    // the given number of bits first.
+    template <class DestFormat>
+    void writePackedInts (char* dest, int stride, bool bigEndian, const int32* source, int shift, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto v = source[i] >> shift;
+            auto* d = dest + i * stride;
+
+            if (DestFormat::bytesPerSample == 3)
+            {
+                if (bigEndian)  ByteOrder::bigEndian24BitToChars (v, d);
+                else            ByteOrder::littleEndian24BitToChars (v, d);
+            }
+            else
+            {
+                auto u = bigEndian ? ByteOrder::swapIfLittleEndian ((uint16) v)
+                                   : ByteOrder::swapIfBigEndian ((uint16) v);
+                memcpy (d, &u, sizeof (u));
+            }
+        }
+    }
+
+    // Writes a block of native 32-bit ints or floats to a packed 16 or 24-bit format, in
+    // the same way that the formats' copyFrom() methods would.
+    template <class DestFormat, typename SourceType>
+    bool writeBlock (char* dest, int stride, bool bigEndian, const SourceType* source, int numSamples) noexcept
+    {
+       #if JUCE_USE_SSE_INTRINSICS
+        const int shift = 32 - 8 * DestFormat::bytesPerSample;
+        int32 block[64];
+
+        while (numSamples > 0)
+        {
+            auto numThisTime = jmin (numSamples, numElementsInArray (block));
+            auto ints = reinterpret_cast<const int32*> (source);
+            int i = 0;
+
+            if (std::is_same<SourceType, float>::value)
+            {
+                auto floats = reinterpret_cast<const float*> (source);
+
+                for (; i + 4 <= numThisTime; i += 4)
+                    store (block + i, floatToInt32 (floats + i));
+
+                for (; i < numThisTime; ++i)
+                    block[i] = AudioData::Float32 (const_cast<float*> (floats + i)).getAsInt32LE();
+
+                ints = block;
+            }
+
+            if (DestFormat::bytesPerSample == 2 && stride == 2)
+            {
+                // pack and store 8 at a time..
+                for (i = 0; i + 8 <= numThisTime; i += 8)
+                {
+                    auto v1 = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (ints + i));
+                    auto v2 = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (ints + i + 4));
+
+                    auto packed = _mm_packs_epi32 (_mm_srai_epi32 (v1, shift), _mm_srai_epi32 (v2, shift));
+
+                    if (bigEndian)
+                        packed = swapBytesInEachInt16 (packed);
+
+                    _mm_storeu_si128 (reinterpret_cast<__m128i*> (dest + 2 * i), packed);
+                }
+
+                writePackedInts<DestFormat> (dest + 2 * i, stride, bigEndian, ints + i, shift, numThisTime - i);
+            }
+            else
+            {
+                writePackedInts<DestFormat> (dest, stride, bigEndian, ints, shift, numThisTime);
+            }
+
+            source += numThisTime;
+            dest += numThisTime * stride;
+            numSamples -= numThisTime;
+        }
+
+        return true;
+       #else
+        ignoreUnused (dest, stride, bigEndian, source, numSamples);
+        return false;
+       #endif
+    }
+}
+
+bool AudioData::convertBlock (Int32 d, int destStride, bool destIsBigEndian, Int16 s, int sourceStride, bool sourceIsBigEndian, int numSamples) noexcept
+{
+    if (! BlockConversionHelpers::isNativeArray (destStride, destIsBigEndian))
+        return false;
+
+    BlockConversionHelpers::readPackedInts<Int16> (reinterpret_cast<int32*> (d.data), reinterpret_cast<const char*> (s.data), sourceStride, sourceIsBigEndian, numSamples);
+    return true;
+}
+
+bool AudioData::convertBlock (Int32 d, int destStride, bool destIsBigEndian, Int24 s, int sourceStride, bool sourceIsBigEndian, int numSamples) noexcept
+{
+    if (! BlockConversionHelpers::isNativeArray (destStride, destIsBigEndian))
+        return false;
+
+    BlockConversionHelpers::readPackedInts<Int24> (reinterpret_cast<int32*> (d.data), s.data, sourceStride, sourceIsBigEndian, numSamples);
+    return true;
+}
+
+bool AudioData::convertBlock (Float32 d, int destStride, bool destIsBigEndian, Int16 s, int sourceStride, bool sourceIsBigEndian, int numSamples) noexcept
+{
+    if (! BlockConversionHelpers::isNativeArray (destStride, destIsBigEndian))
+        return false;
+
+    BlockConversionHelpers::readPackedInts<Int16> (d.data, reinterpret_cast<const char*> (s.data), sourceStride, sourceIsBigEndian, numSamples);
+    return true;
+}
+
+bool AudioData::convertBlock (Float32 d, int destStride, bool destIsBigEndian, Int24 s, int sourceStride, bool sourceIsBigEndian, int numSamples) noexcept
+{
+    if (! BlockConversionHelpers::isNativeArray (destStride, destIsBigEndian))
+        return false;
+
+    BlockConversionHelpers::readPackedInts<Int24> (d.data, s.data, sourceStride, sourceIsBigEndian, numSamples);
+    return true;
+}
+
+bool AudioData::convertBlock (Float32 d, int destStride, bool destIsBigEndian, Float32 s, int sourceStride, bool sourceIsBigEndian, int numSamples) noexcept
+{
+    // This is just a gather or scatter, with the bytes swapped if the endianness is different
+    const bool swap = (destIsBigEndian != sourceIsBigEndian);
+    auto dest = reinterpret_cast<char*> (d.data);
+    auto source = reinterpret_cast<const char*> (s.data);
+
+    if (! (BlockConversionHelpers::isNativeArray (destStride, destIsBigEndian) || BlockConversionHelpers::isNativeArray (sourceStride, sourceIsBigEndian)))
+        return false;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto v = BlockConversionHelpers::readUnaligned32 (source + i * sourceStride);
+
+        if (swap)
+            v = ByteOrder::swap (v);
+
+        memcpy (dest + i * destStride, &v, sizeof (v));
+    }
+
+    return true;
+}
+
+bool AudioData::convertBlock (Int16 d, int destStride, bool destIsBigEndian, Int32 s, int sourceStride, bool sourceIsBigEndian, int numSamples) noexcept
+{
+    return BlockConversionHelpers::isNativeArray (sourceStride, sourceIsBigEndian)
+            && BlockConversionHelpers::writeBlock<Int16> (reinterpret_cast<char*> (d.data), destStride, destIsBigEndian, reinterpret_cast<const int32*> (s.data), numSamples);
+}
+
+bool AudioData::convertBlock (Int24 d, int destStride, bool destIsBigEndian, Int32 s, int sourceStride, bool sourceIsBigEndian, int numSamples) noexcept
+{
+    return BlockConversionHelpers::isNativeArray (sourceStride, sourceIsBigEndian)
+            && BlockConversionHelpers::writeBlock<Int24> (d.data, destStride, destIsBigEndian, reinterpret_cast<const int32*> (s.data), numSamples);
+}
+
+bool AudioData::convertBlock (Int16 d, int destStride, bool destIsBigEndian, Float32 s, int sourceStride, bool sourceIsBigEndian, int numSamples) noexcept
+{
+    return BlockConversionHelpers::isNativeArray (sourceStride, sourceIsBigEndian)
+            && BlockConversionHelpers::writeBlock<Int16> (reinterpret_cast<char*> (d.data), destStride, destIsBigEndian, s.data, numSamples);
+}
+
+bool AudioData::convertBlock (Int24 d, int destStride, bool destIsBigEndian, Float32 s, int sourceStride, bool sourceIsBigEndian, int numSamples) noexcept
+{
+    return BlockConversionHelpers::isNativeArray (sourceStride, sourceIsBigEndian)
+            && BlockConversionHelpers::writeBlock<Int24> (d.data, destStride, destIsBigEndian, s.data, numSamples);
+}
+
 //==============================================================================
 #if JUCE_UNIT_TESTS
 
@@ -568,9 +893,94 @@ public:
         }
     };
 
+    template <class DestFormat, class DestEndianness, class SourceFormat, class SourceEndianness>
+    struct BlockTest
+    {
+        using SourceType = AudioData::Pointer<SourceFormat, SourceEndianness, AudioData::Interleaved, AudioData::Const>;
+        using DestType   = AudioData::Pointer<DestFormat, DestEndianness, AudioData::Interleaved, AudioData::NonConst>;
+
+        static void test (UnitTest& unitTest, Random& r)
+        {
+            for (int numSourceChannels = 1; numSourceChannels <= 3; ++numSourceChannels)
+                for (int numDestChannels = 1; numDestChannels <= 3; ++numDestChannels)
+                    for (auto numSamples : { 0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 64, 100, 257 })
+                        test (unitTest, r, numSourceChannels, numDestChannels, numSamples);
+        }
+
+        static void test (UnitTest& unitTest, Random& r, int numSourceChannels, int numDestChannels, int numSamples)
+        {
+            HeapBlock<char> source ((size_t) (numSamples * numSourceChannels * SourceType::getBytesPerSample()) + 1);
+            HeapBlock<char> expected ((size_t) (numSamples * numDestChannels * DestType::getBytesPerSample()) + 1);
+            HeapBlock<char> actual ((size_t) (numSamples * numDestChannels * DestType::getBytesPerSample()) + 1);
+            const auto destSize = (size_t) (numSamples * numDestChannels * DestType::getBytesPerSample());
+
+            {
+                AudioData::Pointer<SourceFormat, SourceEndianness, AudioData::NonInterleaved, AudioData::NonConst> s (source.getData());
+
+                for (int i = 0; i < numSamples * numSourceChannels; ++i, ++s)
+                {
+                    if (s.isFloatingPoint())
+                        s.setAsFloat (r.nextFloat() * 2.4f - 1.2f);
+                    else
+                        s.setAsInt32 (r.nextInt());
+                }
+            }
+
+            for (size_t i = 0; i < destSize; ++i)
+                expected[i] = actual[i] = (char) r.nextInt (256);
+
+            auto sourceChannel = r.nextInt (numSourceChannels);
+            auto destChannel = r.nextInt (numDestChannels);
+
+            // convert one sample at a time for the expected result..
+            {
+                SourceType s (addBytesToPointer (source.getData(), sourceChannel * SourceType::getBytesPerSample()), numSourceChannels);
+                DestType d (addBytesToPointer (expected.getData(), destChannel * DestType::getBytesPerSample()), numDestChannels);
+
+                for (int i = 0; i < numSamples; ++i, ++s, ++d)
+                {
+                    if (d.isFloatingPoint())
+                        d.setAsFloat (s.getAsFloat());
+                    else
+                        d.setAsInt32 (s.getAsInt32());
+                }
+            }
+
+            AudioData::ConverterInstance<SourceType, DestType> converter (numSourceChannels, numDestChannels);
+            converter.convertSamples (actual, destChannel, source, sourceChannel, numSamples);
+
+            unitTest.expect (memcmp (expected, actual, destSize) == 0);
+        }
+    };
+
     void runTest() override
     {
         auto r = getRandom();
+
+        beginTest ("Block conversions");
+        {
+            BlockTest<AudioData::Int32, AudioData::NativeEndian, AudioData::Int16, AudioData::LittleEndian>::test (*this, r);
+            BlockTest<AudioData::Int32, AudioData::NativeEndian, AudioData::Int16, AudioData::BigEndian>::test (*this, r);
+            BlockTest<AudioData::Int32, AudioData::NativeEndian, AudioData::Int24, AudioData::LittleEndian>::test (*this, r);
+            BlockTest<AudioData::Int32, AudioData::NativeEndian, AudioData::Int24, AudioData::BigEndian>::test (*this, r);
+            BlockTest<AudioData::Float32, AudioData::NativeEndian, AudioData::Int16, AudioData::LittleEndian>::test (*this, r);
+            BlockTest<AudioData::Float32, AudioData::NativeEndian, AudioData::Int16, AudioData::BigEndian>::test (*this, r);
+            BlockTest<AudioData::Float32, AudioData::NativeEndian, AudioData::Int24, AudioData::LittleEndian>::test (*this, r);
+            BlockTest<AudioData::Float32, AudioData::NativeEndian, AudioData::Int24, AudioData::BigEndian>::test (*this, r);
+            BlockTest<AudioData::Float32, AudioData::NativeEndian, AudioData::Float32, AudioData::LittleEndian>::test (*this, r);
+            BlockTest<AudioData::Float32, AudioData::NativeEndian, AudioData::Float32, AudioData::BigEndian>::test (*this, r);
+
+            BlockTest<AudioData::Int16, AudioData::LittleEndian, AudioData::Int32, AudioData::NativeEndian>::test (*this, r);
+            BlockTest<AudioData::Int16, AudioData::BigEndian, AudioData::Int32, AudioData::NativeEndian>::test (*this, r);
+            BlockTest<AudioData::Int24, AudioData::LittleEndian, AudioData::Int32, AudioData::NativeEndian>::test (*this, r);
+            BlockTest<AudioData::Int24, AudioData::BigEndian, AudioData::Int32, AudioData::NativeEndian>::test (*this, r);
+            BlockTest<AudioData::Int16, AudioData::LittleEndian, AudioData::Float32, AudioData::NativeEndian>::test (*this, r);
+            BlockTest<AudioData::Int16, AudioData::BigEndian, AudioData::Float32, AudioData::NativeEndian>::test (*this, r);
+            BlockTest<AudioData::Int24, AudioData::LittleEndian, AudioData::Float32, AudioData::NativeEndian>::test (*this, r);
+            BlockTest<AudioData::Int24, AudioData::BigEndian, AudioData::Float32, AudioData::NativeEndian>::test (*this, r);
+            BlockTest<AudioData::Float32, AudioData::BigEndian, AudioData::Float32, AudioData::NativeEndian>::test (*this, r);
+        }
+
         beginTest ("Round-trip conversion: Int8");
         Test1 <AudioData::Int8>::test (*this, r);
         beginTest ("Round-trip conversion: Int16");
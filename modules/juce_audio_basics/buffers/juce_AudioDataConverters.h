@@ -273,6 +273,27 @@ public:
         enum { bytesPerSample = 4, maxValue = 0x7fffffff, resolution = (1 << 8), isFloat = 1 };
     };
 
+    //==============================================================================
+   #ifndef DOXYGEN
+    /*  Optimised routines for the most commonly-used pairs of formats, which Pointer::convertSamples()
+        will use automatically when they're available. The strides are the number of bytes between
+        samples. These return false if they can't handle the layout of the data they're given, in
+        which case the caller converts the samples one at a time instead.
+    */
+    template <class DestFormat, class SourceFormat>
+    static bool convertBlock (DestFormat, int, bool, SourceFormat, int, bool, int) noexcept     { return false; }
+
+    static bool convertBlock (Int32,   int destStride, bool destIsBigEndian, Int16,   int sourceStride, bool sourceIsBigEndian, int numSamples) noexcept;
+    static bool convertBlock (Int32,   int destStride, bool destIsBigEndian, Int24,   int sourceStride, bool sourceIsBigEndian, int numSamples) noexcept;
+    static bool convertBlock (Float32, int destStride, bool destIsBigEndian, Int16,   int sourceStride, bool sourceIsBigEndian, int numSamples) noexcept;
+    static bool convertBlock (Float32, int destStride, bool destIsBigEndian, Int24,   int sourceStride, bool sourceIsBigEndian, int numSamples) noexcept;
+    static bool convertBlock (Float32, int destStride, bool destIsBigEndian, Float32, int sourceStride, bool sourceIsBigEndian, int numSamples) noexcept;
+    static bool convertBlock (Int16,   int destStride, bool destIsBigEndian, Int32,   int sourceStride, bool sourceIsBigEndian, int numSamples) noexcept;
+    static bool convertBlock (Int24,   int destStride, bool destIsBigEndian, Int32,   int sourceStride, bool sourceIsBigEndian, int numSamples) noexcept;
+    static bool convertBlock (Int16,   int destStride, bool destIsBigEndian, Float32, int sourceStride, bool sourceIsBigEndian, int numSamples) noexcept;
+    static bool convertBlock (Int24,   int destStride, bool destIsBigEndian, Float32, int sourceStride, bool sourceIsBigEndian, int numSamples) noexcept;
+   #endif
+
     //==============================================================================
     class NonInterleaved
     {
@@ -343,7 +364,8 @@ public:
         @endcode
 
         The convertSamples() method lets you copy a range of samples from one format to another, automatically
-        converting its format.
+        converting its format. Conversions between the native-endian Float32 or Int32 formats and the Int16, Int24
+        and Float32 formats (in either endianness, interleaved or not) use vectorised code where possible.
 
         @see AudioData::Converter
     */
@@ -465,6 +487,11 @@ public:
 
             if (source.getRawData() != getRawData() || source.getNumBytesBetweenSamples() >= getNumBytesBetweenSamples())
             {
+                if (convertBlock (dest.data, getNumBytesBetweenSamples(), isBigEndian(),
+                                  source.data, source.getNumBytesBetweenSamples(), OtherPointerType::isBigEndian(),
+                                  numSamples))
+                    return;
+
                 while (--numSamples >= 0)
                 {
                     Endianness::copyFrom (dest.data, source);
@@ -571,6 +598,9 @@ public:
 
         inline void advance() noexcept                          { this->advanceData (data); }
 
+        template <typename, typename, typename, typename>
+        friend class Pointer;
+
         Pointer operator++ (int); // private to force you to use the more efficient pre-increment!
         Pointer operator-- (int);
     };
@@ -27,7 +27,12 @@
 namespace juce
 {
 
-AudioProcessLoadMeasurer::AudioProcessLoadMeasurer() {}
+AudioProcessLoadMeasurer::AudioProcessLoadMeasurer()
+{
+    for (auto& bucket : histogram)
+        bucket = 0;
+}
+
 AudioProcessLoadMeasurer::~AudioProcessLoadMeasurer() {}
 
 void AudioProcessLoadMeasurer::reset()
@@ -40,6 +45,14 @@ void AudioProcessLoadMeasurer::reset (double sampleRate, int blockSize)
     cpuUsageMs = 0;
     xruns = 0;
 
+    for (auto& bucket : histogram)
+        bucket = 0;
+
+    ++worstBlockVersion;
+    worstBlockMs = 0;
+    worstBlockTime = 0;
+    ++worstBlockVersion;
+
     if (sampleRate > 0.0 && blockSize > 0)
     {
         msPerBlock = 1000.0 * blockSize / sampleRate;
@@ -55,10 +68,23 @@ void AudioProcessLoadMeasurer::reset (double sampleRate, int blockSize)
 void AudioProcessLoadMeasurer::registerBlockRenderTime (double milliseconds)
 {
     const double filterAmount = 0.2;
-    cpuUsageMs += filterAmount * (milliseconds - cpuUsageMs);
+    auto usage = cpuUsageMs.load();
+    cpuUsageMs = usage + filterAmount * (milliseconds - usage);
 
     if (milliseconds > msPerBlock)
         ++xruns;
+
+    histogram[getHistogramBucket (milliseconds)].fetch_add (1, std::memory_order_relaxed);
+
+    if (milliseconds > worstBlockMs.load (std::memory_order_relaxed))
+    {
+        // the version is odd while the pair is being written, so readers can tell
+        // when they've seen a half-updated value
+        ++worstBlockVersion;
+        worstBlockMs = milliseconds;
+        worstBlockTime = Time::currentTimeMillis();
+        ++worstBlockVersion;
+    }
 }
 
 double AudioProcessLoadMeasurer::getLoadAsProportion() const   { return jlimit (0.0, 1.0, timeToCpuScale * cpuUsageMs); }
@@ -66,6 +92,84 @@ double AudioProcessLoadMeasurer::getLoadAsPercentage() const   { return 100.0 *
 
 int AudioProcessLoadMeasurer::getXRunCount() const             { return xruns; }
 
+//==============================================================================
+int AudioProcessLoadMeasurer::getHistogramBucket (double milliseconds) noexcept
+{
+    auto microseconds = milliseconds * 1000.0;
+
+    if (! (microseconds >= 1.0))
+        return 0;
+
+    return jmin (numHistogramBuckets - 1, 1 + (int) (8.0 * std::log2 (microseconds)));
+}
+
+double AudioProcessLoadMeasurer::getHistogramBucketStartMs (int bucketIndex) noexcept
+{
+    jassert (isPositiveAndBelow (bucketIndex, numHistogramBuckets));
+    return bucketIndex <= 0 ? 0.0 : 0.001 * std::exp2 ((bucketIndex - 1) / 8.0);
+}
+
+double AudioProcessLoadMeasurer::getHistogramBucketEndMs (int bucketIndex) noexcept
+{
+    jassert (isPositiveAndBelow (bucketIndex, numHistogramBuckets));
+    return 0.001 * std::exp2 (bucketIndex / 8.0);
+}
+
+AudioProcessLoadMeasurer::Statistics AudioProcessLoadMeasurer::getStatistics() const
+{
+    Statistics stats;
+    stats.numXRuns = xruns;
+    stats.millisecondsPerBlock = msPerBlock;
+
+    for (int i = 0; i < numHistogramBuckets; ++i)
+    {
+        stats.histogram[i] = histogram[i].load (std::memory_order_relaxed);
+        stats.numBlocks += stats.histogram[i];
+    }
+
+    for (int attempts = 0; attempts < 8; ++attempts)
+    {
+        auto version = worstBlockVersion.load();
+
+        if ((version & 1) == 0)
+        {
+            auto worstMs = worstBlockMs.load();
+            auto worstTime = worstBlockTime.load();
+
+            if (worstBlockVersion.load() == version)
+            {
+                stats.worstBlockMs = worstMs;
+                stats.worstBlockTime = Time (worstTime);
+                break;
+            }
+        }
+
+        Thread::yield();
+    }
+
+    return stats;
+}
+
+double AudioProcessLoadMeasurer::Statistics::getPercentileMs (double percentile) const noexcept
+{
+    if (numBlocks <= 0)
+        return 0;
+
+    auto target = jlimit ((int64) 1, numBlocks, (int64) std::ceil (jlimit (0.0, 100.0, percentile) * 0.01 * (double) numBlocks));
+    int64 total = 0;
+
+    for (int i = 0; i < numHistogramBuckets; ++i)
+    {
+        total += histogram[i];
+
+        if (total >= target)
+            return jmin (getHistogramBucketEndMs (i), worstBlockMs);
+    }
+
+    return worstBlockMs;
+}
+
+//==============================================================================
 AudioProcessLoadMeasurer::ScopedTimer::ScopedTimer (AudioProcessLoadMeasurer& p)
    : owner (p), startTime (Time::getMillisecondCounterHiRes())
 {
@@ -76,4 +180,87 @@ AudioProcessLoadMeasurer::ScopedTimer::~ScopedTimer()
     owner.registerBlockRenderTime (Time::getMillisecondCounterHiRes() - startTime);
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class AudioProcessLoadMeasurerTests  : public UnitTest
+{
+public:
+    AudioProcessLoadMeasurerTests() : UnitTest ("AudioProcessLoadMeasurer", "Audio") {}
+
+    void runTest() override
+    {
+        beginTest ("Histogram buckets");
+        {
+            expectEquals (AudioProcessLoadMeasurer::getHistogramBucketStartMs (0), 0.0);
+
+            for (int i = 0; i < AudioProcessLoadMeasurer::numHistogramBuckets - 1; ++i)
+            {
+                expectEquals (AudioProcessLoadMeasurer::getHistogramBucketEndMs (i),
+                              AudioProcessLoadMeasurer::getHistogramBucketStartMs (i + 1));
+
+                AudioProcessLoadMeasurer measurer;
+                auto middle = 0.5 * (AudioProcessLoadMeasurer::getHistogramBucketStartMs (i)
+                                      + AudioProcessLoadMeasurer::getHistogramBucketEndMs (i));
+                measurer.registerBlockRenderTime (middle);
+                expectEquals ((int) measurer.getStatistics().histogram[i], 1);
+            }
+        }
+
+        beginTest ("Percentiles");
+        {
+            AudioProcessLoadMeasurer measurer;
+            measurer.reset (44100.0, 441);
+
+            for (int i = 1; i <= 1000; ++i)
+                measurer.registerBlockRenderTime (i * 0.001);
+
+            auto stats = measurer.getStatistics();
+            expectEquals (stats.numBlocks, (int64) 1000);
+            expectEquals (stats.numXRuns, 0);
+            expectWithinAbsoluteError (stats.millisecondsPerBlock, 10.0, 1.0e-9);
+            expectEquals (stats.worstBlockMs, 1.0);
+
+            for (auto percentile : { 10.0, 50.0, 90.0, 99.0 })
+            {
+                auto expected = percentile * 0.01;
+                auto result = stats.getPercentileMs (percentile);
+                expect (result >= expected && result <= expected * 1.1);
+            }
+
+            expectEquals (stats.getPercentileMs (99.9), 1.0);
+            expectEquals (stats.getPercentileMs (100.0), 1.0);
+        }
+
+        beginTest ("Worst block and xruns");
+        {
+            AudioProcessLoadMeasurer measurer;
+            measurer.reset (1000.0, 10);
+
+            auto startTime = Time::getCurrentTime();
+            measurer.registerBlockRenderTime (2.0);
+            measurer.registerBlockRenderTime (25.0);
+            measurer.registerBlockRenderTime (12.0);
+
+            auto stats = measurer.getStatistics();
+            expectEquals (stats.numXRuns, 2);
+            expectEquals (stats.worstBlockMs, 25.0);
+            expect (stats.worstBlockTime >= startTime - RelativeTime::seconds (1.0));
+            expect (stats.worstBlockTime <= Time::getCurrentTime() + RelativeTime::seconds (1.0));
+            expectEquals (measurer.getXRunCount(), 2);
+
+            measurer.reset();
+            stats = measurer.getStatistics();
+            expectEquals (stats.numBlocks, (int64) 0);
+            expectEquals (stats.worstBlockMs, 0.0);
+            expectEquals (stats.getPercentileMs (50.0), 0.0);
+        }
+    }
+};
+
+static AudioProcessLoadMeasurerTests audioProcessLoadMeasurerTests;
+
+#endif
+
 } // namespace juce
@@ -31,6 +31,11 @@ namespace juce
 /**
     Maintains an ongoing measurement of the proportion of time which is being
     spent inside an audio callback.
+
+    As well as a smoothed average load, it keeps a histogram of the callback
+    durations so that you can keep an eye on the slowest callbacks. The
+    measurements are recorded without locking or allocating, and can be read
+    from any thread.
 */
 class JUCE_API  AudioProcessLoadMeasurer
 {
@@ -57,6 +62,59 @@ public:
     /** Returns the number of over- (or under-) runs recorded since the state was reset. */
     int getXRunCount() const;
 
+    //==============================================================================
+    /** The number of buckets in the histogram of callback durations.
+
+        Bucket 0 counts callbacks that took less than a microsecond, and each bucket
+        after that covers an eighth of an octave, so bucket i holds the callbacks that
+        took between 2^((i - 1) / 8) and 2^(i / 8) microseconds. The last bucket also
+        collects anything longer than that.
+    */
+    static constexpr int numHistogramBuckets = 160;
+
+    /** Returns the shortest duration in milliseconds that's counted in a histogram bucket. */
+    static double getHistogramBucketStartMs (int bucketIndex) noexcept;
+
+    /** Returns the duration in milliseconds at which a histogram bucket ends. */
+    static double getHistogramBucketEndMs (int bucketIndex) noexcept;
+
+    /** A snapshot of the distribution of callback durations, as returned by
+        getStatistics().
+    */
+    struct JUCE_API  Statistics
+    {
+        /** The number of callbacks that have been measured. */
+        int64 numBlocks = 0;
+
+        /** The number of callbacks that took longer than the time available. */
+        int numXRuns = 0;
+
+        /** The time available for each callback, or 0 if it's not known. */
+        double millisecondsPerBlock = 0;
+
+        /** The duration of the slowest callback. */
+        double worstBlockMs = 0;
+
+        /** When the slowest callback happened. */
+        Time worstBlockTime;
+
+        /** The number of callbacks whose durations fell into each bucket.
+            @see getHistogramBucketStartMs, getHistogramBucketEndMs
+        */
+        uint32 histogram[numHistogramBuckets] = {};
+
+        /** Returns an upper bound for the given percentile of the callback durations, in
+            milliseconds, e.g. getPercentileMs (99.9) for the p99.9 duration.
+            The resolution is that of the histogram, so this is accurate to about 9%.
+        */
+        double getPercentileMs (double percentile) const noexcept;
+    };
+
+    /** Returns a snapshot of the measurements that have been made since the state was
+        reset. This can be called from any thread.
+    */
+    Statistics getStatistics() const;
+
     //==============================================================================
     /** This class measures the time between its construction and destruction and
         adds it to an AudioProcessLoadMeasurer.
@@ -88,8 +146,17 @@ public:
     void registerBlockRenderTime (double millisecondsTaken);
 
 private:
-    double cpuUsageMs = 0, timeToCpuScale = 0, msPerBlock = 0;
-    int xruns = 0;
+    std::atomic<double> cpuUsageMs { 0 }, timeToCpuScale { 0 }, msPerBlock { 0 };
+    std::atomic<int> xruns { 0 };
+
+    std::atomic<uint32> histogram[numHistogramBuckets];
+    std::atomic<int64> worstBlockTime { 0 };
+    std::atomic<double> worstBlockMs { 0 };
+    std::atomic<uint32> worstBlockVersion { 0 };
+
+    static int getHistogramBucket (double milliseconds) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE (AudioProcessLoadMeasurer)
 };
 
 
@@ -655,14 +655,8 @@ public:
                 jassert (isPositiveAndBelow (channel, numChannels));
                 jassert (startSample >= 0 && numSamples >= 0 && startSample + numSamples <= size);
 
-                const auto increment = (endGain - startGain) / (float) numSamples;
                 auto* d = channels[channel] + startSample;
-
-                while (--numSamples >= 0)
-                {
-                    *d++ *= startGain;
-                    startGain += increment;
-                }
+                FloatVectorOperations::copyWithRamp (d, d, startGain, endGain, numSamples);
             }
         }
     }
@@ -810,14 +804,8 @@ public:
             if (numSamples > 0)
             {
                 isClear = false;
-                const auto increment = (endGain - startGain) / numSamples;
-                auto* d = channels[destChannel] + destStartSample;
-
-                while (--numSamples >= 0)
-                {
-                    *d++ += startGain * *source++;
-                    startGain += increment;
-                }
+                FloatVectorOperations::addWithRamp (channels[destChannel] + destStartSample, source,
+                                                    startGain, endGain, numSamples);
             }
         }
     }
@@ -966,14 +954,8 @@ public:
             if (numSamples > 0)
             {
                 isClear = false;
-                const auto increment = (endGain - startGain) / numSamples;
-                auto* d = channels[destChannel] + destStartSample;
-
-                while (--numSamples >= 0)
-                {
-                    *d++ = startGain * *source++;
-                    startGain += increment;
-                }
+                FloatVectorOperations::copyWithRamp (channels[destChannel] + destStartSample, source,
+                                                     startGain, endGain, numSamples);
             }
         }
     }
@@ -1030,16 +1012,34 @@ public:
         if (numSamples <= 0 || channel < 0 || channel >= numChannels || isClear)
             return Type (0);
 
-        auto* data = channels[channel] + startSample;
-        double sum = 0.0;
+        return FloatVectorOperations::findRMS (channels[channel] + startSample, numSamples);
+    }
+
+    /** Finds the peak absolute sample value and the root mean squared level of every
+        channel in a region, reading each channel only once.
 
-        for (int i = 0; i < numSamples; ++i)
+        @param startSample  the start sample within each channel
+        @param numSamples   the number of samples to measure
+        @param peakLevels   an array of getNumChannels() values to write the peak levels into
+        @param rmsLevels    an array of getNumChannels() values to write the RMS levels into
+    */
+    void getPeakAndRMSLevels (int startSample, int numSamples, Type* peakLevels, Type* rmsLevels) const noexcept
+    {
+        jassert (startSample >= 0 && numSamples >= 0 && startSample + numSamples <= size);
+        jassert (peakLevels != nullptr && rmsLevels != nullptr);
+
+        for (int i = 0; i < numChannels; ++i)
         {
-            auto sample = data[i];
-            sum += sample * sample;
+            if (isClear || numSamples <= 0)
+            {
+                peakLevels[i] = Type (0);
+                rmsLevels[i] = Type (0);
+            }
+            else
+            {
+                FloatVectorOperations::findPeakAndRMS (channels[i] + startSample, numSamples, peakLevels[i], rmsLevels[i]);
+            }
         }
-
-        return static_cast<Type> (std::sqrt (sum / numSamples));
     }
 
     /** Reverses a part of a channel. */
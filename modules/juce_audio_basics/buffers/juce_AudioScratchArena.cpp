@@ -0,0 +1,278 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+struct AudioScratchArena::Block
+{
+    void* allocation;
+    Block* nextFree;
+    Block* nextAllocated;
+    int sizeClass;
+    bool inUse;
+};
+
+static constexpr size_t scratchBlockHeaderSize = 64;
+
+//==============================================================================
+AudioScratchArena::AudioScratchArena() noexcept {}
+
+AudioScratchArena::~AudioScratchArena()
+{
+    // All the buffers must have been returned before the arena is deleted!
+    jassert (numBuffersInUse == 0);
+
+    for (auto* b = allocatedBlocks; b != nullptr;)
+    {
+        auto* next = b->nextAllocated;
+        std::free (b->allocation);
+        b = next;
+    }
+}
+
+int AudioScratchArena::getSizeClass (size_t numBytes) noexcept
+{
+    int sizeClass = 0;
+
+    while (((size_t) 1 << (sizeClass + minSizeClassBits)) < numBytes)
+        ++sizeClass;
+
+    jassert (sizeClass < numSizeClasses);
+    return sizeClass;
+}
+
+AudioScratchArena::Block* AudioScratchArena::allocateBlock (int sizeClass)
+{
+    static_assert (sizeof (Block) <= scratchBlockHeaderSize, "The block header must fit in a cache line");
+
+    auto numBytes = scratchBlockHeaderSize + ((size_t) 1 << (sizeClass + minSizeClassBits)) + (alignment - 1);
+    auto* allocation = std::malloc (numBytes);
+
+    if (allocation == nullptr)
+        throw std::bad_alloc();
+
+    auto* block = snapPointerToAlignment (static_cast<Block*> (allocation), (int) alignment);
+    block->allocation = allocation;
+    block->nextFree = nullptr;
+    block->nextAllocated = allocatedBlocks;
+    block->sizeClass = sizeClass;
+    block->inUse = false;
+
+    allocatedBlocks = block;
+    ++numSystemAllocations;
+    return block;
+}
+
+void AudioScratchArena::reserve (size_t numBytes, int numBuffers)
+{
+    auto sizeClass = getSizeClass (numBytes);
+    int numFree = 0;
+
+    for (auto* b = freeLists[sizeClass]; b != nullptr; b = b->nextFree)
+        ++numFree;
+
+    for (; numFree < numBuffers; ++numFree)
+    {
+        auto* block = allocateBlock (sizeClass);
+        block->nextFree = freeLists[sizeClass];
+        freeLists[sizeClass] = block;
+    }
+}
+
+void AudioScratchArena::releaseUnusedMemory()
+{
+    Block* blocksToKeep = nullptr;
+
+    for (auto* b = allocatedBlocks; b != nullptr;)
+    {
+        auto* next = b->nextAllocated;
+
+        if (b->inUse)
+        {
+            b->nextAllocated = blocksToKeep;
+            blocksToKeep = b;
+        }
+        else
+        {
+            std::free (b->allocation);
+        }
+
+        b = next;
+    }
+
+    allocatedBlocks = blocksToKeep;
+
+    for (auto& list : freeLists)
+        list = nullptr;
+}
+
+void* AudioScratchArena::borrow (size_t numBytes)
+{
+    auto sizeClass = getSizeClass (numBytes);
+    Block* block = nullptr;
+
+    // if there's nothing free in this size class, a bigger block will do
+    for (int i = sizeClass; i < numSizeClasses && block == nullptr; ++i)
+    {
+        block = freeLists[i];
+
+        if (block != nullptr)
+            freeLists[i] = block->nextFree;
+    }
+
+    if (block == nullptr)
+        block = allocateBlock (sizeClass); // (the arena wasn't prepared for a buffer this big)
+
+    block->inUse = true;
+    ++numBuffersInUse;
+    return addBytesToPointer (block, scratchBlockHeaderSize);
+}
+
+void AudioScratchArena::giveBack (void* data) noexcept
+{
+    auto* block = reinterpret_cast<Block*> (static_cast<char*> (data) - scratchBlockHeaderSize);
+    jassert (block->inUse);
+
+    block->inUse = false;
+    block->nextFree = freeLists[block->sizeClass];
+    freeLists[block->sizeClass] = block;
+    --numBuffersInUse;
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class AudioScratchArenaTests  : public UnitTest
+{
+public:
+    AudioScratchArenaTests() : UnitTest ("AudioScratchArena", "Audio") {}
+
+    template <typename Type>
+    void expectChannelsAreAlignedAndSeparate (AudioBuffer<Type>& buffer)
+    {
+        for (int i = 0; i < buffer.getNumChannels(); ++i)
+        {
+            auto* channel = buffer.getWritePointer (i);
+            expect (((pointer_sized_int) channel & 63) == 0);
+
+            if (i > 0)
+                expect (channel >= buffer.getWritePointer (i - 1) + buffer.getNumSamples());
+
+            for (int j = 0; j < buffer.getNumSamples(); ++j)
+                channel[j] = (Type) (i * 10000 + j);
+        }
+
+        for (int i = 0; i < buffer.getNumChannels(); ++i)
+            for (int j = 0; j < buffer.getNumSamples(); ++j)
+                expectEquals (buffer.getSample (i, j), (Type) (i * 10000 + j));
+    }
+
+    void runTest() override
+    {
+        beginTest ("Buffers are aligned and padded");
+        {
+            AudioScratchArena arena;
+
+            for (auto numChannels : { 0, 1, 2, 3, 8 })
+            {
+                for (auto numSamples : { 0, 1, 7, 100, 1000 })
+                {
+                    {
+                        AudioScratchArena::ScopedBuffer<float> buffer (arena, numChannels, numSamples);
+                        expectEquals (buffer->getNumChannels(), numChannels);
+                        expectEquals (buffer->getNumSamples(), numSamples);
+                        expectChannelsAreAlignedAndSeparate (*buffer);
+                    }
+
+                    AudioScratchArena::ScopedBuffer<double> buffer (arena, numChannels, numSamples);
+                    expectChannelsAreAlignedAndSeparate (*buffer);
+                }
+            }
+
+            expectEquals (arena.getNumBuffersInUse(), 0);
+        }
+
+        beginTest ("Blocks are reused");
+        {
+            AudioScratchArena arena;
+
+            for (int i = 0; i < 10; ++i)
+            {
+                AudioScratchArena::ScopedBuffer<float> buffer (arena, 2, 512);
+                buffer->clear();
+            }
+
+            expectEquals (arena.getNumSystemAllocations(), 1);
+
+            {
+                AudioScratchArena::ScopedBuffer<float> a (arena, 2, 512);
+                AudioScratchArena::ScopedBuffer<float> b (arena, 2, 512);
+                expect (a->getWritePointer (0) != b->getWritePointer (0));
+                expectEquals (arena.getNumBuffersInUse(), 2);
+            }
+
+            expectEquals (arena.getNumSystemAllocations(), 2);
+
+            arena.releaseUnusedMemory();
+            AudioScratchArena::ScopedBuffer<float> buffer (arena, 2, 512);
+            expectEquals (arena.getNumSystemAllocations(), 3);
+        }
+
+        beginTest ("Realtime path doesn't allocate once prepared");
+        {
+            AudioScratchArena arena;
+            arena.prepare<float> (2, 512, 2);
+            arena.prepare<double> (4, 512);
+            arena.resetNumSystemAllocations();
+
+            Random r (getRandom());
+
+            for (int i = 0; i < 100; ++i)
+            {
+                auto numSamples = r.nextInt (513);
+
+                AudioScratchArena::ScopedBuffer<float> a (arena, 2, numSamples);
+                AudioScratchArena::ScopedBuffer<double> b (arena, r.nextInt (5), numSamples);
+
+                {
+                    AudioScratchArena::ScopedBuffer<float> c (arena, 1, numSamples);
+                    c->clear();
+                    a->copyFrom (0, 0, *c, 0, 0, numSamples);
+                    a->copyFrom (1, 0, *c, 0, 0, numSamples);
+                }
+
+                b->clear();
+            }
+
+            expectEquals (arena.getNumSystemAllocations(), 0);
+            expectEquals (arena.getNumBuffersInUse(), 0);
+        }
+    }
+};
+
+static AudioScratchArenaTests audioScratchArenaTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,207 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A pool of scratch memory for the temporary AudioBuffers that are needed
+    while rendering audio.
+
+    The arena keeps free lists of blocks in power-of-two size classes. Once it has
+    been prepared for the largest buffers you'll need, borrowing and returning a
+    buffer is just a couple of pointer operations, so it's safe to do on the audio
+    thread without going anywhere near the system allocator.
+
+    The channels of a borrowed buffer are each aligned to, and padded out to a
+    multiple of, a 64-byte cache line, so they can be used with SIMD code and won't
+    share cache lines with each other.
+
+    An arena isn't thread-safe: each thread that renders audio should use its own
+    one, e.g. by making it a member of the object whose render callback uses it.
+
+    @code
+    void prepareToPlay (double, int maximumExpectedSamplesPerBlock) override
+    {
+        scratch.prepare<float> (2, maximumExpectedSamplesPerBlock);
+    }
+
+    void getNextAudioBlock (const AudioSourceChannelInfo& info) override
+    {
+        AudioScratchArena::ScopedBuffer<float> temp (scratch, 2, info.numSamples);
+        temp->clear();
+        ...
+    }
+    @endcode
+
+    @see AudioBuffer
+
+    @tags{Audio}
+*/
+class JUCE_API  AudioScratchArena
+{
+public:
+    //==============================================================================
+    /** Creates an empty arena. */
+    AudioScratchArena() noexcept;
+
+    /** Destructor.
+        All the buffers that were borrowed from the arena must have been returned
+        before it is deleted.
+    */
+    ~AudioScratchArena();
+
+    //==============================================================================
+    /** Makes sure that the given number of buffers of this size can be borrowed at
+        the same time without the arena having to allocate any more memory.
+
+        Call this from somewhere that's allowed to allocate, like prepareToPlay().
+        When there's nothing free in the size class that a buffer needs, the arena
+        will lend out a bigger block instead, so preparing for the largest size that
+        you'll use also covers any smaller buffers.
+    */
+    template <typename Type>
+    void prepare (int numChannels, int numSamples, int numBuffers = 1)
+    {
+        reserve (getNumBytesNeeded (numChannels, numSamples, sizeof (Type)), numBuffers);
+    }
+
+    /** Frees any blocks which aren't currently lent out. */
+    void releaseUnusedMemory();
+
+    //==============================================================================
+    /** Returns the number of times that the arena has had to go to the system
+        allocator since it was created, or since resetNumSystemAllocations() was called.
+
+        If this goes up while rendering, then the arena wasn't prepared for the
+        buffers that are being borrowed. Unit tests can use this to make sure that a
+        realtime code path doesn't allocate.
+    */
+    int getNumSystemAllocations() const noexcept            { return numSystemAllocations; }
+
+    /** Resets the counter returned by getNumSystemAllocations(). */
+    void resetNumSystemAllocations() noexcept               { numSystemAllocations = 0; }
+
+    /** Returns the number of buffers that are currently lent out. */
+    int getNumBuffersInUse() const noexcept                 { return numBuffersInUse; }
+
+    //==============================================================================
+    /**
+        An AudioBuffer that borrows its memory from an AudioScratchArena for as long
+        as this object exists.
+
+        The buffer's contents are initially undefined, so use clear() if you need it
+        to start out silent. As long as it has fewer than 32 channels and the arena
+        was prepared for it, creating one of these won't allocate any memory.
+
+        Don't resize the buffer that this gives you, as that would make it allocate
+        its own memory.
+    */
+    template <typename Type>
+    class ScopedBuffer
+    {
+    public:
+        /** Borrows a buffer of the given size from an arena. */
+        ScopedBuffer (AudioScratchArena& arenaToUse, int numChannels, int numSamples)
+            : arena (arenaToUse)
+        {
+            jassert (numChannels >= 0 && numSamples >= 0);
+
+            data = static_cast<char*> (arena.borrow (getNumBytesNeeded (numChannels, numSamples, sizeof (Type))));
+
+            auto channels = reinterpret_cast<Type**> (data);
+            auto channelData = data + getChannelListSize (numChannels);
+            auto stride = getChannelStride (numSamples, sizeof (Type));
+
+            for (int i = 0; i < numChannels; ++i)
+                channels[i] = reinterpret_cast<Type*> (channelData + (size_t) i * stride);
+
+            buffer.setDataToReferTo (channels, numChannels, numSamples);
+        }
+
+        /** Destructor. This hands the memory back to the arena. */
+        ~ScopedBuffer()
+        {
+            arena.giveBack (data);
+        }
+
+        /** Returns the buffer. */
+        AudioBuffer<Type>& get() noexcept                   { return buffer; }
+        /** Returns the buffer. */
+        AudioBuffer<Type>& operator*() noexcept             { return buffer; }
+        /** Returns the buffer. */
+        AudioBuffer<Type>* operator->() noexcept            { return &buffer; }
+
+    private:
+        AudioScratchArena& arena;
+        char* data;
+        AudioBuffer<Type> buffer;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedBuffer)
+    };
+
+private:
+    //==============================================================================
+    struct Block;
+
+    enum
+    {
+        alignment = 64,
+        minSizeClassBits = 10,
+        numSizeClasses = 40
+    };
+
+    Block* freeLists[numSizeClasses] = {};
+    Block* allocatedBlocks = nullptr;
+    int numSystemAllocations = 0, numBuffersInUse = 0;
+
+    static size_t roundUpToAlignment (size_t numBytes) noexcept
+    {
+        return (numBytes + (alignment - 1)) & ~(size_t) (alignment - 1);
+    }
+
+    static size_t getChannelListSize (int numChannels) noexcept
+    {
+        return roundUpToAlignment ((size_t) (numChannels + 1) * sizeof (void*));
+    }
+
+    static size_t getChannelStride (int numSamples, size_t sampleSize) noexcept
+    {
+        return roundUpToAlignment ((size_t) jmax (1, numSamples) * sampleSize);
+    }
+
+    static size_t getNumBytesNeeded (int numChannels, int numSamples, size_t sampleSize) noexcept
+    {
+        return getChannelListSize (numChannels) + (size_t) numChannels * getChannelStride (numSamples, sampleSize);
+    }
+
+    static int getSizeClass (size_t numBytes) noexcept;
+    Block* allocateBlock (int sizeClass);
+    void reserve (size_t numBytes, int numBuffers);
+    void* borrow (size_t numBytes);
+    void giveBack (void*) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioScratchArena)
+};
+
+} // namespace juce
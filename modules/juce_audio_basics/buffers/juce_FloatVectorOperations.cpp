@@ -485,6 +485,337 @@ namespace FloatVectorHelpers
         }
     };
    #endif
+
+    //==============================================================================
+    template <typename Type>
+    struct MixingOps
+    {
+       #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+        using Mode = typename ModeType<sizeof (Type)>::Mode;
+        using ParallelType = typename Mode::ParallelType;
+
+        static forcedinline ParallelType getLaneIndexes() noexcept
+        {
+            Type indexes[Mode::numParallel];
+
+            for (int i = 0; i < Mode::numParallel; ++i)
+                indexes[i] = (Type) i;
+
+            return Mode::loadU (indexes);
+        }
+
+        static forcedinline Type sum (ParallelType a) noexcept
+        {
+            Type v[Mode::numParallel];
+            Mode::storeU (v, a);
+
+            if (Mode::numParallel == 4)  return (v[0] + v[2]) + (v[1] + v[3]);
+            if (Mode::numParallel == 2)  return v[0] + v[1];
+
+            return v[0];
+        }
+
+        static forcedinline ParallelType abs (ParallelType a) noexcept
+        {
+            return Mode::max (a, Mode::sub (Mode::load1 (0), a));
+        }
+       #endif
+
+        template <bool isAdding>
+        static void ramp (Type* dest, const Type* src, Type startGain, Type endGain, int num) noexcept
+        {
+            if (num <= 0)
+                return;
+
+            // the gain is worked out from the index of each sample rather than accumulated,
+            // so that it doesn't drift over long ramps
+            const auto increment = (endGain - startGain) / (Type) num;
+            int i = 0;
+
+           #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+            const auto start = Mode::load1 (startGain), inc = Mode::load1 (increment);
+            const auto step = Mode::load1 ((Type) Mode::numParallel);
+            auto index = getLaneIndexes();
+
+            for (; i <= num - Mode::numParallel; i += Mode::numParallel)
+            {
+                const auto v = Mode::mul (Mode::loadU (src + i), Mode::add (start, Mode::mul (index, inc)));
+
+                if (isAdding)
+                    Mode::storeU (dest + i, Mode::add (Mode::loadU (dest + i), v));
+                else
+                    Mode::storeU (dest + i, v);
+
+                index = Mode::add (index, step);
+            }
+           #endif
+
+            for (; i < num; ++i)
+            {
+                const auto v = src[i] * (startGain + (Type) i * increment);
+                dest[i] = isAdding ? dest[i] + v : v;
+            }
+        }
+
+        static void multiplyAdd (Type* dest, const Type* src1, const Type* src2, const Type* src3, int num) noexcept
+        {
+            int i = 0;
+
+           #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+            for (; i <= num - Mode::numParallel; i += Mode::numParallel)
+                Mode::storeU (dest + i, Mode::add (Mode::mul (Mode::loadU (src1 + i), Mode::loadU (src2 + i)), Mode::loadU (src3 + i)));
+           #endif
+
+            for (; i < num; ++i)
+                dest[i] = src1[i] * src2[i] + src3[i];
+        }
+
+        static void addWithGains (Type* destLeft, Type* destRight, const Type* src, Type leftGain, Type rightGain, int num) noexcept
+        {
+            int i = 0;
+
+           #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+            const auto left = Mode::load1 (leftGain), right = Mode::load1 (rightGain);
+
+            for (; i <= num - Mode::numParallel; i += Mode::numParallel)
+            {
+                const auto s = Mode::loadU (src + i);
+                Mode::storeU (destLeft + i,  Mode::add (Mode::loadU (destLeft + i),  Mode::mul (s, left)));
+                Mode::storeU (destRight + i, Mode::add (Mode::loadU (destRight + i), Mode::mul (s, right)));
+            }
+           #endif
+
+            for (; i < num; ++i)
+            {
+                destLeft[i]  += src[i] * leftGain;
+                destRight[i] += src[i] * rightGain;
+            }
+        }
+
+        static Type dotProduct (const Type* src1, const Type* src2, int num) noexcept
+        {
+            Type result = 0;
+            int i = 0;
+
+           #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+            auto total = Mode::load1 (0);
+
+            for (; i <= num - Mode::numParallel; i += Mode::numParallel)
+                total = Mode::add (total, Mode::mul (Mode::loadU (src1 + i), Mode::loadU (src2 + i)));
+
+            result = sum (total);
+           #endif
+
+            for (; i < num; ++i)
+                result += src1[i] * src2[i];
+
+            return result;
+        }
+
+        // The squares are accumulated with Kahan summation in each lane, so that long
+        // buffers of floats don't lose precision as the total grows
+        template <bool shouldFindPeak>
+        static double getSumOfSquares (const Type* src, int num, Type& peak) noexcept
+        {
+            Type maxLevel = 0;
+            double total = 0;
+            int i = 0;
+
+           #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+            const auto zero = Mode::load1 (0);
+            auto maxLevels = zero, squares = zero, compensation = zero;
+
+            for (; i <= num - Mode::numParallel; i += Mode::numParallel)
+            {
+                const auto s = Mode::loadU (src + i);
+
+                if (shouldFindPeak)
+                    maxLevels = Mode::max (maxLevels, abs (s));
+
+                const auto y = Mode::sub (Mode::mul (s, s), compensation);
+                const auto t = Mode::add (squares, y);
+                compensation = Mode::sub (Mode::sub (t, squares), y);
+                squares = t;
+            }
+
+            Type lanes[Mode::numParallel], corrections[Mode::numParallel];
+            Mode::storeU (lanes, squares);
+            Mode::storeU (corrections, compensation);
+
+            for (int lane = 0; lane < Mode::numParallel; ++lane)
+                total += (double) lanes[lane] - (double) corrections[lane];
+
+            if (shouldFindPeak)
+                maxLevel = Mode::max (maxLevels);
+           #endif
+
+            for (; i < num; ++i)
+            {
+                const auto s = src[i];
+
+                if (shouldFindPeak)
+                    maxLevel = jmax (maxLevel, std::abs (s));
+
+                total += (double) s * (double) s;
+            }
+
+            peak = maxLevel;
+            return total;
+        }
+
+        static void findPeakAndRMS (const Type* src, int num, Type& peak, Type& rms) noexcept
+        {
+            auto sumOfSquares = getSumOfSquares<true> (src, num, peak);
+            rms = num > 0 ? (Type) std::sqrt (sumOfSquares / num) : Type();
+        }
+
+        static Type findRMS (const Type* src, int num) noexcept
+        {
+            Type unused;
+            auto sumOfSquares = getSumOfSquares<false> (src, num, unused);
+            return num > 0 ? (Type) std::sqrt (sumOfSquares / num) : Type();
+        }
+
+        static void interleave (Type* dest, const Type* const* src, int numChannels, int num) noexcept
+        {
+            if (numChannels == 2 && interleave2 (dest, src[0], src[1], num))
+                return;
+
+            for (int chan = 0; chan < numChannels; ++chan)
+            {
+                auto* s = src[chan];
+                auto* d = dest + chan;
+
+                for (int i = 0; i < num; ++i)
+                    d[i * numChannels] = s[i];
+            }
+        }
+
+        static void deinterleave (Type* const* dest, const Type* src, int numChannels, int num) noexcept
+        {
+            if (numChannels == 2 && deinterleave2 (dest[0], dest[1], src, num))
+                return;
+
+            for (int chan = 0; chan < numChannels; ++chan)
+            {
+                auto* d = dest[chan];
+                auto* s = src + chan;
+
+                for (int i = 0; i < num; ++i)
+                    d[i] = s[i * numChannels];
+            }
+        }
+
+        // These return false if there's no vectorised version for this type
+        static bool interleave2 (float* dest, const float* left, const float* right, int num) noexcept
+        {
+           #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+            int i = 0;
+
+            for (; i <= num - 4; i += 4)
+            {
+               #if JUCE_USE_SSE_INTRINSICS
+                const auto l = _mm_loadu_ps (left + i), r = _mm_loadu_ps (right + i);
+                _mm_storeu_ps (dest + 2 * i,     _mm_unpacklo_ps (l, r));
+                _mm_storeu_ps (dest + 2 * i + 4, _mm_unpackhi_ps (l, r));
+               #else
+                float32x4x2_t lr;
+                lr.val[0] = vld1q_f32 (left + i);
+                lr.val[1] = vld1q_f32 (right + i);
+                vst2q_f32 (dest + 2 * i, lr);
+               #endif
+            }
+
+            for (; i < num; ++i)
+            {
+                dest[2 * i]     = left[i];
+                dest[2 * i + 1] = right[i];
+            }
+
+            return true;
+           #else
+            ignoreUnused (dest, left, right, num);
+            return false;
+           #endif
+        }
+
+        static bool deinterleave2 (float* left, float* right, const float* src, int num) noexcept
+        {
+           #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+            int i = 0;
+
+            for (; i <= num - 4; i += 4)
+            {
+               #if JUCE_USE_SSE_INTRINSICS
+                const auto a = _mm_loadu_ps (src + 2 * i), b = _mm_loadu_ps (src + 2 * i + 4);
+                _mm_storeu_ps (left + i,  _mm_shuffle_ps (a, b, _MM_SHUFFLE (2, 0, 2, 0)));
+                _mm_storeu_ps (right + i, _mm_shuffle_ps (a, b, _MM_SHUFFLE (3, 1, 3, 1)));
+               #else
+                const auto lr = vld2q_f32 (src + 2 * i);
+                vst1q_f32 (left + i,  lr.val[0]);
+                vst1q_f32 (right + i, lr.val[1]);
+               #endif
+            }
+
+            for (; i < num; ++i)
+            {
+                left[i]  = src[2 * i];
+                right[i] = src[2 * i + 1];
+            }
+
+            return true;
+           #else
+            ignoreUnused (left, right, src, num);
+            return false;
+           #endif
+        }
+
+        static bool interleave2 (double* dest, const double* left, const double* right, int num) noexcept
+        {
+           #if JUCE_USE_SSE_INTRINSICS
+            for (int i = 0; i < num - 1; i += 2)
+            {
+                const auto l = _mm_loadu_pd (left + i), r = _mm_loadu_pd (right + i);
+                _mm_storeu_pd (dest + 2 * i,     _mm_unpacklo_pd (l, r));
+                _mm_storeu_pd (dest + 2 * i + 2, _mm_unpackhi_pd (l, r));
+            }
+
+            if (num > 0 && (num & 1) != 0)
+            {
+                dest[2 * num - 2] = left[num - 1];
+                dest[2 * num - 1] = right[num - 1];
+            }
+
+            return true;
+           #else
+            ignoreUnused (dest, left, right, num);
+            return false;
+           #endif
+        }
+
+        static bool deinterleave2 (double* left, double* right, const double* src, int num) noexcept
+        {
+           #if JUCE_USE_SSE_INTRINSICS
+            for (int i = 0; i < num - 1; i += 2)
+            {
+                const auto a = _mm_loadu_pd (src + 2 * i), b = _mm_loadu_pd (src + 2 * i + 2);
+                _mm_storeu_pd (left + i,  _mm_unpacklo_pd (a, b));
+                _mm_storeu_pd (right + i, _mm_unpackhi_pd (a, b));
+            }
+
+            if (num > 0 && (num & 1) != 0)
+            {
+                left[num - 1]  = src[2 * num - 2];
+                right[num - 1] = src[2 * num - 1];
+            }
+
+            return true;
+           #else
+            ignoreUnused (left, right, src, num);
+            return false;
+           #endif
+        }
+    };
 }
 
 //==============================================================================
@@ -1028,6 +1359,99 @@ double JUCE_CALLTYPE FloatVectorOperations::findMaximum (const double* src, int
    #endif
 }
 
+//==============================================================================
+void JUCE_CALLTYPE FloatVectorOperations::copyWithRamp (float* dest, const float* src, float startGain, float endGain, int num) noexcept
+{
+    FloatVectorHelpers::MixingOps<float>::ramp<false> (dest, src, startGain, endGain, num);
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::copyWithRamp (double* dest, const double* src, double startGain, double endGain, int num) noexcept
+{
+    FloatVectorHelpers::MixingOps<double>::ramp<false> (dest, src, startGain, endGain, num);
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::addWithRamp (float* dest, const float* src, float startGain, float endGain, int num) noexcept
+{
+    FloatVectorHelpers::MixingOps<float>::ramp<true> (dest, src, startGain, endGain, num);
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::addWithRamp (double* dest, const double* src, double startGain, double endGain, int num) noexcept
+{
+    FloatVectorHelpers::MixingOps<double>::ramp<true> (dest, src, startGain, endGain, num);
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::multiplyAdd (float* dest, const float* src1, const float* src2, const float* src3, int num) noexcept
+{
+    FloatVectorHelpers::MixingOps<float>::multiplyAdd (dest, src1, src2, src3, num);
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::multiplyAdd (double* dest, const double* src1, const double* src2, const double* src3, int num) noexcept
+{
+    FloatVectorHelpers::MixingOps<double>::multiplyAdd (dest, src1, src2, src3, num);
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::addWithPan (float* destLeft, float* destRight, const float* src, float pan, float gain, int num) noexcept
+{
+    auto angle = (jlimit (-1.0f, 1.0f, pan) + 1.0f) * MathConstants<float>::pi * 0.25f;
+    FloatVectorHelpers::MixingOps<float>::addWithGains (destLeft, destRight, src, gain * std::cos (angle), gain * std::sin (angle), num);
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::addWithPan (double* destLeft, double* destRight, const double* src, double pan, double gain, int num) noexcept
+{
+    auto angle = (jlimit (-1.0, 1.0, pan) + 1.0) * MathConstants<double>::pi * 0.25;
+    FloatVectorHelpers::MixingOps<double>::addWithGains (destLeft, destRight, src, gain * std::cos (angle), gain * std::sin (angle), num);
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::interleave (float* dest, const float* const* src, int numChannels, int num) noexcept
+{
+    FloatVectorHelpers::MixingOps<float>::interleave (dest, src, numChannels, num);
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::interleave (double* dest, const double* const* src, int numChannels, int num) noexcept
+{
+    FloatVectorHelpers::MixingOps<double>::interleave (dest, src, numChannels, num);
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::deinterleave (float* const* dest, const float* src, int numChannels, int num) noexcept
+{
+    FloatVectorHelpers::MixingOps<float>::deinterleave (dest, src, numChannels, num);
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::deinterleave (double* const* dest, const double* src, int numChannels, int num) noexcept
+{
+    FloatVectorHelpers::MixingOps<double>::deinterleave (dest, src, numChannels, num);
+}
+
+float JUCE_CALLTYPE FloatVectorOperations::dotProduct (const float* src1, const float* src2, int num) noexcept
+{
+    return FloatVectorHelpers::MixingOps<float>::dotProduct (src1, src2, num);
+}
+
+double JUCE_CALLTYPE FloatVectorOperations::dotProduct (const double* src1, const double* src2, int num) noexcept
+{
+    return FloatVectorHelpers::MixingOps<double>::dotProduct (src1, src2, num);
+}
+
+float JUCE_CALLTYPE FloatVectorOperations::findRMS (const float* src, int num) noexcept
+{
+    return FloatVectorHelpers::MixingOps<float>::findRMS (src, num);
+}
+
+double JUCE_CALLTYPE FloatVectorOperations::findRMS (const double* src, int num) noexcept
+{
+    return FloatVectorHelpers::MixingOps<double>::findRMS (src, num);
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::findPeakAndRMS (const float* src, int num, float& peak, float& rms) noexcept
+{
+    FloatVectorHelpers::MixingOps<float>::findPeakAndRMS (src, num, peak, rms);
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::findPeakAndRMS (const double* src, int num, double& peak, double& rms) noexcept
+{
+    FloatVectorHelpers::MixingOps<double>::findPeakAndRMS (src, num, peak, rms);
+}
+
 intptr_t JUCE_CALLTYPE FloatVectorOperations::getFpStatusRegister() noexcept
 {
     intptr_t fpsr = 0;
@@ -1232,6 +1656,203 @@ public:
             u.expect (areAllValuesEqual (data1, num, (ValueType) 8));
         }
 
+        static void runMixingTest (UnitTest& u, Random random)
+        {
+            const int num = random.nextInt (random.nextBool() ? 500 : 10) + 1;
+            const auto tolerance = (ValueType) (std::is_same<ValueType, float>::value ? 1.0e-4 : 1.0e-10);
+
+            // (buffer3 is zeroed, as the interleaving test reads from offsets beyond the random values)
+            HeapBlock<ValueType> buffer1 (num + 16), buffer2 (num + 16), buffer3 (num + 16, true), buffer4 (num + 16), expected (num + 16);
+
+            auto* src1 = addBytesToPointer (buffer1.get(), random.nextInt (4) * (int) sizeof (ValueType));
+            auto* src2 = addBytesToPointer (buffer2.get(), random.nextInt (4) * (int) sizeof (ValueType));
+            auto* src3 = addBytesToPointer (buffer3.get(), random.nextInt (4) * (int) sizeof (ValueType));
+            auto* dest = addBytesToPointer (buffer4.get(), random.nextInt (4) * (int) sizeof (ValueType));
+
+            for (int i = 0; i < num; ++i)
+            {
+                src1[i] = (ValueType) (random.nextDouble() * 2.0 - 1.0);
+                src2[i] = (ValueType) (random.nextDouble() * 2.0 - 1.0);
+                src3[i] = (ValueType) (random.nextDouble() * 2.0 - 1.0);
+            }
+
+            auto startGain = (ValueType) random.nextDouble(), endGain = (ValueType) random.nextDouble();
+            auto rampGain = [&] (int i) { return startGain + (endGain - startGain) * (ValueType) i / (ValueType) num; };
+
+            for (int i = 0; i < num; ++i)
+                expected[i] = src1[i] * rampGain (i);
+
+            FloatVectorOperations::copyWithRamp (dest, src1, startGain, endGain, num);
+            u.expect (buffersMatch (dest, expected, num, tolerance));
+
+            for (int i = 0; i < num; ++i)
+                expected[i] += src2[i] * rampGain (i);
+
+            FloatVectorOperations::addWithRamp (dest, src2, startGain, endGain, num);
+            u.expect (buffersMatch (dest, expected, num, tolerance));
+
+            FloatVectorOperations::copy (dest, src1, num);
+            FloatVectorOperations::copyWithRamp (dest, dest, startGain, endGain, num);
+
+            for (int i = 0; i < num; ++i)
+                expected[i] = src1[i] * rampGain (i);
+
+            u.expect (buffersMatch (dest, expected, num, tolerance));
+
+            for (int i = 0; i < num; ++i)
+                expected[i] = src1[i] * src2[i] + src3[i];
+
+            FloatVectorOperations::multiplyAdd (dest, src1, src2, src3, num);
+            u.expect (buffersMatch (dest, expected, num, tolerance));
+
+            {
+                double dot = 0, sumOfSquares = 0, peak = 0;
+
+                for (int i = 0; i < num; ++i)
+                {
+                    dot += (double) src1[i] * (double) src2[i];
+                    sumOfSquares += (double) src3[i] * (double) src3[i];
+                    peak = jmax (peak, (double) std::abs (src3[i]));
+                }
+
+                u.expect (valuesMatch (FloatVectorOperations::dotProduct (src1, src2, num), (ValueType) dot, tolerance));
+
+                ValueType peakResult, rmsResult;
+                FloatVectorOperations::findPeakAndRMS (src3, num, peakResult, rmsResult);
+                u.expectEquals ((double) peakResult, peak);
+                u.expect (valuesMatch (rmsResult, (ValueType) std::sqrt (sumOfSquares / num), tolerance));
+                u.expect (valuesMatch (FloatVectorOperations::findRMS (src3, num), rmsResult, tolerance));
+            }
+
+            {
+                FloatVectorOperations::copy (dest, src1, num);
+                FloatVectorOperations::copy (expected, src2, num);
+                FloatVectorOperations::addWithPan (dest, expected, src3, (ValueType) 0, (ValueType) 2, num);
+
+                for (int i = 0; i < num; ++i)
+                {
+                    u.expect (valuesMatch (dest[i], src1[i] + src3[i] * (ValueType) MathConstants<double>::sqrt2, tolerance));
+                    u.expect (valuesMatch (expected[i], src2[i] + src3[i] * (ValueType) MathConstants<double>::sqrt2, tolerance));
+                }
+
+                FloatVectorOperations::clear (dest, num);
+                FloatVectorOperations::clear (expected, num);
+                FloatVectorOperations::addWithPan (dest, expected, src3, (ValueType) 1, (ValueType) 1, num);
+                u.expect (areAllValuesEqualWithin (dest, num, 0, tolerance));
+                u.expect (buffersMatch (expected, src3, num, tolerance));
+            }
+
+            for (int numChannels = 1; numChannels <= 5; ++numChannels)
+            {
+                HeapBlock<ValueType> interleaved ((size_t) (num * numChannels)), results ((size_t) (num * numChannels));
+                ValueType* channels[5];
+                const ValueType* sources[5];
+
+                for (int chan = 0; chan < numChannels; ++chan)
+                {
+                    channels[chan] = results + chan * num;
+                    sources[chan] = chan == 0 ? src1 : (chan == 1 ? src2 : src3 + chan);
+                }
+
+                FloatVectorOperations::interleave (interleaved, sources, numChannels, num - 2);
+
+                bool allMatch = true;
+
+                for (int i = 0; i < num - 2; ++i)
+                    for (int chan = 0; chan < numChannels; ++chan)
+                        allMatch = allMatch && interleaved[i * numChannels + chan] == sources[chan][i];
+
+                u.expect (allMatch);
+
+                FloatVectorOperations::deinterleave (channels, interleaved, numChannels, num - 2);
+
+                for (int chan = 0; chan < numChannels; ++chan)
+                    u.expect (memcmp (channels[chan], sources[chan], sizeof (ValueType) * (size_t) jmax (0, num - 2)) == 0);
+            }
+        }
+
+        static void runLevelTest (UnitTest& u, Random random)
+        {
+            // relative to the level, as the double-precision reference has rounding errors of its own
+            const auto tolerance = std::is_same<ValueType, float>::value ? 1.0e-6 : 1.0e-12;
+
+            for (int num = 64; num <= 65536; num *= 2)
+            {
+                HeapBlock<ValueType> buffer (num + 16);
+                auto* src = addBytesToPointer (buffer.get(), random.nextInt (4) * (int) sizeof (ValueType));
+                double sumOfSquares = 0, peak = 0;
+
+                for (int i = 0; i < num; ++i)
+                {
+                    src[i] = (ValueType) (random.nextDouble() * 2.0 - 1.0);
+                    sumOfSquares += (double) src[i] * (double) src[i];
+                    peak = jmax (peak, (double) std::abs (src[i]));
+                }
+
+                const auto expectedRMS = std::sqrt (sumOfSquares / num);
+                ValueType peakResult, rmsResult;
+                FloatVectorOperations::findPeakAndRMS (src, num, peakResult, rmsResult);
+
+                u.expectEquals ((double) peakResult, peak);
+                u.expectWithinAbsoluteError ((double) rmsResult, expectedRMS, expectedRMS * tolerance);
+                u.expectWithinAbsoluteError ((double) FloatVectorOperations::findRMS (src, num), expectedRMS, expectedRMS * tolerance);
+            }
+
+            {
+                AudioBuffer<ValueType> buffer (3, 1000);
+
+                for (int chan = 0; chan < buffer.getNumChannels(); ++chan)
+                    for (int i = 0; i < buffer.getNumSamples(); ++i)
+                        buffer.setSample (chan, i, (ValueType) (random.nextDouble() * 2.0 - 1.0));
+
+                ValueType peaks[3], rmsLevels[3];
+                buffer.getPeakAndRMSLevels (10, 900, peaks, rmsLevels);
+
+                for (int chan = 0; chan < buffer.getNumChannels(); ++chan)
+                {
+                    u.expectEquals (peaks[chan], buffer.getMagnitude (chan, 10, 900));
+                    u.expectEquals (rmsLevels[chan], buffer.getRMSLevel (chan, 10, 900));
+                }
+
+                buffer.clear();
+                buffer.getPeakAndRMSLevels (0, 1000, peaks, rmsLevels);
+                u.expect (peaks[0] == 0 && rmsLevels[2] == 0);
+            }
+
+            {
+                // a long run of a constant level is where plain float accumulation falls apart
+                const int num = 1 << 22;
+                HeapBlock<ValueType> src (num);
+                FloatVectorOperations::fill (src, (ValueType) 0.3, num);
+
+                u.expectWithinAbsoluteError ((double) FloatVectorOperations::findRMS (src.get(), num), (double) (ValueType) 0.3,
+                                             0.3 * tolerance);
+            }
+        }
+
+        static bool areAllValuesEqualWithin (const ValueType* d, int num, ValueType target, ValueType tolerance)
+        {
+            while (--num >= 0)
+                if (std::abs (*d++ - target) > tolerance)
+                    return false;
+
+            return true;
+        }
+
+        static bool buffersMatch (const ValueType* d1, const ValueType* d2, int num, ValueType tolerance)
+        {
+            while (--num >= 0)
+                if (! valuesMatch (*d1++, *d2++, tolerance))
+                    return false;
+
+            return true;
+        }
+
+        static bool valuesMatch (ValueType v1, ValueType v2, ValueType tolerance)
+        {
+            return std::abs (v1 - v2) <= tolerance * jmax ((ValueType) 1, std::abs (v2));
+        }
+
         static void doConversionTest (UnitTest& u, float* data1, float* data2, int* const int1, int num)
         {
             FloatVectorOperations::convertFixedToFloat (data1, int1, 2.0f, num);
@@ -1292,6 +1913,19 @@ public:
             TestRunner<float>::runTest (*this, getRandom());
             TestRunner<double>::runTest (*this, getRandom());
         }
+
+        beginTest ("Mixing operations");
+
+        for (int i = 1000; --i >= 0;)
+        {
+            TestRunner<float>::runMixingTest (*this, getRandom());
+            TestRunner<double>::runMixingTest (*this, getRandom());
+        }
+
+        beginTest ("Peak and RMS levels");
+
+        TestRunner<float>::runLevelTest (*this, getRandom());
+        TestRunner<double>::runLevelTest (*this, getRandom());
     }
 };
 
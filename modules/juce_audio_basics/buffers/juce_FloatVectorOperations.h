@@ -214,6 +214,97 @@ public:
     /** Finds the maximum value in the given array. */
     static double JUCE_CALLTYPE findMaximum (const double* src, int numValues) noexcept;
 
+    //==============================================================================
+    /** Copies a vector of floats, multiplying each value by a gain which moves linearly
+        from startGain (for the first value) towards endGain (which would be reached by the
+        value after the last one).
+    */
+    static void JUCE_CALLTYPE copyWithRamp (float* dest, const float* src, float startGain, float endGain, int numValues) noexcept;
+
+    /** Copies a vector of doubles, multiplying each value by a gain which moves linearly
+        from startGain (for the first value) towards endGain (which would be reached by the
+        value after the last one).
+    */
+    static void JUCE_CALLTYPE copyWithRamp (double* dest, const double* src, double startGain, double endGain, int numValues) noexcept;
+
+    /** Multiplies each source value by a gain which moves linearly from startGain towards
+        endGain, and adds the result to the destination vector.
+        @see copyWithRamp
+    */
+    static void JUCE_CALLTYPE addWithRamp (float* dest, const float* src, float startGain, float endGain, int numValues) noexcept;
+
+    /** Multiplies each source value by a gain which moves linearly from startGain towards
+        endGain, and adds the result to the destination vector.
+        @see copyWithRamp
+    */
+    static void JUCE_CALLTYPE addWithRamp (double* dest, const double* src, double startGain, double endGain, int numValues) noexcept;
+
+    /** Each element of dest will be src1[i] * src2[i] + src3[i]. */
+    static void JUCE_CALLTYPE multiplyAdd (float* dest, const float* src1, const float* src2, const float* src3, int num) noexcept;
+
+    /** Each element of dest will be src1[i] * src2[i] + src3[i]. */
+    static void JUCE_CALLTYPE multiplyAdd (double* dest, const double* src1, const double* src2, const double* src3, int num) noexcept;
+
+    /** Adds a mono source to a pair of stereo destination vectors, using a constant-power
+        pan law.
+        @param destLeft     the left channel to add to
+        @param destRight    the right channel to add to
+        @param src          the mono source
+        @param pan          the pan position, from -1.0 (hard left) to 1.0 (hard right). At
+                            the centre, each side gets the source at -3dB.
+        @param gain         an overall gain to apply to the source
+        @param numValues    the number of values to process
+    */
+    static void JUCE_CALLTYPE addWithPan (float* destLeft, float* destRight, const float* src, float pan, float gain, int numValues) noexcept;
+
+    /** Adds a mono source to a pair of stereo destination vectors, using a constant-power
+        pan law.
+        @see addWithPan
+    */
+    static void JUCE_CALLTYPE addWithPan (double* destLeft, double* destRight, const double* src, double pan, double gain, int numValues) noexcept;
+
+    /** Interleaves a set of separate channels into a single vector. */
+    static void JUCE_CALLTYPE interleave (float* dest, const float* const* src, int numChannels, int numSamples) noexcept;
+
+    /** Interleaves a set of separate channels into a single vector. */
+    static void JUCE_CALLTYPE interleave (double* dest, const double* const* src, int numChannels, int numSamples) noexcept;
+
+    /** Splits a vector of interleaved samples into separate channels. */
+    static void JUCE_CALLTYPE deinterleave (float* const* dest, const float* src, int numChannels, int numSamples) noexcept;
+
+    /** Splits a vector of interleaved samples into separate channels. */
+    static void JUCE_CALLTYPE deinterleave (double* const* dest, const double* src, int numChannels, int numSamples) noexcept;
+
+    /** Returns the sum of the products of the corresponding elements of two vectors. */
+    static float JUCE_CALLTYPE dotProduct (const float* src1, const float* src2, int numValues) noexcept;
+
+    /** Returns the sum of the products of the corresponding elements of two vectors. */
+    static double JUCE_CALLTYPE dotProduct (const double* src1, const double* src2, int numValues) noexcept;
+
+    /** Returns the root-mean-square level of a vector.
+        The squares are accumulated with compensated summation, so this stays accurate
+        for long buffers.
+    */
+    static float JUCE_CALLTYPE findRMS (const float* src, int numValues) noexcept;
+
+    /** Returns the root-mean-square level of a vector.
+        The squares are accumulated with compensated summation, so this stays accurate
+        for long buffers.
+    */
+    static double JUCE_CALLTYPE findRMS (const double* src, int numValues) noexcept;
+
+    /** Finds the peak absolute value and the root-mean-square level of a vector in a
+        single pass.
+    */
+    static void JUCE_CALLTYPE findPeakAndRMS (const float* src, int numValues, float& peak, float& rms) noexcept;
+
+    /** Finds the peak absolute value and the root-mean-square level of a vector in a
+        single pass.
+    */
+    static void JUCE_CALLTYPE findPeakAndRMS (const double* src, int numValues, double& peak, double& rms) noexcept;
+
+    //==============================================================================
+
     /** This method enables or disables the SSE/NEON flush-to-zero mode. */
     static void JUCE_CALLTYPE enableFlushToZeroMode (bool shouldEnable) noexcept;
 
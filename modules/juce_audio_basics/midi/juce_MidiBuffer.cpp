@@ -85,6 +85,32 @@ namespace MidiBufferHelpers
     }
 }
 
+//==============================================================================
+MidiBufferIterator& MidiBufferIterator::operator++() noexcept
+{
+    data += MidiBufferHelpers::getEventTotalSize (data);
+    return *this;
+}
+
+MidiBufferIterator MidiBufferIterator::operator++ (int) noexcept
+{
+    auto copy = *this;
+    ++(*this);
+    return copy;
+}
+
+MidiMessageMetadata MidiBufferIterator::operator*() const noexcept
+{
+    return { data + sizeof (int32) + sizeof (uint16),
+             MidiBufferHelpers::getEventDataSize (data),
+             MidiBufferHelpers::getEventTime (data) };
+}
+
+int MidiBufferIterator::getSamplePosition() const noexcept
+{
+    return MidiBufferHelpers::getEventTime (data);
+}
+
 //==============================================================================
 MidiBuffer::MidiBuffer() noexcept {}
 MidiBuffer::~MidiBuffer() {}
@@ -156,6 +182,19 @@ void MidiBuffer::addEvents (const MidiBuffer& otherBuffer,
     }
 }
 
+MidiBufferIterator MidiBuffer::findNextSamplePosition (const int samplePosition) const noexcept
+{
+    return MidiBufferIterator (MidiBufferHelpers::findEventAfter (data.begin(), data.end(), samplePosition - 1));
+}
+
+MidiBuffer::EventRange MidiBuffer::getEventsInRange (const int startSample, const int numSamples) const noexcept
+{
+    auto* const start = MidiBufferHelpers::findEventAfter (data.begin(), data.end(), startSample - 1);
+    auto* const end   = MidiBufferHelpers::findEventAfter (start,        data.end(), startSample + numSamples - 1);
+
+    return { MidiBufferIterator (start), MidiBufferIterator (end) };
+}
+
 int MidiBuffer::getNumEvents() const noexcept
 {
     int n = 0;
@@ -234,4 +273,67 @@ bool MidiBuffer::Iterator::getNextEvent (MidiMessage& result, int& samplePositio
     return true;
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct MidiBufferTest  : public juce::UnitTest
+{
+    MidiBufferTest() : juce::UnitTest ("MidiBuffer", "MIDI/MPE") {}
+
+    void runTest() override
+    {
+        MidiBuffer buffer;
+
+        for (int i = 0; i < 10; ++i)
+            buffer.addEvent (MidiMessage::noteOn (1, 60 + i, 0.5f), i * 10);
+
+        buffer.addEvent (MidiMessage::noteOff (1, 60), 30);
+
+        beginTest ("Iterating");
+        {
+            int numEvents = 0, lastPosition = -1;
+
+            for (auto metadata : buffer)
+            {
+                expect (metadata.samplePosition >= lastPosition);
+                expectEquals (metadata.numBytes, 3);
+                lastPosition = metadata.samplePosition;
+                ++numEvents;
+            }
+
+            expectEquals (numEvents, buffer.getNumEvents());
+            expect (MidiBuffer().begin() == MidiBuffer().end());
+        }
+
+        beginTest ("Finding positions");
+        {
+            expectEquals (buffer.findNextSamplePosition (0).getSamplePosition(), 0);
+            expectEquals (buffer.findNextSamplePosition (25).getSamplePosition(), 30);
+            expect ((*buffer.findNextSamplePosition (30)).getMessage().isNoteOn());
+            expect (buffer.findNextSamplePosition (91) == buffer.cend());
+        }
+
+        beginTest ("Ranges");
+        {
+            auto countEvents = [] (const MidiBuffer::EventRange& range)
+            {
+                return (int) std::distance (range.begin(), range.end());
+            };
+
+            expectEquals (countEvents (buffer.getEventsInRange (0, 100)), 11);
+            expectEquals (countEvents (buffer.getEventsInRange (30, 1)), 2);
+            expectEquals (countEvents (buffer.getEventsInRange (31, 9)), 0);
+            expectEquals (countEvents (buffer.getEventsInRange (25, 20)), 3);
+            expect (buffer.getEventsInRange (100, 50).isEmpty());
+
+            for (auto metadata : buffer.getEventsInRange (30, 1))
+                expectEquals (metadata.samplePosition, 30);
+        }
+    }
+};
+
+static MidiBufferTest midiBufferTest;
+
+#endif
+
 } // namespace juce
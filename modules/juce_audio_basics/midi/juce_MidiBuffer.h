@@ -23,6 +23,89 @@
 namespace juce
 {
 
+//==============================================================================
+/**
+    A view of a MIDI message stored in a MidiBuffer.
+
+    The data pointer points directly into the MidiBuffer's internal storage, so
+    this is only valid until the buffer is next modified.
+
+    @see MidiBuffer, MidiBufferIterator
+
+    @tags{Audio}
+*/
+struct MidiMessageMetadata
+{
+    MidiMessageMetadata() noexcept = default;
+
+    MidiMessageMetadata (const uint8* dataIn, int numBytesIn, int positionIn) noexcept
+        : data (dataIn), numBytes (numBytesIn), samplePosition (positionIn)
+    {
+    }
+
+    /** Creates a MidiMessage from the data in this event.
+        The message's timestamp is set to the event's sample position.
+    */
+    MidiMessage getMessage() const      { return MidiMessage (data, numBytes, samplePosition); }
+
+    /** A pointer to the raw midi data of the event. */
+    const uint8* data = nullptr;
+
+    /** The number of bytes of midi data in the event. */
+    int numBytes = 0;
+
+    /** The position of the event, as a sample index within the buffer. */
+    int samplePosition = 0;
+};
+
+//==============================================================================
+/**
+    A forward iterator over the events in a MidiBuffer.
+
+    Unlike MidiBuffer::Iterator, this doesn't copy any event data - dereferencing
+    it just decodes the event header in-place and returns a MidiMessageMetadata.
+    Note that altering the buffer while an iterator is using it will produce
+    undefined behaviour.
+
+    @see MidiBuffer
+
+    @tags{Audio}
+*/
+class JUCE_API  MidiBufferIterator
+{
+public:
+    using difference_type   = std::ptrdiff_t;
+    using value_type        = MidiMessageMetadata;
+    using reference         = MidiMessageMetadata;
+    using pointer           = void;
+    using iterator_category = std::forward_iterator_tag;
+
+    MidiBufferIterator() noexcept = default;
+
+    /** Constructs an iterator pointing at the event header starting at the given address. */
+    explicit MidiBufferIterator (const uint8* dataToUse) noexcept  : data (dataToUse) {}
+
+    bool operator== (const MidiBufferIterator& other) const noexcept    { return data == other.data; }
+    bool operator!= (const MidiBufferIterator& other) const noexcept    { return data != other.data; }
+
+    /** Advances to the next event. */
+    MidiBufferIterator& operator++() noexcept;
+
+    /** Advances to the next event, returning the iterator's previous state. */
+    MidiBufferIterator operator++ (int) noexcept;
+
+    /** Returns a view of the event at the current position. */
+    MidiMessageMetadata operator*() const noexcept;
+
+    /** Returns the sample position of the event at the current position.
+        This is cheaper than dereferencing the iterator if you only need the timestamp.
+    */
+    int getSamplePosition() const noexcept;
+
+private:
+    const uint8* data = nullptr;
+};
+
 //==============================================================================
 /**
     Holds a sequence of time-stamped midi events.
@@ -158,10 +241,61 @@ public:
     */
     void ensureSize (size_t minimumNumBytes);
 
+    //==============================================================================
+    /** Returns an iterator pointing to the first event in the buffer. */
+    MidiBufferIterator begin() const noexcept   { return cbegin(); }
+
+    /** Returns an iterator pointing one past the last event in the buffer. */
+    MidiBufferIterator end() const noexcept     { return cend(); }
+
+    /** Returns an iterator pointing to the first event in the buffer. */
+    MidiBufferIterator cbegin() const noexcept  { return MidiBufferIterator (data.begin()); }
+
+    /** Returns an iterator pointing one past the last event in the buffer. */
+    MidiBufferIterator cend() const noexcept    { return MidiBufferIterator (data.end()); }
+
+    /** Returns an iterator pointing to the first event whose sample position is greater
+        than or equal to the given position, or cend() if there's no such event.
+    */
+    MidiBufferIterator findNextSamplePosition (int samplePosition) const noexcept;
+
+    //==============================================================================
+    /**
+        A contiguous run of events from a MidiBuffer, as returned by getEventsInRange().
+
+        Because the buffer is kept sorted, all the events within a range of sample
+        positions are stored next to each other, so once a block's range has been found,
+        it can be walked without any further searching. Like MidiBufferIterator, this
+        only remains valid until the buffer is modified.
+    */
+    struct EventRange
+    {
+        MidiBufferIterator begin() const noexcept   { return first; }
+        MidiBufferIterator end() const noexcept     { return last; }
+
+        /** Returns true if there are no events in this range. */
+        bool isEmpty() const noexcept               { return first == last; }
+
+        MidiBufferIterator first, last;
+    };
+
+    /** Returns the events for which (startSample <= position < startSample + numSamples).
+
+        The result can be used in a range-based for loop, e.g.
+        @code
+        for (auto metadata : buffer.getEventsInRange (startSample, numSamples))
+            handleEvent (metadata.data, metadata.numBytes, metadata.samplePosition);
+        @endcode
+    */
+    EventRange getEventsInRange (int startSample, int numSamples) const noexcept;
+
     //==============================================================================
     /**
         Used to iterate through the events in a MidiBuffer.
 
+        For new code, the MidiBufferIterator returned by begin() and
+        findNextSamplePosition() is a lighter-weight alternative to this class.
+
         Note that altering the buffer while an iterator is using it will produce
         undefined behaviour.
 
@@ -27,6 +27,13 @@ namespace
 {
     const uint8 noLSBValueReceived = 0xff;
     const Range<int> allChannels { 1, 17 };
+
+    enum PendingChangeFlags : uint8
+    {
+        pressureChanged  = 1,
+        pitchbendChanged = 2,
+        timbreChanged    = 4
+    };
 }
 
 //==============================================================================
@@ -35,6 +42,11 @@ MPEInstrument::MPEInstrument() noexcept
     std::fill_n (lastPressureLowerBitReceivedOnChannel, 16, noLSBValueReceived);
     std::fill_n (lastTimbreLowerBitReceivedOnChannel, 16, noLSBValueReceived);
     std::fill_n (isMemberChannelSustained, 16, false);
+    std::fill_n (numNotesOnChannel, 16, (uint8) 0);
+    std::fill_n (&noteSlots[0][0], 16 * 128, (uint16) 0);
+    std::fill_n (&pendingChanges[0][0], 16 * 128, (uint8) 0);
+
+    notes.ensureStorageAllocated (128);
 
     pitchbendDimension.value = &MPENote::pitchbend;
     pressureDimension.value = &MPENote::pressure;
@@ -139,6 +151,38 @@ void MPEInstrument::removeListener (Listener* listenerToRemove)
     listeners.remove (listenerToRemove);
 }
 
+//==============================================================================
+void MPEInstrument::setExpressionCallbacksBatched (bool shouldBatch)
+{
+    if (! shouldBatch)
+        dispatchPendingExpressionCallbacks();
+
+    const ScopedLock sl (lock);
+    batchExpressionCallbacks = shouldBatch;
+}
+
+bool MPEInstrument::areExpressionCallbacksBatched() const noexcept
+{
+    return batchExpressionCallbacks;
+}
+
+void MPEInstrument::dispatchPendingExpressionCallbacks()
+{
+    const ScopedLock sl (lock);
+
+    // (the listeners may cause more changes to be queued while this is running, so
+    // the number of pending notes is re-read on each iteration)
+    for (int i = 0; i < numPendingNotes; ++i)
+    {
+        auto key = pendingNotes[i];
+
+        if (auto* note = getNotePtr ((key >> 7) + 1, key & 127))
+            callPendingListeners (*note);
+    }
+
+    removeDispatchedPendingNotes();
+}
+
 //==============================================================================
 void MPEInstrument::processNextMidiEvent (const MidiMessage& message)
 {
@@ -227,8 +271,8 @@ void MPEInstrument::processMidiResetAllControllersMessage (const MidiMessage& me
             {
                 note.keyState = MPENote::off;
                 note.noteOffVelocity = MPEValue::from7BitInt (64); // some reasonable number
-                listeners.call ([&] (Listener& l) { l.noteReleased (note); });
-                notes.remove (i);
+                callListenersNoteReleased (note);
+                removeNote (i);
             }
         }
     }
@@ -245,8 +289,8 @@ void MPEInstrument::processMidiResetAllControllersMessage (const MidiMessage& me
             {
                 note.keyState = MPENote::off;
                 note.noteOffVelocity = MPEValue::from7BitInt (64); // some reasonable number
-                listeners.call ([&] (Listener& l) { l.noteReleased (note); });
-                notes.remove (i);
+                callListenersNoteReleased (note);
+                removeNote (i);
             }
         }
     }
@@ -287,6 +331,12 @@ void MPEInstrument::noteOn (int midiChannel,
     if (! isMemberChannel (midiChannel))
         return;
 
+    // MIDI note numbers must be in the range 0 to 127!
+    jassert (isPositiveAndBelow (midiNoteNumber, 128));
+
+    if (! isPositiveAndBelow (midiNoteNumber, 128))
+        return;
+
     MPENote newNote (midiChannel,
                      midiNoteNumber,
                      midiNoteOnVelocity,
@@ -303,11 +353,11 @@ void MPEInstrument::noteOn (int midiChannel,
         // pathological case: second note-on received for same note -> retrigger it
         alreadyPlayingNote->keyState = MPENote::off;
         alreadyPlayingNote->noteOffVelocity = MPEValue::from7BitInt (64); // some reasonable number
-        listeners.call ([=] (Listener& l) { l.noteReleased (*alreadyPlayingNote); });
-        notes.remove (alreadyPlayingNote);
+        callListenersNoteReleased (*alreadyPlayingNote);
+        removeNote ((int) (alreadyPlayingNote - notes.begin()));
     }
 
-    notes.add (newNote);
+    addNote (newNote);
     listeners.call ([&] (Listener& l) { l.noteAdded (newNote); });
 }
 
@@ -334,8 +384,8 @@ void MPEInstrument::noteOff (int midiChannel,
 
         if (note->keyState == MPENote::off)
         {
-            listeners.call ([=] (Listener& l) { l.noteReleased (*note); });
-            notes.remove (note);
+            callListenersNoteReleased (*note);
+            removeNote ((int) (note - notes.begin()));
         }
         else
         {
@@ -383,13 +433,8 @@ void MPEInstrument::updateDimension (int midiChannel, MPEDimension& dimension, M
     {
         if (dimension.trackingMode == allNotesOnChannel)
         {
-            for (auto i = notes.size(); --i >= 0;)
-            {
-                auto& note = notes.getReference (i);
-
-                if (note.midiChannel == midiChannel)
-                    updateDimensionForNote (note, dimension, value);
-            }
+            for (auto i = (int) numNotesOnChannel[midiChannel - 1]; --i >= 0;)
+                updateDimensionForNote (getNoteOnChannel (midiChannel, i), dimension, value);
         }
         else
         {
@@ -424,7 +469,7 @@ void MPEInstrument::updateDimensionMaster (bool isLowerZone, MPEDimension& dimen
             // master pitchbend is a special case: we don't change the note's own pitchbend,
             // instead we have to update its total (master + note) pitchbend.
             updateNoteTotalPitchbend (note);
-            listeners.call ([&] (Listener& l) { l.notePitchbendChanged (note); });
+            callListenersDimensionChanged (note, dimension);
         }
         else if (dimension.getValue (note) != value)
         {
@@ -451,11 +496,57 @@ void MPEInstrument::updateDimensionForNote (MPENote& note, MPEDimension& dimensi
 //==============================================================================
 void MPEInstrument::callListenersDimensionChanged (const MPENote& note, const MPEDimension& dimension)
 {
+    if (batchExpressionCallbacks)
+    {
+        auto& flags = pendingChanges[note.midiChannel - 1][note.initialNote];
+
+        if (flags == 0)
+        {
+            if (numPendingNotes == numElementsInArray (pendingNotes))
+                removeDispatchedPendingNotes();
+
+            pendingNotes[numPendingNotes++] = (uint16) (((note.midiChannel - 1) << 7) | note.initialNote);
+        }
+
+        flags |= (&dimension == &pressureDimension ? pressureChanged
+                                                   : (&dimension == &timbreDimension ? timbreChanged
+                                                                                     : pitchbendChanged));
+        return;
+    }
+
     if (&dimension == &pressureDimension)  { listeners.call ([&] (Listener& l) { l.notePressureChanged  (note); }); return; }
     if (&dimension == &timbreDimension)    { listeners.call ([&] (Listener& l) { l.noteTimbreChanged    (note); }); return; }
     if (&dimension == &pitchbendDimension) { listeners.call ([&] (Listener& l) { l.notePitchbendChanged (note); }); return; }
 }
 
+void MPEInstrument::callPendingListeners (const MPENote& note)
+{
+    auto& flags = pendingChanges[note.midiChannel - 1][note.initialNote];
+    auto changes = flags;
+    flags = 0;
+
+    if ((changes & pressureChanged) != 0)   listeners.call ([&] (Listener& l) { l.notePressureChanged  (note); });
+    if ((changes & pitchbendChanged) != 0)  listeners.call ([&] (Listener& l) { l.notePitchbendChanged (note); });
+    if ((changes & timbreChanged) != 0)     listeners.call ([&] (Listener& l) { l.noteTimbreChanged    (note); });
+}
+
+void MPEInstrument::callListenersNoteReleased (const MPENote& note)
+{
+    // any expression changes that are still waiting to be delivered for this note
+    // have to arrive before it's released
+    callPendingListeners (note);
+
+    listeners.call ([&] (Listener& l) { l.noteReleased (note); });
+}
+
+void MPEInstrument::removeDispatchedPendingNotes() noexcept
+{
+    auto* end = std::remove_if (pendingNotes, pendingNotes + numPendingNotes,
+                                [this] (uint16 key) { return pendingChanges[key >> 7][key & 127] == 0; });
+
+    numPendingNotes = (int) (end - pendingNotes);
+}
+
 //==============================================================================
 void MPEInstrument::updateNoteTotalPitchbend (MPENote& note)
 {
@@ -531,8 +622,8 @@ void MPEInstrument::handleSustainOrSostenuto (int midiChannel, bool isDown, bool
 
             if (note.keyState == MPENote::off)
             {
-                listeners.call ([&] (Listener& l) { l.noteReleased (note); });
-                notes.remove (i);
+                callListenersNoteReleased (note);
+                removeNote (i);
             }
             else
             {
@@ -620,13 +711,11 @@ MPENote MPEInstrument::getMostRecentNoteOtherThan (MPENote otherThanThisNote) co
 //==============================================================================
 const MPENote* MPEInstrument::getNotePtr (int midiChannel, int midiNoteNumber) const noexcept
 {
-    for (int i = 0; i < notes.size(); ++i)
-    {
-        auto& note = notes.getReference (i);
+    if (! (isPositiveAndBelow (midiChannel - 1, 16) && isPositiveAndBelow (midiNoteNumber, 128)))
+        return nullptr;
 
-        if (note.midiChannel == midiChannel && note.initialNote == midiNoteNumber)
-            return &note;
-    }
+    if (auto slot = noteSlots[midiChannel - 1][midiNoteNumber])
+        return &notes.getReference (slot - 1);
 
     return nullptr;
 }
@@ -658,12 +747,14 @@ MPENote* MPEInstrument::getNotePtr (int midiChannel, TrackingMode mode) noexcept
 //==============================================================================
 const MPENote* MPEInstrument::getLastNotePlayedPtr (int midiChannel) const noexcept
 {
-    for (auto i = notes.size(); --i >= 0;)
+    if (! isPositiveAndBelow (midiChannel - 1, 16))
+        return nullptr;
+
+    for (auto i = (int) numNotesOnChannel[midiChannel - 1]; --i >= 0;)
     {
-        auto& note = notes.getReference (i);
+        auto& note = getNoteOnChannel (midiChannel, i);
 
-        if (note.midiChannel == midiChannel
-             && (note.keyState == MPENote::keyDown || note.keyState == MPENote::keyDownAndSustained))
+        if ((note.keyState == MPENote::keyDown || note.keyState == MPENote::keyDownAndSustained))
             return &note;
     }
 
@@ -679,14 +770,16 @@ MPENote* MPEInstrument::getLastNotePlayedPtr (int midiChannel) noexcept
 const MPENote* MPEInstrument::getHighestNotePtr (int midiChannel) const noexcept
 {
     int initialNoteMax = -1;
-    MPENote* result = nullptr;
+    const MPENote* result = nullptr;
 
-    for (auto i = notes.size(); --i >= 0;)
+    if (! isPositiveAndBelow (midiChannel - 1, 16))
+        return nullptr;
+
+    for (auto i = (int) numNotesOnChannel[midiChannel - 1]; --i >= 0;)
     {
-        auto& note = notes.getReference (i);
+        auto& note = getNoteOnChannel (midiChannel, i);
 
-        if (note.midiChannel == midiChannel
-             && (note.keyState == MPENote::keyDown || note.keyState == MPENote::keyDownAndSustained)
+        if ((note.keyState == MPENote::keyDown || note.keyState == MPENote::keyDownAndSustained)
              && note.initialNote > initialNoteMax)
         {
             result = &note;
@@ -705,14 +798,16 @@ MPENote* MPEInstrument::getHighestNotePtr (int midiChannel) noexcept
 const MPENote* MPEInstrument::getLowestNotePtr (int midiChannel) const noexcept
 {
     int initialNoteMin = 128;
-    MPENote* result = nullptr;
+    const MPENote* result = nullptr;
 
-    for (auto i = notes.size(); --i >= 0;)
+    if (! isPositiveAndBelow (midiChannel - 1, 16))
+        return nullptr;
+
+    for (auto i = (int) numNotesOnChannel[midiChannel - 1]; --i >= 0;)
     {
-        auto& note = notes.getReference (i);
+        auto& note = getNoteOnChannel (midiChannel, i);
 
-        if (note.midiChannel == midiChannel
-             && (note.keyState == MPENote::keyDown || note.keyState == MPENote::keyDownAndSustained)
+        if ((note.keyState == MPENote::keyDown || note.keyState == MPENote::keyDownAndSustained)
              && note.initialNote < initialNoteMin)
         {
             result = &note;
@@ -738,10 +833,57 @@ void MPEInstrument::releaseAllNotes()
         auto& note = notes.getReference (i);
         note.keyState = MPENote::off;
         note.noteOffVelocity = MPEValue::from7BitInt (64); // some reasonable number
-        listeners.call ([&] (Listener& l) { l.noteReleased (note); });
+        callListenersNoteReleased (note);
     }
 
-    notes.clear();
+    for (auto& note : notes)
+    {
+        noteSlots[note.midiChannel - 1][note.initialNote] = 0;
+        numNotesOnChannel[note.midiChannel - 1] = 0;
+    }
+
+    notes.clearQuick();
+    removeDispatchedPendingNotes();
+}
+
+//==============================================================================
+void MPEInstrument::addNote (const MPENote& newNote)
+{
+    auto channelIndex = newNote.midiChannel - 1;
+
+    notes.add (newNote);
+    noteSlots[channelIndex][newNote.initialNote] = (uint16) notes.size();
+    notesOnChannel[channelIndex][numNotesOnChannel[channelIndex]++] = newNote.initialNote;
+}
+
+void MPEInstrument::removeNote (int index)
+{
+    auto& note = notes.getReference (index);
+    auto channelIndex = note.midiChannel - 1;
+    auto* channelNotes = notesOnChannel[channelIndex];
+
+    noteSlots[channelIndex][note.initialNote] = 0;
+    pendingChanges[channelIndex][note.initialNote] = 0;
+    std::remove (channelNotes, channelNotes + numNotesOnChannel[channelIndex]--, note.initialNote);
+
+    notes.remove (index);
+
+    // the notes after the one that was removed have all moved down by one place
+    for (int i = index; i < notes.size(); ++i)
+    {
+        auto& laterNote = notes.getReference (i);
+        noteSlots[laterNote.midiChannel - 1][laterNote.initialNote] = (uint16) (i + 1);
+    }
+}
+
+const MPENote& MPEInstrument::getNoteOnChannel (int midiChannel, int index) const noexcept
+{
+    return notes.getReference (noteSlots[midiChannel - 1][notesOnChannel[midiChannel - 1][index]] - 1);
+}
+
+MPENote& MPEInstrument::getNoteOnChannel (int midiChannel, int index) noexcept
+{
+    return notes.getReference (noteSlots[midiChannel - 1][notesOnChannel[midiChannel - 1][index]] - 1);
 }
 
 //==============================================================================
@@ -2052,6 +2194,140 @@ public:
                 expectEquals (test.getNumPlayingNotes(), 0);
             }
         }
+
+        beginTest ("note lookup after many note-ons and note-offs");
+        {
+            MPEInstrument test;
+            test.enableLegacyMode();
+            Array<MPENote> expectedNotes;
+            auto random = getRandom();
+
+            for (int i = 0; i < 5000; ++i)
+            {
+                auto channel = random.nextInt ({ 1, 17 });
+                auto noteNumber = random.nextInt (12) + 60;
+
+                if (random.nextBool())
+                {
+                    test.noteOn (channel, noteNumber, MPEValue::from7BitInt (100));
+
+                    for (int j = expectedNotes.size(); --j >= 0;)
+                        if (expectedNotes.getReference (j).midiChannel == channel && expectedNotes.getReference (j).initialNote == noteNumber)
+                            expectedNotes.remove (j);
+
+                    expectedNotes.add (test.getNote (channel, noteNumber));
+                }
+                else
+                {
+                    test.noteOff (channel, noteNumber, MPEValue::from7BitInt (64));
+
+                    for (int j = expectedNotes.size(); --j >= 0;)
+                        if (expectedNotes.getReference (j).midiChannel == channel && expectedNotes.getReference (j).initialNote == noteNumber)
+                            expectedNotes.remove (j);
+                }
+            }
+
+            expectEquals (test.getNumPlayingNotes(), expectedNotes.size());
+
+            for (int i = 0; i < expectedNotes.size(); ++i)
+            {
+                auto& expected = expectedNotes.getReference (i);
+                expect (test.getNote (i) == expected);
+                expect (test.getNote (expected.midiChannel, expected.initialNote) == expected);
+            }
+
+            for (int channel = 1; channel <= 16; ++channel)
+            {
+                MPENote mostRecent;
+
+                for (auto& note : expectedNotes)
+                    if (note.midiChannel == channel)
+                        mostRecent = note;
+
+                expectEquals (test.getMostRecentNote (channel).noteID, mostRecent.noteID);
+            }
+
+            expect (! test.getNote (0, 60).isValid());
+            expect (! test.getNote (17, 60).isValid());
+        }
+
+        beginTest ("batched expression callbacks");
+        {
+            // replays a dense stream of per-note expression data on all the member
+            // channels of both zones, and checks that batching the callbacks delivers
+            // the same final note states with far fewer calls
+            UnitTestInstrument immediate, batched;
+            immediate.setZoneLayout (testLayout);
+            batched.setZoneLayout (testLayout);
+            batched.setExpressionCallbacksBatched (true);
+            expect (batched.areExpressionCallbacksBatched());
+
+            MidiBuffer stream;
+            const int samplesPerMessage = 48, blockSize = 512, numSamples = 48000;
+            auto random = getRandom();
+
+            for (int channel = 2; channel <= 15; ++channel)
+                stream.addEvent (MidiMessage::noteOn (channel, 50 + channel, (uint8) 100), 0);
+
+            for (int time = 1; time < numSamples; time += samplesPerMessage)
+            {
+                for (int channel = 2; channel <= 15; ++channel)
+                {
+                    stream.addEvent (MidiMessage::channelPressureChange (channel, random.nextInt (128)), time);
+                    stream.addEvent (MidiMessage::pitchWheel (channel, random.nextInt (16384)), time);
+                    stream.addEvent (MidiMessage::controllerEvent (channel, 74, random.nextInt (128)), time);
+                }
+            }
+
+            stream.addEvent (MidiMessage::noteOff (3, 53, (uint8) 0), numSamples / 2);
+            stream.addEvent (MidiMessage::pitchWheel (1, 1000), numSamples / 2 + 10);
+
+            for (int start = 0; start < numSamples; start += blockSize)
+            {
+                for (const auto metadata : stream)
+                {
+                    if (metadata.samplePosition >= start && metadata.samplePosition < start + blockSize)
+                    {
+                        immediate.processNextMidiEvent (metadata.getMessage());
+                        batched.processNextMidiEvent (metadata.getMessage());
+                    }
+                }
+
+                batched.dispatchPendingExpressionCallbacks();
+            }
+
+            expectEquals (batched.getNumPlayingNotes(), immediate.getNumPlayingNotes());
+            expectEquals (batched.noteReleasedCallCounter, immediate.noteReleasedCallCounter);
+
+            for (int i = 0; i < immediate.getNumPlayingNotes(); ++i)
+                expect (batched.getNote (i) == immediate.getNote (i)
+                          && batched.getNote (i).pressure == immediate.getNote (i).pressure
+                          && batched.getNote (i).pitchbend == immediate.getNote (i).pitchbend
+                          && batched.getNote (i).timbre == immediate.getNote (i).timbre
+                          && batched.getNote (i).totalPitchbendInSemitones == immediate.getNote (i).totalPitchbendInSemitones);
+
+            const int numBlocks = (numSamples + blockSize - 1) / blockSize;
+            expect (batched.notePressureChangedCallCounter <= 14 * numBlocks);
+            expect (batched.notePitchbendChangedCallCounter <= 14 * numBlocks);
+            expect (batched.noteTimbreChangedCallCounter <= 14 * numBlocks);
+            expect (immediate.notePressureChangedCallCounter > 4 * batched.notePressureChangedCallCounter);
+
+            // a note that's released with changes pending must get them first
+            batched.pressure (2, MPEValue::from7BitInt (3));
+            auto numPressureCalls = batched.notePressureChangedCallCounter;
+            batched.noteOff (2, 52, MPEValue::from7BitInt (64));
+            expectEquals (batched.notePressureChangedCallCounter, numPressureCalls + 1);
+            expectEquals (batched.lastNoteFinished->pressure.as7BitInt(), 3);
+
+            batched.timbre (4, MPEValue::from7BitInt (3));
+            batched.setExpressionCallbacksBatched (false);
+            expect (! batched.areExpressionCallbacksBatched());
+            auto numTimbreCalls = batched.noteTimbreChangedCallCounter;
+            batched.dispatchPendingExpressionCallbacks();
+            expectEquals (batched.noteTimbreChangedCallCounter, numTimbreCalls);
+            batched.timbre (4, MPEValue::from7BitInt (5));
+            expectEquals (batched.noteTimbreChangedCallCounter, numTimbreCalls + 1);
+        }
     }
 
 private:
@@ -236,6 +236,8 @@ public:
         via the message thread (so you might be for example in the MIDI thread).
         Therefore you should never do heavy work such as graphics rendering etc.
         inside those callbacks.
+
+        @see setExpressionCallbacksBatched
     */
     class JUCE_API  Listener
     {
@@ -291,6 +293,40 @@ public:
     /** Removes a listener. */
     void removeListener (Listener* listenerToRemove);
 
+    //==============================================================================
+    /** Enables or disables batching of the expression callbacks.
+
+        When this is enabled, the notePressureChanged, notePitchbendChanged and
+        noteTimbreChanged callbacks aren't made as each message arrives. Instead,
+        the instrument remembers which notes have changed, and calls the listeners
+        once for each of them with its latest state when you call
+        dispatchPendingExpressionCallbacks() - e.g. once per audio block.
+        This avoids a flood of callbacks when a controller sends continuous
+        per-note expression data.
+
+        The noteAdded, noteKeyStateChanged and noteReleased callbacks are still made
+        immediately, and any pending expression callbacks for a note are always
+        made before its noteReleased callback.
+
+        Turning batching off will dispatch any callbacks that are still pending.
+
+        @see dispatchPendingExpressionCallbacks
+    */
+    void setExpressionCallbacksBatched (bool shouldBatchCallbacks);
+
+    /** Returns true if the expression callbacks are being batched.
+        @see setExpressionCallbacksBatched
+    */
+    bool areExpressionCallbacksBatched() const noexcept;
+
+    /** If the expression callbacks are being batched, this calls the listeners for
+        all the notes whose pressure, pitchbend or timbre has changed since the last
+        time it was called.
+
+        @see setExpressionCallbacksBatched
+    */
+    void dispatchPendingExpressionCallbacks();
+
     //==============================================================================
     /** Puts the instrument into legacy mode.
         As a side effect, this will discard all currently playing notes,
@@ -343,6 +379,18 @@ private:
     uint8 lastTimbreLowerBitReceivedOnChannel[16];
     bool isMemberChannelSustained[16];
 
+    // O(1) lookup for the playing notes: noteSlots holds 1 + the index in the notes array
+    // of the note for each channel and note number (or 0 if there isn't one), and
+    // notesOnChannel lists the note numbers playing on each channel, oldest first
+    uint16 noteSlots[16][128];
+    uint8 notesOnChannel[16][128];
+    uint8 numNotesOnChannel[16];
+
+    uint8 pendingChanges[16][128];
+    uint16 pendingNotes[16 * 128];
+    int numPendingNotes = 0;
+    bool batchExpressionCallbacks = false;
+
     struct LegacyMode
     {
         bool isEnabled;
@@ -365,6 +413,9 @@ private:
     void updateDimensionMaster (bool, MPEDimension&, MPEValue);
     void updateDimensionForNote (MPENote&, MPEDimension&, MPEValue);
     void callListenersDimensionChanged (const MPENote&, const MPEDimension&);
+    void callListenersNoteReleased (const MPENote&);
+    void callPendingListeners (const MPENote&);
+    void removeDispatchedPendingNotes() noexcept;
     MPEValue getInitialValueForNewNote (int midiChannel, MPEDimension&) const;
 
     void processMidiNoteOnMessage (const MidiMessage&);
@@ -391,6 +442,11 @@ private:
     MPENote* getLowestNotePtr (int midiChannel) noexcept;
     void updateNoteTotalPitchbend (MPENote&);
 
+    void addNote (const MPENote&);
+    void removeNote (int index);
+    const MPENote& getNoteOnChannel (int midiChannel, int index) const noexcept;
+    MPENote& getNoteOnChannel (int midiChannel, int index) noexcept;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MPEInstrument)
 };
 
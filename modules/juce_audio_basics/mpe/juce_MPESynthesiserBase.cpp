@@ -110,48 +110,45 @@ void MPESynthesiserBase::renderNextBlock (AudioBuffer<floatType>& outputAudio,
     // you must set the sample rate before using this!
     jassert (sampleRate != 0);
 
-    MidiBuffer::Iterator midiIterator (inputMidi);
-    midiIterator.setNextSamplePosition (startSample);
+    auto midiIterator = inputMidi.findNextSamplePosition (startSample);
+    const auto midiEnd = inputMidi.cend();
 
     bool firstEvent = true;
-    int midiEventPos;
-    MidiMessage m;
 
     const ScopedLock sl (noteStateLock);
 
     while (numSamples > 0)
     {
-        if (! midiIterator.getNextEvent (m, midiEventPos))
+        if (midiIterator == midiEnd)
         {
             renderNextSubBlock (outputAudio, startSample, numSamples);
             return;
         }
 
-        auto samplesToNextMidiMessage = midiEventPos - startSample;
+        auto samplesToNextMidiMessage = midiIterator.getSamplePosition() - startSample;
 
         if (samplesToNextMidiMessage >= numSamples)
         {
             renderNextSubBlock (outputAudio, startSample, numSamples);
-            handleMidiEvent (m);
             break;
         }
 
         if (samplesToNextMidiMessage < ((firstEvent && ! subBlockSubdivisionIsStrict) ? 1 : minimumSubBlockSize))
         {
-            handleMidiEvent (m);
+            handleMidiEvent ((*midiIterator++).getMessage());
             continue;
         }
 
         firstEvent = false;
 
         renderNextSubBlock (outputAudio, startSample, samplesToNextMidiMessage);
-        handleMidiEvent (m);
+        handleMidiEvent ((*midiIterator++).getMessage());
         startSample += samplesToNextMidiMessage;
         numSamples  -= samplesToNextMidiMessage;
     }
 
-    while (midiIterator.getNextEvent (m, midiEventPos))
-        handleMidiEvent (m);
+    for (; midiIterator != midiEnd; ++midiIterator)
+        handleMidiEvent ((*midiIterator).getMessage());
 }
 
 // explicit instantiation for supported float types:
@@ -65,8 +65,7 @@ void BufferingAudioSource::prepareToPlay (int samplesPerBlockExpected, double ne
         buffer.setSize (numberOfChannels, bufferSizeNeeded);
         buffer.clear();
 
-        bufferValidStart = 0;
-        bufferValidEnd = 0;
+        setValidRange (0, 0, true);
 
         backgroundThread.addTimeSliceClient (this);
 
@@ -96,19 +95,20 @@ void BufferingAudioSource::releaseResources()
 
 void BufferingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
 {
-    const ScopedLock sl (bufferStartPosLock);
+    auto pos = nextPlayPos.load();
+    BufferRange range;
 
-    auto start = bufferValidStart.load();
-    auto end   = bufferValidEnd.load();
-    auto pos   = nextPlayPos.load();
+    if (! getValidRange (range))
+        range = { 0, 0, 0 }; // the background thread is in the middle of changing it
 
-    auto validStart = (int) (jlimit (start, end, pos) - pos);
-    auto validEnd   = (int) (jlimit (start, end, pos + info.numSamples) - pos);
+    auto validStart = (int) (jlimit (range.start, range.end, pos) - pos);
+    auto validEnd   = (int) (jlimit (range.start, range.end, pos + info.numSamples) - pos);
 
     if (validStart == validEnd)
     {
         // total cache miss
         info.clearActiveBufferRegion();
+        ++numUnderruns;
     }
     else
     {
@@ -124,8 +124,8 @@ void BufferingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info
             for (int chan = jmin (numberOfChannels, info.buffer->getNumChannels()); --chan >= 0;)
             {
                 jassert (buffer.getNumSamples() > 0);
-                auto startBufferIndex = (int) ((validStart + nextPlayPos) % buffer.getNumSamples());
-                auto endBufferIndex   = (int) ((validEnd + nextPlayPos)   % buffer.getNumSamples());
+                auto startBufferIndex = (int) ((validStart + pos) % buffer.getNumSamples());
+                auto endBufferIndex   = (int) ((validEnd + pos)   % buffer.getNumSamples());
 
                 if (startBufferIndex < endBufferIndex)
                 {
@@ -151,7 +151,24 @@ void BufferingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info
             }
         }
 
-        nextPlayPos += info.numSamples;
+        // The background thread doesn't wait for us, so make sure that it didn't start
+        // refilling the part of the buffer we were copying from while we were doing so..
+        BufferRange rangeAfterCopying;
+
+        if (! getValidRange (rangeAfterCopying)
+             || rangeAfterCopying.generation != range.generation
+             || rangeAfterCopying.start > pos + validStart)
+        {
+            info.clearActiveBufferRegion();
+            ++numUnderruns;
+        }
+        else if (validStart > 0 || validEnd < info.numSamples)
+        {
+            ++numUnderruns;
+        }
+
+        // (if the position has been changed in the meantime, that takes precedence)
+        nextPlayPos.compare_exchange_strong (pos, pos + info.numSamples);
     }
 }
 
@@ -174,15 +191,14 @@ bool BufferingAudioSource::waitForNextAudioBlockReady (const AudioSourceChannelI
 
     while (elapsed <= timeout)
     {
-        {
-            const ScopedLock sl (bufferStartPosLock);
+        BufferRange range;
 
-            auto start = bufferValidStart.load();
-            auto end   = bufferValidEnd.load();
-            auto pos   = nextPlayPos.load();
+        if (getValidRange (range))
+        {
+            auto pos = nextPlayPos.load();
 
-            auto validStart = static_cast<int> (jlimit (start, end, pos) - pos);
-            auto validEnd   = static_cast<int> (jlimit (start, end, pos + info.numSamples) - pos);
+            auto validStart = static_cast<int> (jlimit (range.start, range.end, pos) - pos);
+            auto validEnd   = static_cast<int> (jlimit (range.start, range.end, pos + info.numSamples) - pos);
 
             if (validStart <= 0 && validStart < validEnd && validEnd >= info.numSamples)
                 return true;
@@ -211,8 +227,6 @@ int64 BufferingAudioSource::getNextReadPosition() const
 
 void BufferingAudioSource::setNextReadPosition (int64 newPosition)
 {
-    const ScopedLock sl (bufferStartPosLock);
-
     nextPlayPos = newPosition;
     backgroundThread.moveToFrontOfQueue (this);
 }
@@ -221,44 +235,39 @@ bool BufferingAudioSource::readNextBufferChunk()
 {
     int64 newBVS, newBVE, sectionToReadStart, sectionToReadEnd;
 
+    if (wasSourceLooping != isLooping())
     {
-        const ScopedLock sl (bufferStartPosLock);
-
-        if (wasSourceLooping != isLooping())
-        {
-            wasSourceLooping = isLooping();
-            bufferValidStart = 0;
-            bufferValidEnd = 0;
-        }
+        wasSourceLooping = isLooping();
+        setValidRange (0, 0, true);
+    }
 
-        newBVS = jmax ((int64) 0, nextPlayPos.load());
-        newBVE = newBVS + buffer.getNumSamples() - 4;
-        sectionToReadStart = 0;
-        sectionToReadEnd = 0;
+    newBVS = jmax ((int64) 0, nextPlayPos.load());
+    newBVE = newBVS + buffer.getNumSamples() - 4;
+    sectionToReadStart = 0;
+    sectionToReadEnd = 0;
 
-        const int maxChunkSize = 2048;
+    const int maxChunkSize = 2048;
 
-        if (newBVS < bufferValidStart || newBVS >= bufferValidEnd)
-        {
-            newBVE = jmin (newBVE, newBVS + maxChunkSize);
+    if (newBVS < bufferValidStart || newBVS >= bufferValidEnd)
+    {
+        newBVE = jmin (newBVE, newBVS + maxChunkSize);
 
-            sectionToReadStart = newBVS;
-            sectionToReadEnd = newBVE;
+        sectionToReadStart = newBVS;
+        sectionToReadEnd = newBVE;
 
-            bufferValidStart = 0;
-            bufferValidEnd = 0;
-        }
-        else if (std::abs ((int) (newBVS - bufferValidStart)) > 512
-                  || std::abs ((int) (newBVE - bufferValidEnd)) > 512)
-        {
-            newBVE = jmin (newBVE, bufferValidEnd + maxChunkSize);
+        setValidRange (0, 0, true);
+    }
+    else if (std::abs ((int) (newBVS - bufferValidStart)) > 512
+              || std::abs ((int) (newBVE - bufferValidEnd)) > 512)
+    {
+        newBVE = jmin (newBVE, bufferValidEnd + maxChunkSize);
 
-            sectionToReadStart = bufferValidEnd;
-            sectionToReadEnd = newBVE;
+        sectionToReadStart = bufferValidEnd;
+        sectionToReadEnd = newBVE;
 
-            bufferValidStart = newBVS;
-            bufferValidEnd = jmin (bufferValidEnd.load(), newBVE);
-        }
+        // (the region before newBVS is about to be overwritten, so it needs to be
+        // removed from the valid range before we start reading into it)
+        setValidRange (newBVS, jmin (bufferValidEnd.load(), newBVE), false);
     }
 
     if (sectionToReadStart == sectionToReadEnd)
@@ -287,12 +296,7 @@ bool BufferingAudioSource::readNextBufferChunk()
                            0);
     }
 
-    {
-        const ScopedLock sl2 (bufferStartPosLock);
-
-        bufferValidStart = newBVS;
-        bufferValidEnd = newBVE;
-    }
+    setValidRange (newBVS, newBVE, false);
 
     bufferReadyEvent.signal();
     return true;
@@ -312,4 +316,163 @@ int BufferingAudioSource::useTimeSlice()
     return readNextBufferChunk() ? 1 : 100;
 }
 
+int BufferingAudioSource::getMillisecondsUntilDeadline()
+{
+    if (sampleRate <= 0)
+        return std::numeric_limits<int>::max();
+
+    auto pos = nextPlayPos.load();
+    auto end = bufferValidEnd.load();
+
+    if (pos < bufferValidStart.load() || pos >= end)
+        return 0;
+
+    return (int) jmin ((int64) std::numeric_limits<int>::max(),
+                       (int64) ((double) (end - pos) * 1000.0 / sampleRate));
+}
+
+//==============================================================================
+bool BufferingAudioSource::getValidRange (BufferRange& range) const noexcept
+{
+    // The range is only ever changed by the background thread, and only takes a moment,
+    // so if it's being changed we'll only retry a few times rather than blocking
+    for (int attempts = 0; attempts < 8; ++attempts)
+    {
+        auto version = rangeVersion.load();
+
+        if ((version & 1) == 0)
+        {
+            range = { bufferValidStart.load(), bufferValidEnd.load(), bufferGeneration.load() };
+
+            if (rangeVersion.load() == version)
+                return true;
+        }
+    }
+
+    return false;
+}
+
+void BufferingAudioSource::setValidRange (int64 start, int64 end, bool invalidatesBuffer) noexcept
+{
+    ++rangeVersion;
+
+    if (invalidatesBuffer)
+        ++bufferGeneration;
+
+    bufferValidStart = start;
+    bufferValidEnd = end;
+
+    ++rangeVersion;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct BufferingAudioSourceTests  : public UnitTest
+{
+    BufferingAudioSourceTests()  : UnitTest ("BufferingAudioSource", "Audio") {}
+
+    // Produces a different value for every position and channel
+    struct TestSource  : public PositionableAudioSource
+    {
+        TestSource (int seed, int64 totalLength)  : offset ((float) seed), length (totalLength) {}
+
+        static float getSample (float offset, int chan, int64 pos)
+        {
+            return offset + (float) (chan * 1000 + pos % 1000) * 0.001f;
+        }
+
+        void prepareToPlay (int, double) override  {}
+        void releaseResources() override           {}
+
+        void getNextAudioBlock (const AudioSourceChannelInfo& info) override
+        {
+            for (int chan = 0; chan < info.buffer->getNumChannels(); ++chan)
+                for (int i = 0; i < info.numSamples; ++i)
+                    info.buffer->setSample (chan, info.startSample + i, getSample (offset, chan, position + i));
+
+            position += info.numSamples;
+        }
+
+        void setNextReadPosition (int64 newPosition) override   { position = newPosition; }
+        int64 getNextReadPosition() const override              { return position; }
+        int64 getTotalLength() const override                   { return length; }
+        bool isLooping() const override                         { return false; }
+
+        const float offset;
+        const int64 length;
+        int64 position = 0;
+    };
+
+    void runTest() override
+    {
+        const int blockSize = 512, length = 44100;
+
+        beginTest ("Reading");
+        {
+            TimeSliceThread thread ("Buffering test");
+            thread.startThread();
+
+            OwnedArray<BufferingAudioSource> sources;
+
+            for (int i = 0; i < 16; ++i)
+            {
+                sources.add (new BufferingAudioSource (new TestSource (i, length), thread, true, 8192));
+                sources.getLast()->prepareToPlay (blockSize, 44100.0);
+            }
+
+            AudioBuffer<float> block (2, blockSize);
+            bool allCorrect = true, allReady = true;
+
+            for (int pos = 0; pos + blockSize <= length; pos += blockSize)
+            {
+                for (int i = 0; i < sources.size(); ++i)
+                {
+                    AudioSourceChannelInfo info (block);
+                    allReady = sources.getUnchecked (i)->waitForNextAudioBlockReady (info, 2000) && allReady;
+                    sources.getUnchecked (i)->getNextAudioBlock (info);
+
+                    for (int chan = 0; chan < 2; ++chan)
+                        for (int j = 0; j < blockSize; ++j)
+                            allCorrect = allCorrect && block.getSample (chan, j) == TestSource::getSample ((float) i, chan, pos + j);
+                }
+            }
+
+            expect (allReady);
+            expect (allCorrect);
+
+            for (auto* s : sources)
+                expectEquals (s->getNumUnderruns(), 0);
+
+            sources.clear();
+        }
+
+        beginTest ("Underruns");
+        {
+            // this thread never gets started, so nothing will ever be read into the buffer
+            TimeSliceThread thread ("Buffering test");
+            BufferingAudioSource source (new TestSource (1, length), thread, true, 8192, 2, false);
+            source.prepareToPlay (blockSize, 44100.0);
+
+            AudioBuffer<float> block (2, blockSize);
+            block.clear();
+            block.setSample (0, 0, 1.0f);
+
+            source.getNextAudioBlock (AudioSourceChannelInfo (block));
+            expectEquals (source.getNumUnderruns(), 1);
+            expectEquals (block.getMagnitude (0, blockSize), 0.0f);
+
+            source.getNextAudioBlock (AudioSourceChannelInfo (block));
+            expectEquals (source.getNumUnderruns(), 2);
+
+            source.resetNumUnderruns();
+            expectEquals (source.getNumUnderruns(), 0);
+        }
+    }
+};
+
+static BufferingAudioSourceTests bufferingAudioSourceTests;
+
+#endif
+
 } // namespace juce
@@ -31,6 +31,11 @@ namespace juce
     a background thread to smooth out playback. You can either create one of these
     directly, or use it indirectly using an AudioTransportSource.
 
+    Reading from the buffer never blocks: if the background thread hasn't read the
+    data that's needed yet, getNextAudioBlock() fills the gap with silence, and this
+    is counted as an underrun - see getNumUnderruns(). When several sources share the
+    same thread, it will give priority to the ones that have the least audio buffered.
+
     @see PositionableAudioSource, AudioTransportSource
 
     @tags{Audio}
@@ -97,21 +102,43 @@ public:
     */
     bool waitForNextAudioBlockReady (const AudioSourceChannelInfo& info, const uint32 timeout);
 
+    //==============================================================================
+    /** Returns the number of times getNextAudioBlock() has been called when some of the
+        data that it needed hadn't been read from the source yet, and had to be replaced
+        with silence.
+
+        @see resetNumUnderruns
+    */
+    int getNumUnderruns() const noexcept        { return numUnderruns; }
+
+    /** Resets the count returned by getNumUnderruns() to zero. */
+    void resetNumUnderruns() noexcept           { numUnderruns = 0; }
+
 private:
     //==============================================================================
+    struct BufferRange
+    {
+        int64 start, end;
+        uint32 generation;
+    };
+
     OptionalScopedPointer<PositionableAudioSource> source;
     TimeSliceThread& backgroundThread;
     int numberOfSamplesToBuffer, numberOfChannels;
     AudioBuffer<float> buffer;
-    CriticalSection bufferStartPosLock;
     WaitableEvent bufferReadyEvent;
     std::atomic<int64> bufferValidStart { 0 }, bufferValidEnd { 0 }, nextPlayPos { 0 };
+    std::atomic<uint32> rangeVersion { 0 }, bufferGeneration { 0 };
+    std::atomic<int> numUnderruns { 0 };
     double sampleRate = 0;
     bool wasSourceLooping = false, isPrepared = false, prefillBuffer;
 
+    bool getValidRange (BufferRange&) const noexcept;
+    void setValidRange (int64 start, int64 end, bool invalidatesBuffer) noexcept;
     bool readNextBufferChunk();
     void readBufferSection (int64 start, int length, int bufferOffset);
     int useTimeSlice() override;
+    int getMillisecondsUntilDeadline() override;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BufferingAudioSource)
 };
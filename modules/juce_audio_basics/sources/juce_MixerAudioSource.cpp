@@ -23,37 +23,192 @@
 namespace juce
 {
 
+//==============================================================================
+struct MixerAudioSource::InputList
+{
+    InputList() = default;
+
+    InputList (const InputList& other)
+        : inputs (other.inputs), inputsToDelete (other.inputsToDelete)
+    {
+    }
+
+    // Any inputs that were removed while this list was in use are released (and deleted,
+    // if the mixer owns them) along with it, because that's when the audio thread is
+    // known to have finished with them
+    ~InputList()
+    {
+        for (auto* input : removedInputs)
+            input->releaseResources();
+    }
+
+    void createBuffers (bool needed, int numChannels, int numSamples)
+    {
+        buffers.clear();
+        numBufferChannels = numChannels;
+        numBufferSamples = numSamples;
+
+        // (the first input renders straight into the output, so doesn't need one)
+        if (needed && numSamples > 0)
+            for (int i = 0; i < inputs.size(); ++i)
+                buffers.add (i == 0 ? nullptr : new AudioBuffer<float> (numChannels, numSamples));
+    }
+
+    // The workers mustn't allocate, so a block that's bigger than the buffers is rendered serially
+    bool canRenderInParallel (const AudioSourceChannelInfo& info) const noexcept
+    {
+        return inputs.size() > 1
+                && buffers.size() == inputs.size()
+                && info.buffer->getNumChannels() <= numBufferChannels
+                && info.numSamples <= numBufferSamples;
+    }
+
+    void renderInput (int index, const AudioSourceChannelInfo& info) const
+    {
+        if (index == 0)
+        {
+            inputs.getUnchecked (0)->getNextAudioBlock (info);
+        }
+        else
+        {
+            // (this never needs to reallocate, as canRenderInParallel() has checked the size)
+            auto& buffer = *buffers.getUnchecked (index);
+            buffer.setSize (jmax (1, info.buffer->getNumChannels()), info.numSamples, false, false, true);
+
+            AudioSourceChannelInfo bufferInfo (&buffer, 0, info.numSamples);
+            inputs.getUnchecked (index)->getNextAudioBlock (bufferInfo);
+        }
+    }
+
+    Array<AudioSource*> inputs, removedInputs;
+    BigInteger inputsToDelete;
+    OwnedArray<AudioBuffer<float>> buffers;
+    OwnedArray<AudioSource> removedInputsToDelete;
+    int numBufferChannels = 0, numBufferSamples = 0;
+};
+
+//==============================================================================
+struct MixerAudioSource::WorkerPool
+{
+    WorkerPool (MixerAudioSource& m, int numThreads)
+    {
+        for (int i = 0; i < numThreads; ++i)
+            workers.add (new Worker (*this, m, i))->startThread (Thread::realtimeAudioPriority);
+    }
+
+    // Called on the audio thread, which also takes a share of the inputs while it waits
+    void render (const InputList& list, const AudioSourceChannelInfo& info)
+    {
+        currentList = &list;
+        currentInfo = &info;
+        nextInputIndex = 0;
+        numWorkersBusy = workers.size();
+
+        for (auto* w : workers)
+            w->notify();
+
+        renderNextInputs();
+        finished.wait();
+    }
+
+    void renderNextInputs()
+    {
+        auto numInputs = currentList->inputs.size();
+
+        for (;;)
+        {
+            auto index = nextInputIndex++;
+
+            if (index >= numInputs)
+                break;
+
+            currentList->renderInput (index, *currentInfo);
+        }
+    }
+
+    struct Worker  : public Thread
+    {
+        Worker (WorkerPool& p, MixerAudioSource& m, int index)
+            : Thread ("Mixer worker " + String (index + 1)), pool (p), mixer (m)
+        {
+        }
+
+        ~Worker() override
+        {
+            stopThread (-1);
+        }
+
+        void run() override
+        {
+            // this thread only ever does anything from inside the mixer's callback
+            mixer.isRenderingOnThisThread = true;
+
+            for (;;)
+            {
+                wait (-1);
+
+                if (threadShouldExit())
+                    break;
+
+                pool.renderNextInputs();
+
+                if (--pool.numWorkersBusy == 0)
+                    pool.finished.signal();
+            }
+
+            mixer.isRenderingOnThisThread.releaseCurrentThreadStorage();
+        }
+
+        WorkerPool& pool;
+        MixerAudioSource& mixer;
+    };
+
+    OwnedArray<Worker> workers;
+    const InputList* currentList = nullptr;
+    const AudioSourceChannelInfo* currentInfo = nullptr;
+    std::atomic<int> nextInputIndex { 0 }, numWorkersBusy { 0 };
+    WaitableEvent finished;
+};
+
+//==============================================================================
 MixerAudioSource::MixerAudioSource()
    : currentSampleRate (0.0), bufferSizeExpected (0)
 {
+    activeInputs = new InputList();
 }
 
 MixerAudioSource::~MixerAudioSource()
 {
     removeAllInputs();
+    setNumberOfThreadsToUse (0);
+
+    delete activeInputs.load();
 }
 
 //==============================================================================
 void MixerAudioSource::addInputSource (AudioSource* input, const bool deleteWhenRemoved)
 {
-    if (input != nullptr && ! inputs.contains (input))
+    if (input != nullptr)
     {
-        double localRate;
-        int localBufferSize;
+        std::unique_ptr<InputList> oldList;
 
         {
             const ScopedLock sl (lock);
-            localRate = currentSampleRate;
-            localBufferSize = bufferSizeExpected;
-        }
+            std::unique_ptr<InputList> newList (new InputList (*activeInputs.load()));
 
-        if (localRate > 0.0)
-            input->prepareToPlay (localBufferSize, localRate);
+            if (newList->inputs.contains (input))
+                return;
 
-        const ScopedLock sl (lock);
+            if (currentSampleRate > 0.0)
+                input->prepareToPlay (bufferSizeExpected, currentSampleRate);
+
+            newList->inputsToDelete.setBit (newList->inputs.size(), deleteWhenRemoved);
+            newList->inputs.add (input);
 
-        inputsToDelete.setBit (inputs.size(), deleteWhenRemoved);
-        inputs.add (input);
+            oldList = updateInputList (std::move (newList));
+        }
+
+        retire (std::move (oldList), nullptr);
     }
 }
 
@@ -61,63 +216,178 @@ void MixerAudioSource::removeInputSource (AudioSource* const input)
 {
     if (input != nullptr)
     {
-        std::unique_ptr<AudioSource> toDelete;
+        std::unique_ptr<InputList> oldList;
 
         {
             const ScopedLock sl (lock);
-            const int index = inputs.indexOf (input);
+            std::unique_ptr<InputList> newList (new InputList (*activeInputs.load()));
+            const int index = newList->inputs.indexOf (input);
 
             if (index < 0)
                 return;
 
-            if (inputsToDelete [index])
-                toDelete.reset (input);
+            newList->inputsToDelete.shiftBits (-1, index);
+            newList->inputs.remove (index);
 
-            inputsToDelete.shiftBits (-1, index);
-            inputs.remove (index);
+            oldList = updateInputList (std::move (newList));
+            oldList->removedInputs.add (input);
+
+            if (oldList->inputsToDelete [index])
+                oldList->removedInputsToDelete.add (input);
         }
 
-        input->releaseResources();
+        retire (std::move (oldList), nullptr);
     }
 }
 
 void MixerAudioSource::removeAllInputs()
 {
-    OwnedArray<AudioSource> toDelete;
+    std::unique_ptr<InputList> oldList;
+
+    {
+        const ScopedLock sl (lock);
+        oldList = updateInputList (std::unique_ptr<InputList> (new InputList()));
+
+        for (int i = oldList->inputs.size(); --i >= 0;)
+        {
+            if (oldList->inputsToDelete[i])
+            {
+                oldList->removedInputs.add (oldList->inputs.getUnchecked (i));
+                oldList->removedInputsToDelete.add (oldList->inputs.getUnchecked (i));
+            }
+        }
+    }
+
+    retire (std::move (oldList), nullptr);
+}
+
+int MixerAudioSource::getNumInputs() const noexcept
+{
+    return numInputs.load();
+}
+
+//==============================================================================
+void MixerAudioSource::setNumberOfThreadsToUse (int numThreads)
+{
+    numThreads = jmax (0, numThreads);
+
+    std::unique_ptr<InputList> oldList;
+    std::unique_ptr<WorkerPool> oldWorkers;
 
     {
         const ScopedLock sl (lock);
 
-        for (int i = inputs.size(); --i >= 0;)
-            if (inputsToDelete[i])
-                toDelete.add (inputs.getUnchecked(i));
+        if (numThreads == numThreadsToUse)
+            return;
+
+        numThreadsToUse = numThreads;
 
-        inputs.clear();
+        // This adds or removes the buffers that each input needs to render into..
+        oldList = updateInputList (std::unique_ptr<InputList> (new InputList (*activeInputs.load())));
+
+        oldWorkers.reset (activeWorkers.exchange (numThreads > 0 ? new WorkerPool (*this, numThreads)
+                                                                 : nullptr));
     }
 
-    for (int i = toDelete.size(); --i >= 0;)
-        toDelete.getUnchecked(i)->releaseResources();
+    retire (std::move (oldList), std::move (oldWorkers));
+}
+
+int MixerAudioSource::getNumberOfThreadsToUse() const noexcept
+{
+    const ScopedLock sl (lock);
+    return numThreadsToUse;
 }
 
+std::unique_ptr<MixerAudioSource::InputList> MixerAudioSource::updateInputList (std::unique_ptr<InputList> newList)
+{
+    newList->createBuffers (numThreadsToUse > 0, jmax (2, numChannelsToBuffer.load()), bufferSizeExpected);
+    numInputs = newList->inputs.size();
+
+    return std::unique_ptr<InputList> (activeInputs.exchange (newList.release()));
+}
+
+void MixerAudioSource::retire (std::unique_ptr<InputList> oldList, std::unique_ptr<WorkerPool> oldWorkers)
+{
+    if (oldList == nullptr && oldWorkers == nullptr)
+        return;
+
+    // If this has been called from inside the mixer's own callback (e.g. by an input that
+    // removes itself when it finishes), the callback can't end until this returns, so the
+    // old objects are kept until the start of the next callback instead
+    if (isRenderingOnThisThread.get())
+    {
+        const ScopedLock sl (lock);
+
+        if (oldList != nullptr)
+            retiredLists.add (oldList.release());
+
+        if (oldWorkers != nullptr)
+            retiredWorkers.add (oldWorkers.release());
+
+        hasRetiredObjects = true;
+        return;
+    }
+
+    waitForAudioCallbackToFinish();
+}
+
+void MixerAudioSource::deleteRetiredObjects()
+{
+    const ScopedTryLock sl (lock);
+
+    if (sl.isLocked())
+    {
+        retiredLists.clear();
+        retiredWorkers.clear();
+        hasRetiredObjects = false;
+    }
+}
+
+void MixerAudioSource::waitForAudioCallbackToFinish() const
+{
+    // The count is odd while the audio thread is inside getNextAudioBlock(), in which case it
+    // might still be using the old input list. Any callback that starts after the list was
+    // swapped will pick up the new one, so we only need to wait for the current one to end.
+    auto count = callbackCount.load();
+
+    if ((count & 1) != 0)
+        while (callbackCount.load() == count)
+            Thread::sleep (1);
+}
+
+//==============================================================================
 void MixerAudioSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
 {
     tempBuffer.setSize (2, samplesPerBlockExpected);
 
-    const ScopedLock sl (lock);
+    std::unique_ptr<InputList> oldList;
 
-    currentSampleRate = sampleRate;
-    bufferSizeExpected = samplesPerBlockExpected;
+    {
+        const ScopedLock sl (lock);
+
+        currentSampleRate = sampleRate;
+        bufferSizeExpected = samplesPerBlockExpected;
+
+        auto* currentList = activeInputs.load();
+
+        for (int i = currentList->inputs.size(); --i >= 0;)
+            currentList->inputs.getUnchecked(i)->prepareToPlay (samplesPerBlockExpected, sampleRate);
 
-    for (int i = inputs.size(); --i >= 0;)
-        inputs.getUnchecked(i)->prepareToPlay (samplesPerBlockExpected, sampleRate);
+        if (numThreadsToUse > 0)
+            oldList = updateInputList (std::unique_ptr<InputList> (new InputList (*currentList)));
+    }
+
+    retire (std::move (oldList), nullptr);
 }
 
 void MixerAudioSource::releaseResources()
 {
     const ScopedLock sl (lock);
 
-    for (int i = inputs.size(); --i >= 0;)
-        inputs.getUnchecked(i)->releaseResources();
+    auto* currentList = activeInputs.load();
+
+    for (int i = currentList->inputs.size(); --i >= 0;)
+        currentList->inputs.getUnchecked(i)->releaseResources();
 
     tempBuffer.setSize (2, 0);
 
@@ -127,25 +397,50 @@ void MixerAudioSource::releaseResources()
 
 void MixerAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
 {
-    const ScopedLock sl (lock);
+    ++callbackCount;
+    isRenderingOnThisThread = true;
+
+    if (hasRetiredObjects.load())
+        deleteRetiredObjects();
+
+    auto& currentList = *activeInputs.load();
+    auto& inputs = currentList.inputs;
 
     if (inputs.size() > 0)
     {
-        inputs.getUnchecked(0)->getNextAudioBlock (info);
+        auto* workers = activeWorkers.load();
 
-        if (inputs.size() > 1)
-        {
-            tempBuffer.setSize (jmax (1, info.buffer->getNumChannels()),
-                                info.buffer->getNumSamples());
+        // (the next time the input list changes, its buffers will be made big enough for this)
+        if (info.buffer->getNumChannels() > numChannelsToBuffer.load())
+            numChannelsToBuffer = info.buffer->getNumChannels();
 
-            AudioSourceChannelInfo info2 (&tempBuffer, 0, info.numSamples);
+        if (workers != nullptr && currentList.canRenderInParallel (info))
+        {
+            workers->render (currentList, info);
 
+            // always sum in the same order as the single-threaded version below
             for (int i = 1; i < inputs.size(); ++i)
+                for (int chan = 0; chan < info.buffer->getNumChannels(); ++chan)
+                    info.buffer->addFrom (chan, info.startSample, *currentList.buffers.getUnchecked (i), chan, 0, info.numSamples);
+        }
+        else
+        {
+            inputs.getUnchecked(0)->getNextAudioBlock (info);
+
+            if (inputs.size() > 1)
             {
-                inputs.getUnchecked(i)->getNextAudioBlock (info2);
+                tempBuffer.setSize (jmax (1, info.buffer->getNumChannels()),
+                                    info.buffer->getNumSamples());
 
-                for (int chan = 0; chan < info.buffer->getNumChannels(); ++chan)
-                    info.buffer->addFrom (chan, info.startSample, tempBuffer, chan, 0, info.numSamples);
+                AudioSourceChannelInfo info2 (&tempBuffer, 0, info.numSamples);
+
+                for (int i = 1; i < inputs.size(); ++i)
+                {
+                    inputs.getUnchecked(i)->getNextAudioBlock (info2);
+
+                    for (int chan = 0; chan < info.buffer->getNumChannels(); ++chan)
+                        info.buffer->addFrom (chan, info.startSample, tempBuffer, chan, 0, info.numSamples);
+                }
             }
         }
     }
@@ -153,6 +448,238 @@ void MixerAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
     {
         info.clearActiveBufferRegion();
     }
+
+    isRenderingOnThisThread = false;
+    ++callbackCount;
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct MixerAudioSourceTests  : public UnitTest
+{
+    MixerAudioSourceTests()  : UnitTest ("MixerAudioSource", "Audio") {}
+
+    struct CheckedSource  : public ToneGeneratorAudioSource
+    {
+        void getNextAudioBlock (const AudioSourceChannelInfo& info) override
+        {
+            if (removed)
+                usedAfterRemoval = true;
+
+            ToneGeneratorAudioSource::getNextAudioBlock (info);
+        }
+
+        std::atomic<bool> removed { false }, usedAfterRemoval { false };
+    };
+
+    // Removes itself from the mixer after a few blocks, and can change the mixer's number of threads
+    struct SelfRemovingSource  : public ToneGeneratorAudioSource
+    {
+        SelfRemovingSource (MixerAudioSource& m, std::atomic<int>& deletionCount, int threadsToSwitchTo)
+            : mixer (m), numDeleted (deletionCount), numThreads (threadsToSwitchTo)
+        {
+        }
+
+        ~SelfRemovingSource() override
+        {
+            ++numDeleted;
+        }
+
+        void getNextAudioBlock (const AudioSourceChannelInfo& info) override
+        {
+            ToneGeneratorAudioSource::getNextAudioBlock (info);
+
+            if (++numBlocks == 2 && numThreads >= 0)
+                mixer.setNumberOfThreadsToUse (numThreads);
+
+            if (numBlocks == 3)
+                mixer.removeInputSource (this);
+        }
+
+        MixerAudioSource& mixer;
+        std::atomic<int>& numDeleted;
+        const int numThreads;
+        int numBlocks = 0;
+    };
+
+    static void addTones (MixerAudioSource& mixer, int numTones)
+    {
+        for (int i = 0; i < numTones; ++i)
+        {
+            auto* tone = new ToneGeneratorAudioSource();
+            tone->setFrequency (110.0 * (i + 1));
+            tone->setAmplitude (1.0f / (float) (i + 1));
+            mixer.addInputSource (tone, true);
+        }
+    }
+
+    void runTest() override
+    {
+        const int blockSize = 256;
+
+        beginTest ("Mixing in parallel");
+        {
+            for (auto numThreads : { 1, 3, 7 })
+            {
+                MixerAudioSource serial, parallel;
+                parallel.setNumberOfThreadsToUse (numThreads);
+                expectEquals (parallel.getNumberOfThreadsToUse(), numThreads);
+
+                addTones (serial, 20);
+                addTones (parallel, 20);
+                expectEquals (parallel.getNumInputs(), 20);
+
+                serial.prepareToPlay (blockSize, 44100.0);
+                parallel.prepareToPlay (blockSize, 44100.0);
+
+                AudioBuffer<float> expected (2, blockSize), actual (2, blockSize);
+                bool allIdentical = true;
+
+                for (int block = 0; block < 50; ++block)
+                {
+                    auto start = block % 7, num = blockSize - start - (block % 5);
+
+                    expected.clear();
+                    actual.clear();
+                    serial.getNextAudioBlock ({ &expected, start, num });
+                    parallel.getNextAudioBlock ({ &actual, start, num });
+
+                    for (int chan = 0; chan < 2; ++chan)
+                        allIdentical = allIdentical && std::memcmp (expected.getReadPointer (chan), actual.getReadPointer (chan),
+                                                                    sizeof (float) * (size_t) blockSize) == 0;
+                }
+
+                expect (allIdentical);
+                expect (actual.getMagnitude (0, blockSize) > 0.5f);
+            }
+        }
+
+        beginTest ("Changing inputs while playing");
+        {
+            for (auto numThreads : { 0, 2 })
+            {
+                MixerAudioSource mixer;
+                mixer.setNumberOfThreadsToUse (numThreads);
+                addTones (mixer, 4);
+                mixer.prepareToPlay (blockSize, 44100.0);
+
+                std::atomic<bool> finished { false };
+                bool anyUsedAfterRemoval = false;
+                int numChanges = 0;
+
+                struct AudioThread  : public Thread
+                {
+                    AudioThread (MixerAudioSource& m, std::atomic<bool>& f)
+                        : Thread ("Mixer test"), mixer (m), finished (f) {}
+
+                    void run() override
+                    {
+                        AudioBuffer<float> buffer (2, 64);
+
+                        while (! finished)
+                            mixer.getNextAudioBlock (AudioSourceChannelInfo (buffer));
+                    }
+
+                    MixerAudioSource& mixer;
+                    std::atomic<bool>& finished;
+                };
+
+                AudioThread audioThread (mixer, finished);
+                audioThread.startThread();
+
+                for (auto startTime = Time::getMillisecondCounter(); Time::getMillisecondCounter() < startTime + 200;)
+                {
+                    CheckedSource source;
+                    mixer.addInputSource (&source, false);
+
+                    if (numChanges % 10 == 0)
+                        mixer.setNumberOfThreadsToUse (numThreads == 0 ? 0 : 1 + numChanges % 3);
+
+                    Thread::sleep (numChanges % 2);
+                    mixer.removeInputSource (&source);
+                    source.removed = true;
+                    Thread::sleep (numChanges % 2);
+
+                    anyUsedAfterRemoval = anyUsedAfterRemoval || source.usedAfterRemoval;
+                    ++numChanges;
+                }
+
+                finished = true;
+                audioThread.stopThread (-1);
+
+                expect (! anyUsedAfterRemoval);
+                expect (numChanges > 10);
+                expectEquals (mixer.getNumInputs(), 4);
+            }
+        }
+
+        beginTest ("Changing inputs from inside the callback");
+        {
+            for (auto numThreads : { 0, 3 })
+            {
+                MixerAudioSource mixer;
+                mixer.setNumberOfThreadsToUse (numThreads);
+                addTones (mixer, 4);
+
+                std::atomic<int> numDeleted { 0 };
+                auto newNumThreads = numThreads == 0 ? 2 : 0;
+
+                for (int i = 0; i < 6; ++i)
+                    mixer.addInputSource (new SelfRemovingSource (mixer, numDeleted, i == 0 ? newNumThreads : -1), true);
+
+                mixer.prepareToPlay (blockSize, 44100.0);
+                AudioBuffer<float> buffer (2, blockSize);
+
+                for (int block = 0; block < 10; ++block)
+                    mixer.getNextAudioBlock (AudioSourceChannelInfo (buffer));
+
+                expectEquals (mixer.getNumInputs(), 4);
+                expectEquals (numDeleted.load(), 6);
+                expectEquals (mixer.getNumberOfThreadsToUse(), newNumThreads);
+            }
+        }
+
+        beginTest ("Blocks that are bigger than expected");
+        {
+            MixerAudioSource serial, parallel;
+            parallel.setNumberOfThreadsToUse (2);
+
+            addTones (serial, 6);
+            addTones (parallel, 6);
+
+            serial.prepareToPlay (blockSize, 44100.0);
+            parallel.prepareToPlay (blockSize, 44100.0);
+
+            AudioBuffer<float> expected (6, 2 * blockSize), actual (6, 2 * blockSize);
+
+            for (int block = 0; block < 4; ++block)
+            {
+                // after the second block, the parallel buffers are re-made for six channels
+                if (block == 2)
+                {
+                    serial.prepareToPlay (blockSize, 44100.0);
+                    parallel.prepareToPlay (blockSize, 44100.0);
+                }
+
+                auto num = block % 2 == 0 ? 2 * blockSize : blockSize;
+                serial.getNextAudioBlock ({ &expected, 0, num });
+                parallel.getNextAudioBlock ({ &actual, 0, num });
+
+                bool allIdentical = true;
+
+                for (int chan = 0; chan < 6; ++chan)
+                    allIdentical = allIdentical && std::memcmp (expected.getReadPointer (chan), actual.getReadPointer (chan),
+                                                                sizeof (float) * (size_t) num) == 0;
+
+                expect (allIdentical);
+            }
+        }
+    }
+};
+
+static MixerAudioSourceTests mixerAudioSourceTests;
+
+#endif
+
 } // namespace juce
@@ -29,7 +29,12 @@ namespace juce
 
     Input sources can be added and removed while the mixer is running as long as their
     prepareToPlay() and releaseResources() methods are called before and after adding
-    them to the mixer.
+    them to the mixer. Changing the set of inputs never blocks the audio thread: the
+    mixer renders from an immutable snapshot of its input list, and any changes are
+    made to a copy which then replaces it.
+
+    The mixer can also optionally use some background threads to pull its inputs in
+    parallel - see setNumberOfThreadsToUse().
 
     @tags{Audio}
 */
@@ -60,6 +65,14 @@ public:
     /** Removes an input source.
         If the source was added by calling addInputSource() with the deleteWhenRemoved
         flag set, it will be deleted by this method.
+
+        If the audio thread is currently inside getNextAudioBlock(), this will wait for
+        it to finish before returning, so once it returns the source won't be used again.
+
+        It can also be called from inside the mixer's own getNextAudioBlock(), e.g. by an
+        input that removes itself when it has finished playing. In that case it returns
+        straight away, and the source is released and deleted at the start of the next
+        callback.
     */
     void removeInputSource (AudioSource* input);
 
@@ -69,6 +82,34 @@ public:
     */
     void removeAllInputs();
 
+    /** Returns the number of input sources that are currently being mixed. */
+    int getNumInputs() const noexcept;
+
+    //==============================================================================
+    /** Sets the number of background threads that should be used to pull the inputs.
+
+        By default this is 0, and all the inputs are rendered one after the other on
+        the thread that calls getNextAudioBlock(). If you set it to a positive number,
+        the mixer will create that many threads, and each block the inputs will be
+        shared out between them and the audio thread, each input rendering into its own
+        buffer. The results are always summed in the order that the inputs were added,
+        so the output is exactly the same as it would be without any extra threads.
+
+        Only do this if your input sources are independent of each other, as their
+        getNextAudioBlock() methods may be called concurrently.
+
+        The buffers that the inputs render into are allocated when the inputs change and
+        in prepareToPlay(), for the expected block size and the largest number of channels
+        that the mixer has been asked for so far, so that the threads never allocate. Any
+        block that doesn't fit into them is rendered on the audio thread alone.
+
+        Like removeInputSource(), this can be called from inside the audio callback.
+    */
+    void setNumberOfThreadsToUse (int numThreads);
+
+    /** Returns the number of background threads set by setNumberOfThreadsToUse(). */
+    int getNumberOfThreadsToUse() const noexcept;
+
     //==============================================================================
     /** Implementation of the AudioSource method.
         This will call prepareToPlay() on all its input sources.
@@ -86,12 +127,26 @@ public:
 
 private:
     //==============================================================================
-    Array<AudioSource*> inputs;
-    BigInteger inputsToDelete;
+    struct InputList;
+    struct WorkerPool;
+
+    std::atomic<InputList*> activeInputs { nullptr };
+    std::atomic<WorkerPool*> activeWorkers { nullptr };
+    std::atomic<uint32> callbackCount { 0 };
+    std::atomic<int> numInputs { 0 }, numChannelsToBuffer { 2 };
+    std::atomic<bool> hasRetiredObjects { false };
+    ThreadLocalValue<bool> isRenderingOnThisThread;
+    OwnedArray<InputList> retiredLists;
+    OwnedArray<WorkerPool> retiredWorkers;
     CriticalSection lock;
     AudioBuffer<float> tempBuffer;
     double currentSampleRate;
-    int bufferSizeExpected;
+    int bufferSizeExpected, numThreadsToUse = 0;
+
+    std::unique_ptr<InputList> updateInputList (std::unique_ptr<InputList>);
+    void retire (std::unique_ptr<InputList>, std::unique_ptr<WorkerPool>);
+    void deleteRetiredObjects();
+    void waitForAudioCallbackToFinish() const;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MixerAudioSource)
 };
@@ -23,12 +23,369 @@
 namespace juce
 {
 
+//==============================================================================
+struct ResamplingAudioSource::SincResampler
+{
+    explicit SincResampler (Quality quality)
+    {
+        const auto props = getDesign (quality);
+        halfLength = props.filterLength / 2;
+
+        const auto beta = 0.1102 * (props.stopbandAttenuationDecibels - 8.7);
+        const auto cutoff = 0.5 * (1.0 + props.passbandEdge);
+
+        prototype.resize ((size_t) (halfLength * tableResolution + 2));
+
+        for (int i = 0; i < halfLength * tableResolution; ++i)
+            prototype[(size_t) i] = (float) evaluateKernel (i / (double) tableResolution, cutoff, beta, halfLength);
+    }
+
+    //==============================================================================
+    // Kaiser's design rule: with the stopband starting at Nyquist, the filter length and
+    // attenuation fix how wide the transition band is, and hence where the passband ends.
+    static FilterProperties getDesign (Quality quality) noexcept
+    {
+        int length = 2;
+        double attenuation = 0;
+
+        switch (quality)
+        {
+            case Quality::sincLow:      length = 32;  attenuation = 60.0;  break;
+            case Quality::sincMedium:   length = 64;  attenuation = 90.0;  break;
+            case Quality::sincHigh:     length = 128; attenuation = 120.0; break;
+            case Quality::linear:
+            default:                    return { length, 0.0, 0.0, 0.0 };
+        }
+
+        auto transitionWidth = (attenuation - 7.95) / (2.285 * MathConstants<double>::pi * (length - 1));
+        return { length, 1.0 - transitionWidth, 0.0, attenuation };
+    }
+
+    static double besselI0 (double x) noexcept
+    {
+        double sum = 1.0, term = 1.0;
+        const auto halfX = x * 0.5;
+
+        for (int k = 1; k < 100 && term > sum * 1.0e-12; ++k)
+        {
+            term *= (halfX / k) * (halfX / k);
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    static double evaluateKernel (double x, double cutoff, double beta, int halfLength) noexcept
+    {
+        const auto u = x / halfLength;
+
+        if (std::abs (u) >= 1.0)
+            return 0.0;
+
+        const auto arg = MathConstants<double>::pi * cutoff * x;
+        const auto sinc = arg == 0.0 ? 1.0 : std::sin (arg) / arg;
+
+        return cutoff * sinc * besselI0 (beta * std::sqrt (1.0 - u * u)) / besselI0 (beta);
+    }
+
+    double measurePassbandRipple (double passbandEdge) const
+    {
+        // The kernel's spectrum is band-limited to well below 16 cycles per sample,
+        // so the table can be decimated to that rate for evaluating the response.
+        const int pointsPerSample = 16, stride = tableResolution / pointsPerSample;
+        const int numFrequencies = 256;
+        double maxDeviation = 0;
+
+        for (int i = 0; i <= numFrequencies; ++i)
+        {
+            const auto omega = MathConstants<double>::pi * passbandEdge * i / numFrequencies;
+            double response = prototype[0];
+
+            for (int n = 1; n < halfLength * pointsPerSample; ++n)
+                response += 2.0 * prototype[(size_t) (n * stride)] * std::cos (omega * n / pointsPerSample);
+
+            response /= pointsPerSample;
+            maxDeviation = jmax (maxDeviation, std::abs (Decibels::gainToDecibels (response, -300.0)));
+        }
+
+        return maxDeviation;
+    }
+
+    //==============================================================================
+    float lookupKernel (double x) const noexcept
+    {
+        const auto pos = x * tableResolution;
+        const auto index = (int) pos;
+
+        if (index >= halfLength * tableResolution)
+            return 0.0f;
+
+        const auto alpha = (float) (pos - index);
+        return prototype[(size_t) index] + alpha * (prototype[(size_t) index + 1] - prototype[(size_t) index]);
+    }
+
+    // Fills one row of taps for each of numPhasesToUse fractional positions (plus one
+    // extra row for interpolating beyond the last). Each row is padded to a multiple
+    // of 4 taps so that the dot products don't need a scalar tail.
+    // The bank's storage is reserved by prepare(), so this doesn't allocate as long as
+    // the ratio stays within the range that was prepared for.
+    void buildBank (double scale, int numPhasesToUse)
+    {
+        const auto newTapsPerSide = getTapsPerSide (scale);
+
+        if (newTapsPerSide > tapsPerSide)
+            padHistory (newTapsPerSide - tapsPerSide);
+
+        tapsPerSide = newTapsPerSide;
+        numTaps = getNumTaps (scale);
+        numPhases = numPhasesToUse;
+        bankScale = scale;
+
+        bank.resize ((size_t) ((numPhases + 1) * numTaps));
+
+        for (int p = 0; p <= numPhases; ++p)
+        {
+            auto* row = bank.data() + p * numTaps;
+            const auto phaseOffset = p / (double) numPhases;
+
+            for (int t = 0; t < numTaps; ++t)
+                row[t] = (float) scale * lookupKernel (std::abs (t - (tapsPerSide - 1) - phaseOffset) * scale);
+        }
+    }
+
+    int getTapsPerSide (double scale) const noexcept    { return (int) std::ceil (halfLength / scale); }
+    int getNumTaps (double scale) const noexcept        { return (2 * getTapsPerSide (scale) + 3) & ~3; }
+
+    // Inserts some silence before the history when the filter gets longer, so that
+    // there's always enough of it behind the read position.
+    void padHistory (int numToInsert)
+    {
+        ensureHistorySize (historyLength + numToInsert);
+
+        for (int i = 0; i < history.getNumChannels(); ++i)
+        {
+            auto* d = history.getWritePointer (i);
+            memmove (d + numToInsert, d, sizeof (float) * (size_t) historyLength);
+            FloatVectorOperations::clear (d, numToInsert);
+        }
+
+        historyLength += numToInsert;
+        readPos += numToInsert;
+    }
+
+    void ensureHistorySize (int numSamples)
+    {
+        if (numSamples > history.getNumSamples())
+            history.setSize (history.getNumChannels(), numSamples + 32, true, true, true);
+    }
+
+    static int findSmallDenominator (double ratio) noexcept
+    {
+        for (int den = 1; den <= maxExactPhases; ++den)
+        {
+            const auto num = ratio * den;
+
+            if (std::abs (num - std::round (num)) < 1.0e-9 * den)
+                return den;
+        }
+
+        return 0;
+    }
+
+    void setRatio (double newRatio)
+    {
+        currentRatio = newRatio;
+        const auto scale = newRatio > 1.0 ? 1.0 / newRatio : 1.0;
+
+        if (exactDenominator > 0)
+        {
+            fraction = exactPhase / (double) exactDenominator;
+            exactDenominator = 0;
+        }
+
+        const auto den = findSmallDenominator (newRatio);
+
+        // (an exact bank that wouldn't fit in the prepared space falls back to interpolation)
+        if (den > 0 && std::abs (fraction * den - std::round (fraction * den)) < 1.0e-9
+             && (size_t) ((den + 1) * getNumTaps (scale)) <= bank.capacity())
+        {
+            exactDenominator = den;
+            exactStep = roundToInt (newRatio * den);
+            exactPhase = roundToInt (fraction * den);
+
+            if (exactPhase >= den)
+            {
+                exactPhase -= den;
+                ++readPos;
+            }
+
+            buildBank (scale, den);
+            return;
+        }
+
+        // When downsampling at an arbitrary ratio, the cut-off is rounded down to a grid of
+        // 1/64-octave steps so that a smoothly changing ratio doesn't rebuild the bank every block.
+        const auto designScale = newRatio > 1.0 ? std::exp2 (-std::ceil (std::log2 (newRatio) * 64.0) / 64.0)
+                                                : 1.0;
+
+        if (designScale != bankScale || numPhases != numInterpolatedPhases)
+            buildBank (designScale, numInterpolatedPhases);
+    }
+
+    // Allocates enough space for any ratio up to maxPreparedRatio (or the current ratio,
+    // if that's higher), so that varying the ratio while playing doesn't allocate.
+    void prepare (int numChannels, int expectedOutputBlockSize, double ratio)
+    {
+        const auto maxRatio = jmax ((double) maxPreparedRatio, ratio);
+        const auto maxTaps = getNumTaps (1.0 / maxRatio);
+
+        bank.clear();
+        bank.reserve ((size_t) ((numInterpolatedPhases + 1) * maxTaps));
+
+        history.setSize (numChannels, 0);
+        ensureHistorySize ((int) std::ceil (expectedOutputBlockSize * maxRatio) + 2 * maxTaps);
+
+        bankScale = 0;
+        exactDenominator = 0;
+        tapsPerSide = 0;
+        historyLength = readPos = 0;
+        fraction = 0;
+        setRatio (ratio);
+        reset();
+    }
+
+    void reset()
+    {
+        history.clear();
+        historyLength = readPos = tapsPerSide - 1;
+        fraction = 0;
+        exactPhase = 0;
+    }
+
+    double getLatency() const noexcept
+    {
+        return historyLength - readPos - (exactDenominator > 0 ? exactPhase / (double) exactDenominator : fraction);
+    }
+
+    //==============================================================================
+    void process (AudioSource& input, const AudioSourceChannelInfo& info, double ratio, int numChannelsToProcess)
+    {
+        if (ratio != currentRatio)
+            setRatio (ratio);
+
+        const int numSamples = info.numSamples;
+
+        if (numSamples <= 0)
+            return;
+
+        const auto lastReadPos = exactDenominator > 0
+                                    ? readPos + (int) ((exactPhase + (int64) exactStep * (numSamples - 1)) / exactDenominator)
+                                    : readPos + (int) (fraction + ratio * (numSamples - 1)) + 1;
+
+        const auto samplesNeeded = lastReadPos - (tapsPerSide - 1) + numTaps;
+
+        if (samplesNeeded > historyLength)
+        {
+            ensureHistorySize (samplesNeeded);
+
+            AudioSourceChannelInfo readInfo (&history, historyLength, samplesNeeded - historyLength);
+            input.getNextAudioBlock (readInfo);
+            historyLength = samplesNeeded;
+        }
+
+        if (exactDenominator == 1 && exactStep == 1)
+        {
+            // at a ratio of exactly 1 the filter would only remove some of the top octave, so just pass it through
+            for (int channel = 0; channel < numChannelsToProcess; ++channel)
+                info.buffer->copyFrom (channel, info.startSample, history, channel, readPos, numSamples);
+
+            readPos += numSamples;
+        }
+        else
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const auto base = readPos - (tapsPerSide - 1);
+                jassert (base >= 0 && base + numTaps <= historyLength);
+
+                if (exactDenominator > 0)
+                {
+                    const auto* kernel = bank.data() + exactPhase * numTaps;
+
+                    for (int channel = 0; channel < numChannelsToProcess; ++channel)
+                        info.buffer->setSample (channel, info.startSample + i,
+                                                FloatVectorOperations::dotProduct (kernel, history.getReadPointer (channel, base), numTaps));
+
+                    exactPhase += exactStep;
+                    readPos += exactPhase / exactDenominator;
+                    exactPhase %= exactDenominator;
+                }
+                else
+                {
+                    const auto phase = fraction * numPhases;
+                    const auto index = (int) phase;
+                    const auto alpha = (float) (phase - index);
+                    const auto* kernel1 = bank.data() + index * numTaps;
+                    const auto* kernel2 = kernel1 + numTaps;
+
+                    for (int channel = 0; channel < numChannelsToProcess; ++channel)
+                    {
+                        const auto* src = history.getReadPointer (channel, base);
+                        const auto v1 = FloatVectorOperations::dotProduct (kernel1, src, numTaps);
+                        const auto v2 = FloatVectorOperations::dotProduct (kernel2, src, numTaps);
+
+                        info.buffer->setSample (channel, info.startSample + i, v1 + alpha * (v2 - v1));
+                    }
+
+                    fraction += ratio;
+                    const auto wholeSamples = (int) fraction;
+                    readPos += wholeSamples;
+                    fraction -= wholeSamples;
+                }
+            }
+        }
+
+        // discard the history that's no longer needed by the filter
+        const auto numToDiscard = jmin (readPos - (tapsPerSide - 1), historyLength);
+
+        if (numToDiscard > 0)
+        {
+            for (int i = 0; i < history.getNumChannels(); ++i)
+            {
+                auto* d = history.getWritePointer (i);
+                memmove (d, d + numToDiscard, sizeof (float) * (size_t) (historyLength - numToDiscard));
+            }
+
+            historyLength -= numToDiscard;
+            readPos -= numToDiscard;
+        }
+    }
+
+    //==============================================================================
+    enum
+    {
+        tableResolution = 1024,
+        numInterpolatedPhases = 256,
+        maxExactPhases = 512,
+        maxPreparedRatio = 8
+    };
+
+    int halfLength = 0;
+    std::vector<float> prototype, bank;
+    int tapsPerSide = 0, numTaps = 0, numPhases = 0;
+    double bankScale = 0, currentRatio = 0;
+
+    AudioBuffer<float> history;
+    int historyLength = 0, readPos = 0;
+    double fraction = 0;
+    int exactDenominator = 0, exactStep = 0, exactPhase = 0;
+};
+
+//==============================================================================
 ResamplingAudioSource::ResamplingAudioSource (AudioSource* const inputSource,
                                               const bool deleteInputWhenDeleted,
                                               const int channels)
     : input (inputSource, deleteInputWhenDeleted),
-      ratio (1.0),
-      lastRatio (1.0),
       bufferPos (0),
       sampsInBuffer (0),
       subSampleOffset (0),
@@ -44,27 +401,58 @@ void ResamplingAudioSource::setResamplingRatio (const double samplesInPerOutputS
 {
     jassert (samplesInPerOutputSample > 0);
 
-    const SpinLock::ScopedLockType sl (ratioLock);
     ratio = jmax (0.0, samplesInPerOutputSample);
 }
 
+void ResamplingAudioSource::setQuality (Quality newQuality)
+{
+    quality = newQuality;
+}
+
+ResamplingAudioSource::FilterProperties ResamplingAudioSource::getFilterProperties (Quality q)
+{
+    auto props = SincResampler::getDesign (q);
+
+    if (q != Quality::linear)
+        props.passbandRippleDecibels = SincResampler (q).measurePassbandRipple (props.passbandEdge);
+
+    return props;
+}
+
 void ResamplingAudioSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
 {
-    const SpinLock::ScopedLockType sl (ratioLock);
+    const double localRatio = ratio;
 
-    auto scaledBlockSize = roundToInt (samplesPerBlockExpected * ratio);
-    input->prepareToPlay (scaledBlockSize, sampleRate * ratio);
+    auto scaledBlockSize = roundToInt (samplesPerBlockExpected * localRatio);
+    input->prepareToPlay (scaledBlockSize, sampleRate * localRatio);
 
     buffer.setSize (numChannels, scaledBlockSize + 32);
 
     filterStates.calloc (numChannels);
     srcBuffers.calloc (numChannels);
     destBuffers.calloc (numChannels);
-    createLowPass (ratio);
+    createLowPass (localRatio);
+    lastRatio = localRatio;
+
+    expectedBlockSize = samplesPerBlockExpected;
+    currentQuality = quality;
+    prepareSincResampler (localRatio);
 
     flushBuffers();
 }
 
+void ResamplingAudioSource::prepareSincResampler (double currentRatio)
+{
+    if (currentQuality == Quality::linear)
+    {
+        sincResampler.reset();
+        return;
+    }
+
+    sincResampler.reset (new SincResampler (currentQuality));
+    sincResampler->prepare (numChannels, expectedBlockSize, currentRatio);
+}
+
 void ResamplingAudioSource::flushBuffers()
 {
     buffer.clear();
@@ -72,21 +460,37 @@ void ResamplingAudioSource::flushBuffers()
     sampsInBuffer = 0;
     subSampleOffset = 0.0;
     resetFilters();
+
+    if (sincResampler != nullptr)
+        sincResampler->reset();
+
+    latency = 0.0;
 }
 
 void ResamplingAudioSource::releaseResources()
 {
     input->releaseResources();
     buffer.setSize (numChannels, 0);
+    sincResampler.reset();
 }
 
 void ResamplingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
 {
-    double localRatio;
+    const double localRatio = ratio;
+    const auto localQuality = quality.load();
 
+    if (localQuality != currentQuality)
     {
-        const SpinLock::ScopedLockType sl (ratioLock);
-        localRatio = ratio;
+        currentQuality = localQuality;
+        prepareSincResampler (localRatio);
+        flushBuffers();
+    }
+
+    if (sincResampler != nullptr)
+    {
+        sincResampler->process (*input, info, localRatio, jmin (numChannels, info.buffer->getNumChannels()));
+        latency = sincResampler->getLatency();
+        return;
     }
 
     if (lastRatio != localRatio)
@@ -194,6 +598,7 @@ void ResamplingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& inf
     }
 
     jassert (sampsInBuffer >= 0);
+    latency = sampsInBuffer - subSampleOffset;
 }
 
 void ResamplingAudioSource::createLowPass (const double frequencyRatio)
@@ -263,4 +668,100 @@ void ResamplingAudioSource::applyFilter (float* samples, int num, FilterState& f
     }
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct ResamplingAudioSourceTests  : public UnitTest
+{
+    ResamplingAudioSourceTests()  : UnitTest ("ResamplingAudioSource", "Audio") {}
+
+    // A low sine wave, whose value is known at any point, so the ideal output of a
+    // resampler can be calculated directly
+    struct SineSource  : public AudioSource
+    {
+        static float getValue (double time, int channel) noexcept
+        {
+            return (float) (0.5 * std::sin (0.2 * time + channel));
+        }
+
+        void prepareToPlay (int, double) override {}
+        void releaseResources() override {}
+
+        void getNextAudioBlock (const AudioSourceChannelInfo& info) override
+        {
+            for (int i = 0; i < info.numSamples; ++i)
+            {
+                for (int channel = 0; channel < info.buffer->getNumChannels(); ++channel)
+                    info.buffer->setSample (channel, info.startSample + i, getValue ((double) position, channel));
+
+                ++position;
+            }
+        }
+
+        int64 position = 0;
+    };
+
+    // Resamples the sine and returns the largest difference from the ideal output, ignoring
+    // the start, where the filter is still reading the silence from before the input began
+    float measureError (ResamplingAudioSource::Quality quality, const std::function<double (int)>& getRatioForBlock)
+    {
+        const int numChannels = 2, blockSize = 128, numBlocks = 100;
+        SineSource sine;
+        ResamplingAudioSource resampler (&sine, false, numChannels);
+        resampler.setQuality (quality);
+        resampler.setResamplingRatio (getRatioForBlock (0));
+        resampler.prepareToPlay (blockSize, 44100.0);
+
+        AudioBuffer<float> output (numChannels, blockSize);
+        double inputTime = 0;
+        float maxError = 0;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            auto ratio = getRatioForBlock (block);
+            resampler.setResamplingRatio (ratio);
+            resampler.getNextAudioBlock (AudioSourceChannelInfo (output));
+
+            for (int i = 0; i < blockSize; ++i)
+            {
+                if (inputTime > 1000.0)
+                    for (int channel = 0; channel < numChannels; ++channel)
+                        maxError = jmax (maxError, std::abs (output.getSample (channel, i) - SineSource::getValue (inputTime, channel)));
+
+                inputTime += ratio;
+            }
+        }
+
+        return maxError;
+    }
+
+    void runTest() override
+    {
+        using Quality = ResamplingAudioSource::Quality;
+
+        struct Mode  { Quality quality; float tolerance; };
+        const Mode modes[] = { { Quality::sincLow,    2.0e-3f },
+                               { Quality::sincMedium, 1.0e-4f },
+                               { Quality::sincHigh,   2.0e-5f } };
+
+        beginTest ("Fixed ratios");
+        {
+            for (auto& mode : modes)
+                for (auto ratio : { 0.5, 147.0 / 160.0, 160.0 / 147.0, 2.0, 0.7071, 1.2345, 3.3 })
+                    expectLessThan (measureError (mode.quality, [ratio] (int) { return ratio; }), mode.tolerance);
+        }
+
+        beginTest ("Varying ratio");
+        {
+            for (auto& mode : modes)
+                expectLessThan (measureError (mode.quality, [] (int block) { return 1.0 + 0.6 * std::sin (block * 0.1); }),
+                                mode.tolerance);
+        }
+    }
+};
+
+static ResamplingAudioSourceTests resamplingAudioSourceTests;
+
+#endif
+
 } // namespace juce
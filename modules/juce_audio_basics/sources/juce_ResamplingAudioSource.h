@@ -27,6 +27,11 @@ namespace juce
 /**
     A type of AudioSource that takes an input source and changes its sample rate.
 
+    By default this uses a cheap linear interpolation with a 2nd-order anti-aliasing
+    filter, which is fine for realtime playback. For offline rendering or sample-rate
+    conversion where quality matters more than CPU, setQuality() can select one of the
+    windowed-sinc modes instead.
+
     @see AudioSource, LagrangeInterpolator, CatmullRomInterpolator
 
     @tags{Audio}
@@ -68,6 +73,71 @@ public:
     /** Clears any buffers and filters that the resampler is using. */
     void flushBuffers();
 
+    //==============================================================================
+    /** The algorithms that can be used for resampling. */
+    enum class Quality
+    {
+        linear,       /**< Linear interpolation with a 2nd-order IIR anti-aliasing filter. */
+        sincLow,      /**< A 32-tap polyphase Kaiser-windowed sinc, with 60dB of stopband attenuation. */
+        sincMedium,   /**< A 64-tap polyphase Kaiser-windowed sinc, with 90dB of stopband attenuation. */
+        sincHigh      /**< A 128-tap polyphase Kaiser-windowed sinc, with 120dB of stopband attenuation. */
+    };
+
+    /** Selects the resampling algorithm to use.
+
+        The sinc modes are linear-phase and are compensated so that their output stays
+        time-aligned with the input. When the ratio is an exact fraction with a small
+        denominator (e.g. 2:1 or 44100:48000) and it's held constant, they use a
+        dedicated set of filter phases and an integer position, so there's no phase
+        interpolation and no drift. Other ratios, including ones that change from block
+        to block for varispeed effects, interpolate between 256 precomputed phases.
+
+        prepareToPlay() allocates everything the sinc modes need for ratios of up to 8:1
+        (or the current ratio, if that's higher), so the ratio can be varied within that
+        range while playing without allocating any memory on the audio thread.
+
+        This is best called before prepareToPlay(). Changing it while the source is
+        playing will reset the resampler's state and allocate memory on the audio thread.
+    */
+    void setQuality (Quality newQuality);
+
+    /** Returns the algorithm that was selected with setQuality(). */
+    Quality getQuality() const noexcept                         { return quality; }
+
+    /** Describes the anti-aliasing filter used by one of the quality settings.
+        @see getFilterProperties
+    */
+    struct FilterProperties
+    {
+        /** The number of input samples that contribute to each output sample, when not downsampling. */
+        int filterLength;
+
+        /** The upper edge of the passband, as a proportion of the lower of the input and output Nyquist frequencies. */
+        double passbandEdge;
+
+        /** The largest deviation from unity gain within the passband, in decibels. */
+        double passbandRippleDecibels;
+
+        /** The attenuation that the filter was designed to provide at and above the Nyquist frequency, in decibels. */
+        double stopbandAttenuationDecibels;
+    };
+
+    /** Returns the properties of the filter used by one of the sinc quality settings.
+        The passband ripple is measured from the actual filter kernel, so this isn't a
+        particularly cheap call. For Quality::linear, everything other than the
+        filter length is zero, as its IIR filter isn't designed to these criteria.
+    */
+    static FilterProperties getFilterProperties (Quality);
+
+    /** Returns how far ahead of the output the input source has been read, in input samples.
+
+        A PositionableAudioSource feeding this object will report a read position that's
+        this much further on than the audio that has actually been played. For the sinc
+        modes this includes the half-length of the filter. It's updated after each call
+        to getNextAudioBlock(), and can be called from any thread.
+    */
+    double getLatencyInInputSamples() const noexcept            { return latency; }
+
     //==============================================================================
     void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override;
     void releaseResources() override;
@@ -76,16 +146,24 @@ public:
 private:
     //==============================================================================
     OptionalScopedPointer<AudioSource> input;
-    double ratio, lastRatio;
+    std::atomic<double> ratio { 1.0 }, latency { 0.0 };
+    double lastRatio = 1.0;
+    std::atomic<Quality> quality { Quality::linear };
+    Quality currentQuality = Quality::linear;
     AudioBuffer<float> buffer;
     int bufferPos, sampsInBuffer;
     double subSampleOffset;
     double coefficients[6];
-    SpinLock ratioLock;
     const int numChannels;
+    int expectedBlockSize = 0;
     HeapBlock<float*> destBuffers;
     HeapBlock<const float*> srcBuffers;
 
+    struct SincResampler;
+    std::unique_ptr<SincResampler> sincResampler;
+
+    void prepareSincResampler (double currentRatio);
+
     void setFilterCoefficients (double c1, double c2, double c3, double c4, double c5, double c6);
     void createLowPass (double proportionalRate);
 
@@ -30,6 +30,12 @@ namespace juce
     To use it, call setSampleRate() with the current sample rate and give it some parameters
     with setParameters() then call getNextSample() to get the envelope value to be applied
     to each audio sample or applyEnvelopeToBuffer() to apply the envelope to a whole buffer.
+
+    The segments of the envelope can either be straight lines, or exponential curves which
+    sound more like the envelope of an analogue synth. Either way, getNextBlock() and
+    applyEnvelopeToBuffer() work out each segment in closed form rather than stepping the
+    state machine for every sample, so they're much cheaper than calling getNextSample()
+    in a loop.
 */
 class ADSR
 {
@@ -42,6 +48,13 @@ public:
     }
 
     //==============================================================================
+    /** The shapes that can be used for the attack, decay and release segments. */
+    enum class Curve
+    {
+        linear,
+        exponential
+    };
+
     /** Holds the parameters being used by an ADSR object. */
     struct Parameters
     {
@@ -56,6 +69,9 @@ public:
 
         /** Release time in seconds. */
         float release = 0.1f;
+
+        /** The shape of the attack, decay and release segments. */
+        Curve curve = Curve::linear;
     };
 
     /** Sets the parameters that will be used by an ADSR object.
@@ -124,7 +140,7 @@ public:
     //==============================================================================
     /** Returns the next sample value for an ADSR object.
 
-        @see applyEnvelopeToBuffer
+        @see getNextBlock, applyEnvelopeToBuffer
     */
     float getNextSample()
     {
@@ -133,7 +149,8 @@ public:
 
         if (currentState == State::attack)
         {
-            envelopeVal += attackRate;
+            envelopeVal = isExponential ? attackTarget + (envelopeVal - attackTarget) * attackCoeff
+                                        : envelopeVal + attackRate;
 
             if (envelopeVal >= 1.0f)
             {
@@ -147,7 +164,8 @@ public:
         }
         else if (currentState == State::decay)
         {
-            envelopeVal -= decayRate;
+            envelopeVal = isExponential ? decayTarget + (envelopeVal - decayTarget) * decayCoeff
+                                        : envelopeVal - decayRate;
 
             if (envelopeVal <= sustainLevel)
             {
@@ -161,7 +179,8 @@ public:
         }
         else if (currentState == State::release)
         {
-            envelopeVal -= releaseRate;
+            envelopeVal = isExponential ? releaseTarget + (envelopeVal - releaseTarget) * releaseCoeff
+                                        : envelopeVal - releaseRate;
 
             if (envelopeVal <= 0.0f)
                 reset();
@@ -170,10 +189,32 @@ public:
         return envelopeVal;
     }
 
+    /** Writes the next numSamples envelope values into an array.
+
+        This produces the same values as calling getNextSample() numSamples times (to
+        within floating-point rounding), but each segment of the envelope is calculated
+        in one go.
+
+        @see getNextSample, applyEnvelopeToBuffer
+    */
+    template <typename FloatType>
+    void getNextBlock (FloatType* destination, int numSamples)
+    {
+        while (numSamples > 0)
+        {
+            auto numDone = renderSegment (destination, numSamples);
+            destination += numDone;
+            numSamples -= numDone;
+        }
+    }
+
     /** This method will conveniently apply the next numSamples number of envelope values
         to an AudioBuffer.
 
-        @see getNextSample
+        The envelope is rendered a chunk at a time with getNextBlock(), and then each
+        channel is multiplied by it in one go.
+
+        @see getNextSample, getNextBlock
     */
     template<typename FloatType>
     void applyEnvelopeToBuffer (AudioBuffer<FloatType>& buffer, int startSample, int numSamples)
@@ -181,15 +222,24 @@ public:
         jassert (startSample + numSamples <= buffer.getNumSamples());
 
         auto numChannels = buffer.getNumChannels();
+        FloatType envelope[256];
 
-        while (--numSamples >= 0)
+        while (numSamples > 0)
         {
-            auto env = getNextSample();
+            if (currentState == State::sustain || currentState == State::idle)
+            {
+                envelopeVal = currentState == State::sustain ? sustainLevel : 0.0f;
+                buffer.applyGain (startSample, numSamples, (FloatType) envelopeVal);
+                return;
+            }
+
+            auto numThisTime = renderSegment (envelope, jmin (numSamples, (int) numElementsInArray (envelope)));
 
             for (int i = 0; i < numChannels; ++i)
-                buffer.getWritePointer (i)[startSample] *= env;
+                FloatVectorOperations::multiply (buffer.getWritePointer (i, startSample), envelope, numThisTime);
 
-            ++startSample;
+            startSample += numThisTime;
+            numSamples -= numThisTime;
         }
     }
 
@@ -203,6 +253,108 @@ private:
         attackRate  = (parameters.attack  > 0.0f ? static_cast<float> (1.0f                  / (parameters.attack * sr))  : -1.0f);
         decayRate   = (parameters.decay   > 0.0f ? static_cast<float> ((1.0f - sustainLevel) / (parameters.decay * sr))   : -1.0f);
         releaseRate = (parameters.release > 0.0f ? static_cast<float> (sustainLevel          / (parameters.release * sr)) : -1.0f);
+
+        // The exponential segments head towards a target just beyond the level at which
+        // they end, so that they get there in the given time rather than asymptotically.
+        isExponential = (parameters.curve == Curve::exponential);
+
+        const float attackOvershoot = 0.3f, decayOvershoot = 0.001f;
+
+        attackCoeff  = getCoefficient (parameters.attack,  attackOvershoot);
+        decayCoeff   = getCoefficient (parameters.decay,   decayOvershoot);
+        releaseCoeff = getCoefficient (parameters.release, decayOvershoot);
+
+        attackTarget  = 1.0f + attackOvershoot;
+        decayTarget   = sustainLevel - decayOvershoot * (1.0f - sustainLevel);
+        releaseTarget = -decayOvershoot * sustainLevel;
+    }
+
+    float getCoefficient (float seconds, float overshoot) const
+    {
+        return seconds > 0.0f ? static_cast<float> (std::exp (-std::log ((1.0 + overshoot) / overshoot) / (seconds * sr)))
+                              : 0.0f;
+    }
+
+    /*  Returns the number of steps that a segment starting at envelopeVal will take to reach
+        endValue, limited to maxSteps + 1. If it's already past the end, it takes one step.
+    */
+    int getNumStepsToEnd (float endValue, float rate, float target, float coeff, int maxSteps) const
+    {
+        double numSteps = 0.0;
+
+        if (isExponential)
+        {
+            auto remaining = (endValue - target) / (double) (envelopeVal - target);
+
+            if (remaining > 0.0 && remaining < 1.0)
+                numSteps = std::log (remaining) / std::log ((double) coeff);
+        }
+        else if (rate != 0.0f)
+        {
+            numSteps = (endValue - envelopeVal) / (double) rate;
+        }
+        else
+        {
+            numSteps = maxSteps + 1.0;
+        }
+
+        return jlimit (1, maxSteps + 1, (int) jmin ((double) maxSteps + 1.0, std::ceil (numSteps)));
+    }
+
+    template <typename FloatType>
+    int renderSegment (FloatType* destination, int numSamples)
+    {
+        if (currentState == State::idle || currentState == State::sustain)
+        {
+            envelopeVal = currentState == State::sustain ? sustainLevel : 0.0f;
+            FloatVectorOperations::fill (destination, (FloatType) envelopeVal, numSamples);
+            return numSamples;
+        }
+
+        float endValue, rate, target, coeff;
+
+        if (currentState == State::attack)        { endValue = 1.0f;         rate = attackRate;   target = attackTarget;  coeff = attackCoeff; }
+        else if (currentState == State::decay)    { endValue = sustainLevel; rate = -decayRate;   target = decayTarget;   coeff = decayCoeff; }
+        else                                      { endValue = 0.0f;         rate = -releaseRate; target = releaseTarget; coeff = releaseCoeff; }
+
+        auto numSteps = getNumStepsToEnd (endValue, rate, target, coeff, numSamples);
+        auto numToRender = jmin (numSteps, numSamples);
+        auto start = envelopeVal;
+
+        if (isExponential)
+        {
+            auto value = start;
+
+            for (int i = 0; i < numToRender; ++i)
+            {
+                value = target + (value - target) * coeff;
+                destination[i] = (FloatType) value;
+            }
+        }
+        else
+        {
+            for (int i = 0; i < numToRender; ++i)
+                destination[i] = (FloatType) (start + rate * (float) (i + 1));
+        }
+
+        if (numToRender < numSteps)
+        {
+            envelopeVal = (float) destination[numToRender - 1];
+            return numToRender;
+        }
+
+        // this segment has finished, so move on to the next one
+        destination[numToRender - 1] = (FloatType) endValue;
+        envelopeVal = endValue;
+
+        if (currentState == State::attack)
+            currentState = decayRate > 0.0f ? State::decay : State::sustain;
+        else if (currentState == State::decay)
+            currentState = State::sustain;
+        else
+            reset();
+
+        return numToRender;
     }
 
     //==============================================================================
@@ -217,6 +369,10 @@ private:
 
     float sustainLevel = 0.0f;
     float attackRate = 0.0f, decayRate = 0.0f, releaseRate = 0.0f;
+
+    bool isExponential = false;
+    float attackCoeff = 0.0f, decayCoeff = 0.0f, releaseCoeff = 0.0f;
+    float attackTarget = 0.0f, decayTarget = 0.0f, releaseTarget = 0.0f;
 };
 
 } // namespace juce
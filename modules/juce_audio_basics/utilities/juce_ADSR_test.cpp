@@ -0,0 +1,213 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+class ADSRTests  : public UnitTest
+{
+public:
+    ADSRTests()  : UnitTest ("ADSR", "Audio") {}
+
+    static ADSR::Parameters makeParameters (float attack, float decay, float sustain, float release, ADSR::Curve curve)
+    {
+        ADSR::Parameters p;
+        p.attack = attack;
+        p.decay = decay;
+        p.sustain = sustain;
+        p.release = release;
+        p.curve = curve;
+        return p;
+    }
+
+    // Renders a note with getNextSample() and getNextBlock() and checks that they match
+    void checkBlockMatchesPerSample (const ADSR::Parameters& parameters, Random& r)
+    {
+        ADSR perSample, block;
+
+        for (auto* adsr : { &perSample, &block })
+        {
+            adsr->setSampleRate (44100.0);
+            adsr->setParameters (parameters);
+            adsr->noteOn();
+        }
+
+        HeapBlock<float> expected (30000), actual (30000);
+        int numSamples = 0;
+
+        auto render = [&] (int numToRender)
+        {
+            for (int i = 0; i < numToRender; ++i)
+                expected[numSamples + i] = perSample.getNextSample();
+
+            while (numToRender > 0)
+            {
+                auto num = jmin (numToRender, 1 + r.nextInt (700));
+                block.getNextBlock (actual + numSamples, num);
+                numSamples += num;
+                numToRender -= num;
+            }
+        };
+
+        render (9000);
+
+        perSample.noteOff();
+        block.noteOff();
+        render (20000);
+
+        // The closed-form segments can finish a sample away from where the accumulated
+        // per-sample values do, so allow for that at any jumps between segments
+        float maxError = 0;
+
+        for (int i = 1; i < numSamples - 1; ++i)
+            maxError = jmax (maxError, jmin (std::abs (expected[i] - actual[i]),
+                                              std::abs (expected[i] - actual[i - 1]),
+                                              std::abs (expected[i] - actual[i + 1])));
+
+        expectLessThan (maxError, 2.0e-3f);
+        expect (! perSample.isActive());
+        expect (! block.isActive());
+    }
+
+    void runTest() override
+    {
+        auto r = getRandom();
+
+        for (auto curve : { ADSR::Curve::linear, ADSR::Curve::exponential })
+        {
+            beginTest (curve == ADSR::Curve::linear ? "Linear block rendering matches per-sample rendering"
+                                                    : "Exponential block rendering matches per-sample rendering");
+            {
+                checkBlockMatchesPerSample (makeParameters (0.05f, 0.05f, 0.5f, 0.1f, curve), r);
+                checkBlockMatchesPerSample (makeParameters (0.0f, 0.05f, 0.5f, 0.1f, curve), r);
+                checkBlockMatchesPerSample (makeParameters (0.05f, 0.0f, 0.7f, 0.1f, curve), r);
+                checkBlockMatchesPerSample (makeParameters (0.05f, 0.1f, 1.0f, 0.1f, curve), r);
+                checkBlockMatchesPerSample (makeParameters (0.3f, 0.1f, 0.5f, 0.2f, curve), r);
+                checkBlockMatchesPerSample (makeParameters (0.001f, 0.001f, 0.25f, 0.001f, curve), r);
+            }
+        }
+
+        beginTest ("Linear segments");
+        {
+            ADSR adsr;
+            adsr.setSampleRate (1000.0);
+            adsr.setParameters (makeParameters (0.01f, 0.01f, 0.5f, 0.01f, ADSR::Curve::linear));
+            adsr.noteOn();
+
+            float values[40];
+            adsr.getNextBlock (values, 30);
+
+            for (int i = 0; i < 10; ++i)
+                expectWithinAbsoluteError (values[i], (float) (i + 1) * 0.1f, 1.0e-6f);
+
+            for (int i = 10; i < 20; ++i)
+                expectWithinAbsoluteError (values[i], 1.0f - (float) (i - 9) * 0.05f, 1.0e-6f);
+
+            for (int i = 20; i < 30; ++i)
+                expectEquals (values[i], 0.5f);
+
+            adsr.noteOff();
+            adsr.getNextBlock (values, 12);
+
+            for (int i = 0; i < 10; ++i)
+                expectWithinAbsoluteError (values[i], 0.5f - (float) (i + 1) * 0.05f, 1.0e-6f);
+
+            expectEquals (values[10], 0.0f);
+            expect (! adsr.isActive());
+        }
+
+        beginTest ("Exponential segments take the right time");
+        {
+            ADSR adsr;
+            adsr.setSampleRate (1000.0);
+            adsr.setParameters (makeParameters (0.1f, 0.1f, 0.5f, 0.2f, ADSR::Curve::exponential));
+            adsr.noteOn();
+
+            float values[400];
+            adsr.getNextBlock (values, 300);
+
+            // the attack is concave and the decay and release are convex
+            expectGreaterThan (values[49], 0.5f);
+            expectLessThan (values[97], 1.0f);
+            expectWithinAbsoluteError (values[99], 1.0f, 1.0e-4f);
+            expectLessThan (values[149], 0.75f);
+            expectGreaterThan (values[197], 0.5f);
+            expectWithinAbsoluteError (values[199], 0.5f, 1.0e-4f);
+            expectEquals (values[201], 0.5f);
+            expectEquals (values[299], 0.5f);
+
+            adsr.noteOff();
+            adsr.getNextBlock (values, 400);
+
+            expectLessThan (values[99], 0.25f);
+            expectGreaterThan (values[197], 0.0f);
+            expectWithinAbsoluteError (values[199], 0.0f, 1.0e-4f);
+            expectEquals (values[201], 0.0f);
+            expect (! adsr.isActive());
+        }
+
+        beginTest ("Applying the envelope to a buffer");
+        {
+            for (auto curve : { ADSR::Curve::linear, ADSR::Curve::exponential })
+            {
+                ADSR reference, adsr;
+
+                for (auto* a : { &reference, &adsr })
+                {
+                    a->setSampleRate (44100.0);
+                    a->setParameters (makeParameters (0.01f, 0.02f, 0.6f, 0.01f, curve));
+                    a->noteOn();
+                }
+
+                AudioBuffer<double> buffer (3, 5000);
+
+                for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                    for (int i = 0; i < buffer.getNumSamples(); ++i)
+                        buffer.setSample (ch, i, 1.0 + ch);
+
+                adsr.applyEnvelopeToBuffer (buffer, 0, 3000);
+                adsr.noteOff();
+                adsr.applyEnvelopeToBuffer (buffer, 3000, 2000);
+
+                float maxError = 0;
+
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                {
+                    if (i == 3000)
+                        reference.noteOff();
+
+                    auto env = reference.getNextSample();
+
+                    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                        maxError = jmax (maxError, (float) std::abs (buffer.getSample (ch, i) - env * (1.0 + ch)));
+                }
+
+                expectLessThan (maxError, 5.0e-3f);
+                expect (! adsr.isActive());
+            }
+        }
+    }
+};
+
+static ADSRTests adsrTests;
+
+} // namespace juce
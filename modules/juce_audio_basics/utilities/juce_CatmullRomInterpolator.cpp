@@ -39,6 +39,17 @@ struct CatmullRomAlgorithm
                                 + (offset * (((y0 + 2.0f * y2) - (halfY3 + 2.5f * y1))
                                               + (offset * ((halfY3 + 1.5f * y1) - (halfY0 + 1.5f * y2))))));
     }
+
+    // The weights to apply to the last five input samples (oldest first) to get the
+    // value at a given offset, as used by MultichannelInterpolator.
+    static forcedinline void calcCoefficients (float offset, float* c) noexcept
+    {
+        c[0] = 0.0f;
+        c[1] = offset * (-0.5f + offset * (1.0f - 0.5f * offset));
+        c[2] = 1.0f + offset * offset * (-2.5f + 1.5f * offset);
+        c[3] = offset * (0.5f + offset * (2.0f - 1.5f * offset));
+        c[4] = offset * offset * (-0.5f + 0.5f * offset);
+    }
 };
 
 CatmullRomInterpolator::CatmullRomInterpolator() noexcept  { reset(); }
@@ -30,9 +30,10 @@ namespace juce
     of the input stream you're feeding it, you should call reset() before feeding
     it any new data. And like with any other stateful filter, if you're resampling
     multiple channels, make sure each one uses its own CatmullRomInterpolator
-    object.
+    object - or use a MultichannelInterpolator, which processes all the channels of
+    a block in one pass.
 
-    @see LagrangeInterpolator
+    @see MultichannelInterpolator, LagrangeInterpolator
 
     @tags{Audio}
 */
@@ -333,4 +333,404 @@ void IIRFilter::processSamples (float* const samples, const int numSamples) noex
     }
 }
 
+//==============================================================================
+namespace IIRCascadeHelpers
+{
+    // The channels are processed in groups of four, one channel per lane. Each
+    // section's coefficients are stored with every value repeated in all four lanes,
+    // and the state of a section in a group is its four v1 values then its four v2s.
+    enum
+    {
+        numLanes = 4,
+        valuesPerSection = 5 * numLanes,
+        statePerSection = 2 * numLanes,
+        blockSize = 256
+    };
+
+   #if JUCE_USE_SSE_INTRINSICS
+    using Lanes = __m128;
+    static forcedinline Lanes load (const float* src) noexcept                { return _mm_loadu_ps (src); }
+    static forcedinline void store (float* dest, Lanes a) noexcept            { _mm_storeu_ps (dest, a); }
+    static forcedinline Lanes add (Lanes a, Lanes b) noexcept                 { return _mm_add_ps (a, b); }
+    static forcedinline Lanes sub (Lanes a, Lanes b) noexcept                 { return _mm_sub_ps (a, b); }
+    static forcedinline Lanes mul (Lanes a, Lanes b) noexcept                 { return _mm_mul_ps (a, b); }
+   #elif JUCE_USE_ARM_NEON
+    using Lanes = float32x4_t;
+    static forcedinline Lanes load (const float* src) noexcept                { return vld1q_f32 (src); }
+    static forcedinline void store (float* dest, Lanes a) noexcept            { vst1q_f32 (dest, a); }
+    static forcedinline Lanes add (Lanes a, Lanes b) noexcept                 { return vaddq_f32 (a, b); }
+    static forcedinline Lanes sub (Lanes a, Lanes b) noexcept                 { return vsubq_f32 (a, b); }
+    static forcedinline Lanes mul (Lanes a, Lanes b) noexcept                 { return vmulq_f32 (a, b); }
+   #else
+    struct Lanes  { float v[numLanes]; };
+
+    static forcedinline Lanes load (const float* src) noexcept                { Lanes r; for (int i = 0; i < numLanes; ++i) r.v[i] = src[i]; return r; }
+    static forcedinline void store (float* dest, Lanes a) noexcept            { for (int i = 0; i < numLanes; ++i) dest[i] = a.v[i]; }
+    static forcedinline Lanes add (Lanes a, Lanes b) noexcept                 { for (int i = 0; i < numLanes; ++i) a.v[i] += b.v[i]; return a; }
+    static forcedinline Lanes sub (Lanes a, Lanes b) noexcept                 { for (int i = 0; i < numLanes; ++i) a.v[i] -= b.v[i]; return a; }
+    static forcedinline Lanes mul (Lanes a, Lanes b) noexcept                 { for (int i = 0; i < numLanes; ++i) a.v[i] *= b.v[i]; return a; }
+   #endif
+
+    // Runs one section over a block of interleaved samples from a group of channels
+    static void processSection (float* interleaved, int numSamples, const float* coeffs, float* sectionState) noexcept
+    {
+        auto c0 = load (coeffs);
+        auto c1 = load (coeffs + numLanes);
+        auto c2 = load (coeffs + numLanes * 2);
+        auto c3 = load (coeffs + numLanes * 3);
+        auto c4 = load (coeffs + numLanes * 4);
+        auto v1 = load (sectionState);
+        auto v2 = load (sectionState + numLanes);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto* samples = interleaved + i * numLanes;
+            auto in = load (samples);
+            auto out = add (mul (c0, in), v1);
+            store (samples, out);
+
+            v1 = add (sub (mul (c1, in), mul (c3, out)), v2);
+            v2 = sub (mul (c2, in), mul (c4, out));
+        }
+
+        store (sectionState, v1);
+        store (sectionState + numLanes, v2);
+    }
+}
+
+IIRFilterCascade::IIRFilterCascade (int numChannelsToUse, int maxSections)
+    : numChannels (numChannelsToUse), maxNumSections (maxSections)
+{
+    jassert (numChannels > 0 && maxNumSections >= 0);
+
+    auto numGroups = (numChannels + IIRCascadeHelpers::numLanes - 1) / IIRCascadeHelpers::numLanes;
+
+    activeCoefficients.values.calloc ((size_t) (maxNumSections * IIRCascadeHelpers::valuesPerSection));
+    pendingCoefficients.values.calloc ((size_t) (maxNumSections * IIRCascadeHelpers::valuesPerSection));
+    state.calloc ((size_t) (numGroups * maxNumSections * IIRCascadeHelpers::statePerSection));
+    channelPointers.calloc ((size_t) numChannels);
+}
+
+IIRFilterCascade::~IIRFilterCascade() noexcept
+{
+}
+
+//==============================================================================
+void IIRFilterCascade::setCoefficients (const IIRCoefficients* sectionCoefficients, int numSections) noexcept
+{
+    // the cascade can't hold this many sections!
+    jassert (isPositiveAndNotGreaterThan (numSections, maxNumSections));
+    numSections = jlimit (0, maxNumSections, numSections);
+
+    const SpinLock::ScopedLockType sl (pendingLock);
+
+    for (int section = 0; section < numSections; ++section)
+    {
+        auto* dest = pendingCoefficients.values + section * IIRCascadeHelpers::valuesPerSection;
+
+        for (int i = 0; i < 5; ++i)
+            for (int lane = 0; lane < IIRCascadeHelpers::numLanes; ++lane)
+                *dest++ = sectionCoefficients[section].coefficients[i];
+    }
+
+    pendingCoefficients.numSections = numSections;
+    hasPendingCoefficients = true;
+}
+
+void IIRFilterCascade::setCoefficients (const Array<IIRCoefficients>& sectionCoefficients) noexcept
+{
+    setCoefficients (sectionCoefficients.begin(), sectionCoefficients.size());
+}
+
+void IIRFilterCascade::reset() noexcept
+{
+    shouldReset = true;
+}
+
+void IIRFilterCascade::updateCoefficientsIfNeeded() noexcept
+{
+    if (hasPendingCoefficients.load())
+    {
+        const GenericScopedTryLock<SpinLock> tl (pendingLock);
+
+        if (tl.isLocked())
+        {
+            auto oldNumSections = activeCoefficients.numSections;
+
+            std::swap (activeCoefficients.values, pendingCoefficients.values);
+            activeCoefficients.numSections = pendingCoefficients.numSections;
+            hasPendingCoefficients = false;
+
+            // sections that were switched off have been left holding their old state
+            if (activeCoefficients.numSections > oldNumSections)
+                clearState (oldNumSections, activeCoefficients.numSections - oldNumSections);
+        }
+    }
+
+    if (shouldReset.exchange (false))
+        clearState (0, maxNumSections);
+}
+
+void IIRFilterCascade::clearState (int firstSection, int numSectionsToClear) noexcept
+{
+    using namespace IIRCascadeHelpers;
+
+    auto numGroups = (numChannels + numLanes - 1) / numLanes;
+
+    for (int group = 0; group < numGroups; ++group)
+        zeromem (state + (group * maxNumSections + firstSection) * statePerSection,
+                 sizeof (float) * (size_t) (numSectionsToClear * statePerSection));
+}
+
+//==============================================================================
+void IIRFilterCascade::processBlock (AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    jassert (startSample >= 0 && numSamples >= 0 && startSample + numSamples <= buffer.getNumSamples());
+
+    // this cascade wasn't created with enough channels!
+    jassert (buffer.getNumChannels() <= numChannels);
+    auto numChannelsToUse = jmin (buffer.getNumChannels(), numChannels);
+
+    for (int i = 0; i < numChannelsToUse; ++i)
+        channelPointers[i] = buffer.getWritePointer (i, startSample);
+
+    processSamples (channelPointers, numChannelsToUse, numSamples);
+}
+
+void IIRFilterCascade::processBlock (AudioBuffer<float>& buffer) noexcept
+{
+    processBlock (buffer, 0, buffer.getNumSamples());
+}
+
+void IIRFilterCascade::processSamples (float* const* channels, int numChannelsToUse, int numSamples) noexcept
+{
+    using namespace IIRCascadeHelpers;
+
+    // this cascade wasn't created with enough channels!
+    jassert (numChannelsToUse <= numChannels);
+    numChannelsToUse = jmin (numChannelsToUse, numChannels);
+
+    updateCoefficientsIfNeeded();
+
+    auto numSections = activeCoefficients.numSections;
+
+    if (numSections == 0 || numSamples <= 0)
+        return;
+
+    float interleaved[blockSize * numLanes];
+
+    for (int firstChannel = 0; firstChannel < numChannelsToUse; firstChannel += numLanes)
+    {
+        auto* groupState = state + (firstChannel / numLanes) * maxNumSections * statePerSection;
+        auto numChannelsInGroup = jmin ((int) numLanes, numChannelsToUse - firstChannel);
+
+        for (int start = 0; start < numSamples; start += blockSize)
+        {
+            auto num = jmin ((int) blockSize, numSamples - start);
+
+            if (numChannelsInGroup < numLanes)
+                zeromem (interleaved, sizeof (interleaved));
+
+            for (int lane = 0; lane < numChannelsInGroup; ++lane)
+            {
+                auto* src = channels[firstChannel + lane] + start;
+
+                for (int i = 0; i < num; ++i)
+                    interleaved[i * numLanes + lane] = src[i];
+            }
+
+            for (int section = 0; section < numSections; ++section)
+                processSection (interleaved, num,
+                                activeCoefficients.values + section * valuesPerSection,
+                                groupState + section * statePerSection);
+
+            for (int lane = 0; lane < numChannelsInGroup; ++lane)
+            {
+                auto* dest = channels[firstChannel + lane] + start;
+
+                for (int i = 0; i < num; ++i)
+                    dest[i] = interleaved[i * numLanes + lane];
+            }
+        }
+
+        for (int i = 0; i < numSections * statePerSection; ++i)
+        {
+            JUCE_SNAP_TO_ZERO (groupState[i]);
+        }
+    }
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class IIRFilterCascadeTests  : public UnitTest
+{
+public:
+    IIRFilterCascadeTests()  : UnitTest ("IIRFilterCascade", "Audio") {}
+
+    void runTest() override
+    {
+        auto random = getRandom();
+
+        beginTest ("Matches a chain of IIRFilters");
+        {
+            for (auto numChannels : { 1, 2, 3, 6 })
+            {
+                const int numSamples = 2000, numSections = 10;
+
+                Array<IIRCoefficients> coefficients;
+
+                for (int i = 0; i < numSections; ++i)
+                    coefficients.add (IIRCoefficients::makePeakFilter (44100.0, 30.0 * std::pow (2.0, i), 1.4,
+                                                                       (float) Decibels::decibelsToGain (random.nextFloat() * 24.0f - 12.0f)));
+
+                IIRFilterCascade cascade (numChannels, numSections);
+                cascade.setCoefficients (coefficients);
+
+                OwnedArray<IIRFilter> filters;
+
+                for (int i = 0; i < numChannels * numSections; ++i)
+                    filters.add (new IIRFilter())->setCoefficients (coefficients[i % numSections]);
+
+                AudioBuffer<float> buffer (numChannels, numSamples), expected (numChannels, numSamples);
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                    for (int i = 0; i < numSamples; ++i)
+                        buffer.setSample (channel, i, random.nextFloat() * 2.0f - 1.0f);
+
+                expected.makeCopyOf (buffer);
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                    for (int section = 0; section < numSections; ++section)
+                        filters[channel * numSections + section]->processSamples (expected.getWritePointer (channel), numSamples);
+
+                for (int start = 0; start < numSamples;)
+                {
+                    auto num = jmin (random.nextInt (700), numSamples - start);
+                    cascade.processBlock (buffer, start, num);
+                    start += num;
+                }
+
+                expect (buffersMatch (buffer, expected));
+            }
+        }
+
+        beginTest ("Coefficient changes and reset");
+        {
+            AudioBuffer<float> buffer (2, 500), original (2, 500);
+
+            for (int channel = 0; channel < 2; ++channel)
+                for (int i = 0; i < 500; ++i)
+                    buffer.setSample (channel, i, random.nextFloat() * 2.0f - 1.0f);
+
+            original.makeCopyOf (buffer);
+
+            IIRFilterCascade cascade (2, 4);
+            cascade.processBlock (buffer);
+            expect (buffersMatch (buffer, original));
+
+            auto lowPass = IIRCoefficients::makeLowPass (44100.0, 1000.0);
+            cascade.setCoefficients (&lowPass, 1);
+            cascade.processBlock (buffer);
+
+            IIRFilter filter;
+            filter.setCoefficients (lowPass);
+            AudioBuffer<float> expected;
+            expected.makeCopyOf (original);
+            filter.processSamples (expected.getWritePointer (0), 500);
+            filter.reset();
+            filter.processSamples (expected.getWritePointer (1), 500);
+            expect (buffersMatch (buffer, expected));
+
+            buffer.makeCopyOf (original);
+            cascade.reset();
+            cascade.processBlock (buffer);
+            expect (buffersMatch (buffer, expected));
+
+            cascade.setCoefficients (nullptr, 0);
+            buffer.makeCopyOf (original);
+            cascade.processBlock (buffer);
+            expect (buffersMatch (buffer, original));
+        }
+
+        beginTest ("Sections that are switched back on start from silence");
+        {
+            const int numSamples = 300;
+            const IIRCoefficients coefficients[] = { IIRCoefficients::makeLowPass (44100.0, 2000.0),
+                                                     IIRCoefficients::makeHighPass (44100.0, 200.0) };
+
+            IIRFilterCascade cascade (1, 2);
+            IIRFilter first, second;
+            first.setCoefficients (coefficients[0]);
+            second.setCoefficients (coefficients[1]);
+
+            AudioBuffer<float> buffer (1, numSamples), expected (1, numSamples);
+
+            for (int block = 0; block < 3; ++block)
+            {
+                // two sections, then one, then two again
+                auto numSections = block == 1 ? 1 : 2;
+                cascade.setCoefficients (coefficients, numSections);
+
+                for (int i = 0; i < numSamples; ++i)
+                    buffer.setSample (0, i, random.nextFloat() * 2.0f - 1.0f);
+
+                expected.makeCopyOf (buffer);
+                first.processSamples (expected.getWritePointer (0), numSamples);
+
+                if (numSections > 1)
+                    second.processSamples (expected.getWritePointer (0), numSamples);
+                else
+                    second.reset();
+
+                cascade.processBlock (buffer);
+                expect (buffersMatch (buffer, expected));
+            }
+        }
+
+        beginTest ("Large numbers of channels");
+        {
+            const int numChannels = 70, numSamples = 100;
+            auto lowPass = IIRCoefficients::makeLowPass (44100.0, 1000.0);
+
+            IIRFilterCascade cascade (numChannels, 1);
+            cascade.setCoefficients (&lowPass, 1);
+
+            AudioBuffer<float> buffer (numChannels, numSamples), expected (numChannels, numSamples);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                for (int i = 0; i < numSamples; ++i)
+                    buffer.setSample (channel, i, random.nextFloat() * 2.0f - 1.0f);
+
+            expected.makeCopyOf (buffer);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                IIRFilter filter;
+                filter.setCoefficients (lowPass);
+                filter.processSamples (expected.getWritePointer (channel), numSamples);
+            }
+
+            cascade.processBlock (buffer);
+            expect (buffersMatch (buffer, expected));
+        }
+    }
+
+private:
+    static bool buffersMatch (const AudioBuffer<float>& a, const AudioBuffer<float>& b)
+    {
+        for (int channel = 0; channel < a.getNumChannels(); ++channel)
+            for (int i = 0; i < a.getNumSamples(); ++i)
+                if (std::abs (a.getSample (channel, i) - b.getSample (channel, i)) > 1.0e-4f)
+                    return false;
+
+        return true;
+    }
+};
+
+static IIRFilterCascadeTests iirFilterCascadeTests;
+
+#endif
+
 } // namespace juce
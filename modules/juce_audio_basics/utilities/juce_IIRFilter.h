@@ -214,4 +214,115 @@ protected:
     JUCE_LEAK_DETECTOR (IIRFilter)
 };
 
+//==============================================================================
+/**
+    A chain of biquad filter sections which is applied to all the channels of a
+    block of audio in one pass.
+
+    Each section behaves like an IIRFilter, with the output of each one feeding
+    into the next, so for example a graphic EQ can be built from a single cascade
+    of peak filters rather than a separate IIRFilter for every band and channel.
+    The channels are processed side-by-side using SIMD instructions where they're
+    available.
+
+    The coefficients can be changed from any thread while audio is being processed.
+    setCoefficients() writes the new values into a second set of coefficients, and
+    the audio thread swaps this with the set it's using at the start of its next
+    block. The audio thread never waits for a lock: if the new coefficients are in
+    the middle of being written, it just keeps using the old ones for one more block.
+
+    @see IIRFilter, IIRCoefficients
+
+    @tags{Audio}
+*/
+class JUCE_API  IIRFilterCascade
+{
+public:
+    //==============================================================================
+    /** Creates a cascade for a number of channels, with space for up to
+        maxNumSections filter sections.
+
+        Initially there are no sections, so any audio that is processed passes
+        through unchanged.
+    */
+    IIRFilterCascade (int numChannels, int maxNumSections);
+
+    /** Destructor. */
+    ~IIRFilterCascade() noexcept;
+
+    //==============================================================================
+    /** Returns the number of channels that this cascade was created for. */
+    int getNumChannels() const noexcept                 { return numChannels; }
+
+    /** Returns the largest number of sections that this cascade can hold. */
+    int getMaxNumSections() const noexcept              { return maxNumSections; }
+
+    /** Replaces all the sections of the cascade.
+
+        This can be called from any thread, and doesn't allocate, so it's fine to call
+        it from the audio thread too. The new coefficients are used from the start of
+        the next block to be processed. The filter state is kept, so changing the
+        coefficients of the same number of sections won't cause a discontinuity.
+        Any sections beyond the number that were previously in use start with a
+        cleared state.
+
+        @param sectionCoefficients  an array of numSections sets of coefficients
+        @param numSections          the number of sections, which must not be more than
+                                    getMaxNumSections()
+    */
+    void setCoefficients (const IIRCoefficients* sectionCoefficients, int numSections) noexcept;
+
+    /** Replaces all the sections of the cascade.
+        @see setCoefficients
+    */
+    void setCoefficients (const Array<IIRCoefficients>& sectionCoefficients) noexcept;
+
+    /** Resets the processing state of all the sections, ready to start a new
+        stream of data.
+
+        This can be called from any thread. The state is cleared at the start of the
+        next block to be processed.
+    */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Filters all the channels of a region of a buffer.
+        The buffer mustn't have more channels than this cascade was created for.
+    */
+    void processBlock (AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+
+    /** Filters all the channels of a buffer.
+        The buffer mustn't have more channels than this cascade was created for.
+    */
+    void processBlock (AudioBuffer<float>& buffer) noexcept;
+
+    /** Filters a set of channels.
+        @param channels             an array of channel pointers
+        @param numChannelsToUse     the number of channels, which mustn't be more than
+                                    getNumChannels()
+        @param numSamples           the number of samples to filter in each channel
+    */
+    void processSamples (float* const* channels, int numChannelsToUse, int numSamples) noexcept;
+
+private:
+    //==============================================================================
+    struct CoefficientSet
+    {
+        HeapBlock<float> values;
+        int numSections = 0;
+    };
+
+    const int numChannels, maxNumSections;
+    CoefficientSet activeCoefficients, pendingCoefficients;
+    SpinLock pendingLock;
+    std::atomic<bool> hasPendingCoefficients { false }, shouldReset { false };
+    HeapBlock<float> state;
+    HeapBlock<float*> channelPointers;
+
+    void updateCoefficientsIfNeeded() noexcept;
+    void clearState (int firstSection, int numSectionsToClear) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (IIRFilterCascade)
+};
+
 } // namespace juce
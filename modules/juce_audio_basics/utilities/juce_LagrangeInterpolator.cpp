@@ -431,6 +431,17 @@ struct LagrangeAlgorithm
         LagrangeResampleHelper<4 - k>::calc (input,  2.0f - offset);
         return input;
     }
+
+    // The weights to apply to the last five input samples (oldest first) to get the
+    // value at a given offset, as used by MultichannelInterpolator.
+    static forcedinline void calcCoefficients (float offset, float* c) noexcept
+    {
+        c[0] = calcCoefficient<0> (1.0f, offset);
+        c[1] = calcCoefficient<1> (1.0f, offset);
+        c[2] = calcCoefficient<2> (1.0f, offset);
+        c[3] = calcCoefficient<3> (1.0f, offset);
+        c[4] = calcCoefficient<4> (1.0f, offset);
+    }
 };
 
 LagrangeInterpolator::LagrangeInterpolator() noexcept  { reset(); }
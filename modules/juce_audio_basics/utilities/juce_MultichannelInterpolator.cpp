@@ -0,0 +1,478 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+// This builds on the single-channel interpolation functions and algorithm
+// classes in juce_LagrangeInterpolator.cpp and juce_CatmullRomInterpolator.cpp.
+namespace
+{
+    static const int silentInputSample = std::numeric_limits<int>::min();
+
+    // Keeps track of where the next input sample comes from, replicating the
+    // wrap-around and zero-padding behaviour of the 'available' overloads.
+    struct InputCursor
+    {
+        int next() noexcept
+        {
+            if (! limited)
+                return position++;
+
+            if (exceeded)
+                return silentInputSample;
+
+            auto index = position++;
+
+            if (--available <= 0)
+            {
+                if (wrap > 0)
+                {
+                    position -= wrap;
+                    available += wrap;
+                }
+                else
+                {
+                    exceeded = true;
+                }
+            }
+
+            return index;
+        }
+
+        int getNumUsed() const noexcept
+        {
+            return wrap == 0 ? position : (position + wrap) % wrap;
+        }
+
+        int position = 0, available = 0, wrap = 0;
+        bool exceeded = false, limited = false;
+    };
+
+    // The read positions and interpolation weights for a run of output samples,
+    // which get worked out once and then applied to every channel.
+    struct ReadPlan
+    {
+        enum
+        {
+            maxOutputs = 64,
+            maxInputs = 512
+        };
+
+        enum class Stepping
+        {
+            unlimited,
+            wrappedUpsampling,
+            wrappedDownsampling
+        };
+
+        template <typename Algorithm>
+        void create (InputCursor& cursor, double& pos, double ratio, int maxOutputsToPlan, Stepping stepping) noexcept
+        {
+            jassert (ratio < maxInputs);
+            numOutputs = numInputs = 0;
+
+            while (numOutputs < jmin ((int) maxOutputs, maxOutputsToPlan))
+            {
+                auto newPos = pos;
+                int numToPush = 0;
+                float offset;
+
+                if (stepping == Stepping::wrappedDownsampling)
+                {
+                    while (newPos < ratio)
+                    {
+                        ++numToPush;
+                        newPos += 1.0;
+                    }
+
+                    newPos -= ratio;
+                    offset = jmax (0.0f, 1.0f - (float) newPos);
+                }
+                else
+                {
+                    if (stepping == Stepping::unlimited)
+                    {
+                        while (newPos >= 1.0)
+                        {
+                            ++numToPush;
+                            newPos -= 1.0;
+                        }
+                    }
+                    else if (newPos >= 1.0)
+                    {
+                        ++numToPush;
+                        newPos -= 1.0;
+                    }
+
+                    offset = (float) newPos;
+                    newPos += ratio;
+                }
+
+                if (numInputs + numToPush > maxInputs)
+                    break;
+
+                while (--numToPush >= 0)
+                    sourceIndexes[numInputs++] = cursor.next();
+
+                float c[5];
+                Algorithm::calcCoefficients (offset, c);
+
+                for (int k = 0; k < 5; ++k)
+                    coefficients[k][numOutputs] = c[k];
+
+                windowStarts[numOutputs++] = numInputs;
+                pos = newPos;
+            }
+        }
+
+        // Interpolates one channel, where samples holds the five previous input samples
+        // (oldest first), followed by the numInputs new ones.
+        void render (const float* samples, float* dest, bool adding, float gain) const noexcept
+        {
+            int i = 0;
+
+           #if JUCE_USE_SSE_INTRINSICS
+            for (; i + 4 <= numOutputs; i += 4)
+            {
+                auto* w = windowStarts + i;
+                auto sum = _mm_setzero_ps();
+
+                for (int k = 0; k < 5; ++k)
+                    sum = _mm_add_ps (sum, _mm_mul_ps (_mm_loadu_ps (coefficients[k] + i),
+                                                       _mm_setr_ps (samples[w[0] + k], samples[w[1] + k],
+                                                                    samples[w[2] + k], samples[w[3] + k])));
+
+                if (adding)
+                    _mm_storeu_ps (dest + i, _mm_add_ps (_mm_loadu_ps (dest + i), _mm_mul_ps (sum, _mm_set1_ps (gain))));
+                else
+                    _mm_storeu_ps (dest + i, sum);
+            }
+           #elif JUCE_USE_ARM_NEON
+            for (; i + 4 <= numOutputs; i += 4)
+            {
+                auto* w = windowStarts + i;
+                auto sum = vdupq_n_f32 (0.0f);
+
+                for (int k = 0; k < 5; ++k)
+                {
+                    const float gathered[4] = { samples[w[0] + k], samples[w[1] + k], samples[w[2] + k], samples[w[3] + k] };
+                    sum = vaddq_f32 (sum, vmulq_f32 (vld1q_f32 (coefficients[k] + i), vld1q_f32 (gathered)));
+                }
+
+                if (adding)
+                    vst1q_f32 (dest + i, vaddq_f32 (vld1q_f32 (dest + i), vmulq_n_f32 (sum, gain)));
+                else
+                    vst1q_f32 (dest + i, sum);
+            }
+           #endif
+
+            for (; i < numOutputs; ++i)
+            {
+                auto* w = samples + windowStarts[i];
+                float sum = 0.0f;
+
+                for (int k = 0; k < 5; ++k)
+                    sum += coefficients[k][i] * w[k];
+
+                if (adding)
+                    dest[i] += sum * gain;
+                else
+                    dest[i] = sum;
+            }
+        }
+
+        float coefficients[5][maxOutputs];
+        int windowStarts[maxOutputs];
+        int sourceIndexes[maxInputs];
+        int numOutputs = 0, numInputs = 0;
+    };
+
+    template <typename Algorithm>
+    static int interpolateChannels (float* const* lastInputSamples, int numChannels, double& subSamplePos,
+                                    double actualRatio, const float* const* in, float* const* out, int numOut,
+                                    InputCursor cursor, ReadPlan::Stepping stepping, bool adding, float gain) noexcept
+    {
+        ReadPlan plan;
+        float samples[5 + ReadPlan::maxInputs];
+        auto pos = subSamplePos;
+
+        for (int done = 0; done < numOut;)
+        {
+            plan.create<Algorithm> (cursor, pos, actualRatio, numOut - done, stepping);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                auto* last = lastInputSamples[channel];
+                auto* src = in[channel];
+
+                for (int i = 0; i < 5; ++i)
+                    samples[i] = last[4 - i];
+
+                for (int i = 0; i < plan.numInputs; ++i)
+                {
+                    auto index = plan.sourceIndexes[i];
+                    samples[i + 5] = index == silentInputSample ? 0.0f : src[index];
+                }
+
+                plan.render (samples, out[channel] + done, adding, gain);
+
+                for (int i = 0; i < 5; ++i)
+                    last[i] = samples[plan.numInputs + 4 - i];
+            }
+
+            done += plan.numOutputs;
+        }
+
+        subSamplePos = pos;
+        return cursor.getNumUsed();
+    }
+
+    //==============================================================================
+    // With a single channel there's nothing to share, and at a ratio of 1 the input is
+    // just copied, so in those cases each channel is handed to the single-channel version.
+    template <typename Function>
+    static int processEachChannel (int numChannels, double& subSamplePos, Function&& processChannel) noexcept
+    {
+        auto pos = subSamplePos;
+        int numUsed = 0;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            pos = subSamplePos;
+            numUsed = processChannel (channel, pos);
+        }
+
+        subSamplePos = pos;
+        return numUsed;
+    }
+
+    static InputCursor createWrappingCursor (int available, int wrap) noexcept
+    {
+        InputCursor cursor;
+        cursor.available = available;
+        cursor.wrap = wrap;
+        cursor.limited = true;
+        return cursor;
+    }
+
+    static ReadPlan::Stepping getWrappedStepping (double actualRatio) noexcept
+    {
+        return actualRatio < 1.0 ? ReadPlan::Stepping::wrappedUpsampling
+                                 : ReadPlan::Stepping::wrappedDownsampling;
+    }
+
+    template <typename Algorithm>
+    static int interpolateMultichannel (float* const* lastInputSamples, int numChannels, double& subSamplePos, double actualRatio,
+                                        const float* const* in, float* const* out, int numOut) noexcept
+    {
+        if (numChannels == 1 || (actualRatio == 1.0 && subSamplePos == 1.0))
+            return processEachChannel (numChannels, subSamplePos, [=] (int channel, double& pos)
+            {
+                return interpolate<Algorithm> (lastInputSamples[channel], pos, actualRatio, in[channel], out[channel], numOut);
+            });
+
+        return interpolateChannels<Algorithm> (lastInputSamples, numChannels, subSamplePos, actualRatio, in, out, numOut,
+                                               {}, ReadPlan::Stepping::unlimited, false, 1.0f);
+    }
+
+    template <typename Algorithm>
+    static int interpolateMultichannel (float* const* lastInputSamples, int numChannels, double& subSamplePos, double actualRatio,
+                                        const float* const* in, float* const* out, int numOut, int available, int wrap) noexcept
+    {
+        if (numChannels == 1 || actualRatio == 1.0)
+            return processEachChannel (numChannels, subSamplePos, [=] (int channel, double& pos)
+            {
+                return interpolate<Algorithm> (lastInputSamples[channel], pos, actualRatio, in[channel], out[channel], numOut, available, wrap);
+            });
+
+        return interpolateChannels<Algorithm> (lastInputSamples, numChannels, subSamplePos, actualRatio, in, out, numOut,
+                                               createWrappingCursor (available, wrap), getWrappedStepping (actualRatio), false, 1.0f);
+    }
+
+    template <typename Algorithm>
+    static int interpolateMultichannelAdding (float* const* lastInputSamples, int numChannels, double& subSamplePos, double actualRatio,
+                                              const float* const* in, float* const* out, int numOut, float gain) noexcept
+    {
+        if (numChannels == 1 || (actualRatio == 1.0 && subSamplePos == 1.0))
+            return processEachChannel (numChannels, subSamplePos, [=] (int channel, double& pos)
+            {
+                return interpolateAdding<Algorithm> (lastInputSamples[channel], pos, actualRatio, in[channel], out[channel], numOut, gain);
+            });
+
+        return interpolateChannels<Algorithm> (lastInputSamples, numChannels, subSamplePos, actualRatio, in, out, numOut,
+                                               {}, ReadPlan::Stepping::unlimited, true, gain);
+    }
+
+    template <typename Algorithm>
+    static int interpolateMultichannelAdding (float* const* lastInputSamples, int numChannels, double& subSamplePos, double actualRatio,
+                                              const float* const* in, float* const* out, int numOut,
+                                              int available, int wrap, float gain) noexcept
+    {
+        if (numChannels == 1 || actualRatio == 1.0)
+            return processEachChannel (numChannels, subSamplePos, [=] (int channel, double& pos)
+            {
+                return interpolateAdding<Algorithm> (lastInputSamples[channel], pos, actualRatio, in[channel], out[channel],
+                                                     numOut, available, wrap, gain);
+            });
+
+        return interpolateChannels<Algorithm> (lastInputSamples, numChannels, subSamplePos, actualRatio, in, out, numOut,
+                                               createWrappingCursor (available, wrap), getWrappedStepping (actualRatio), true, gain);
+    }
+}
+
+//==============================================================================
+MultichannelInterpolator::MultichannelInterpolator (Algorithm algorithmToUse, int channels)
+    : algorithm (algorithmToUse), numChannels (channels)
+{
+    jassert (numChannels > 0);
+
+    lastInputSamples.calloc ((size_t) numChannels * 5);
+    channelStates.malloc ((size_t) numChannels);
+
+    for (int i = 0; i < numChannels; ++i)
+        channelStates[i] = lastInputSamples + i * 5;
+
+    reset();
+}
+
+MultichannelInterpolator::~MultichannelInterpolator() noexcept {}
+
+void MultichannelInterpolator::reset() noexcept
+{
+    subSamplePos = 1.0;
+    lastInputSamples.clear ((size_t) numChannels * 5);
+}
+
+int MultichannelInterpolator::process (double actualRatio, const float* const* in, float* const* out, int numOut) noexcept
+{
+    if (algorithm == Algorithm::lagrange)
+        return interpolateMultichannel<LagrangeAlgorithm> (channelStates, numChannels, subSamplePos, actualRatio, in, out, numOut);
+
+    return interpolateMultichannel<CatmullRomAlgorithm> (channelStates, numChannels, subSamplePos, actualRatio, in, out, numOut);
+}
+
+int MultichannelInterpolator::process (double actualRatio, const float* const* in, float* const* out,
+                                       int numOut, int available, int wrap) noexcept
+{
+    if (algorithm == Algorithm::lagrange)
+        return interpolateMultichannel<LagrangeAlgorithm> (channelStates, numChannels, subSamplePos, actualRatio, in, out, numOut, available, wrap);
+
+    return interpolateMultichannel<CatmullRomAlgorithm> (channelStates, numChannels, subSamplePos, actualRatio, in, out, numOut, available, wrap);
+}
+
+int MultichannelInterpolator::processAdding (double actualRatio, const float* const* in, float* const* out,
+                                             int numOut, float gain) noexcept
+{
+    if (algorithm == Algorithm::lagrange)
+        return interpolateMultichannelAdding<LagrangeAlgorithm> (channelStates, numChannels, subSamplePos, actualRatio, in, out, numOut, gain);
+
+    return interpolateMultichannelAdding<CatmullRomAlgorithm> (channelStates, numChannels, subSamplePos, actualRatio, in, out, numOut, gain);
+}
+
+int MultichannelInterpolator::processAdding (double actualRatio, const float* const* in, float* const* out,
+                                             int numOut, int available, int wrap, float gain) noexcept
+{
+    if (algorithm == Algorithm::lagrange)
+        return interpolateMultichannelAdding<LagrangeAlgorithm> (channelStates, numChannels, subSamplePos, actualRatio, in, out, numOut, available, wrap, gain);
+
+    return interpolateMultichannelAdding<CatmullRomAlgorithm> (channelStates, numChannels, subSamplePos, actualRatio, in, out, numOut, available, wrap, gain);
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct MultichannelInterpolatorTests  : public UnitTest
+{
+    MultichannelInterpolatorTests() : UnitTest ("MultichannelInterpolator", "Audio") {}
+
+    template <typename SingleChannelType>
+    void checkMatchesSingleChannel (MultichannelInterpolator::Algorithm algorithm, bool useWrapping)
+    {
+        const int numChannels = 3, numInputSamples = 4096, blockSize = 100;
+        auto random = getRandom();
+
+        AudioBuffer<float> input (numChannels, numInputSamples);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = 0; i < numInputSamples; ++i)
+                input.setSample (channel, i, random.nextFloat() * 2.0f - 1.0f);
+
+        MultichannelInterpolator multichannel (algorithm, numChannels);
+        OwnedArray<SingleChannelType> singleChannel;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            singleChannel.add (new SingleChannelType());
+
+        AudioBuffer<float> expected (numChannels, blockSize), actual (numChannels, blockSize);
+        int readPos = 0;
+
+        for (auto ratio : { 0.37, 1.0, 1.5, 2.93, 0.8 })
+        {
+            const int available = 60, wrap = useWrapping ? 150 : 0;
+            int numUsed = 0;
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                auto* in = input.getReadPointer (channel, readPos + 200);
+                auto* out = expected.getWritePointer (channel);
+
+                numUsed = useWrapping ? singleChannel[channel]->process (ratio, in, out, blockSize, available, wrap)
+                                      : singleChannel[channel]->process (ratio, in, out, blockSize);
+            }
+
+            const float* inputs[numChannels];
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                inputs[channel] = input.getReadPointer (channel, readPos + 200);
+
+            auto* outputs = actual.getArrayOfWritePointers();
+
+            expectEquals (useWrapping ? multichannel.process (ratio, inputs, outputs, blockSize, available, wrap)
+                                      : multichannel.process (ratio, inputs, outputs, blockSize),
+                          numUsed);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                for (int i = 0; i < blockSize; ++i)
+                    expectWithinAbsoluteError (actual.getSample (channel, i), expected.getSample (channel, i), 1.0e-5f);
+
+            readPos += numUsed;
+        }
+    }
+
+    void runTest() override
+    {
+        beginTest ("Lagrange matches LagrangeInterpolator");
+        checkMatchesSingleChannel<LagrangeInterpolator> (MultichannelInterpolator::Algorithm::lagrange, false);
+        checkMatchesSingleChannel<LagrangeInterpolator> (MultichannelInterpolator::Algorithm::lagrange, true);
+
+        beginTest ("Catmull-Rom matches CatmullRomInterpolator");
+        checkMatchesSingleChannel<CatmullRomInterpolator> (MultichannelInterpolator::Algorithm::catmullRom, false);
+        checkMatchesSingleChannel<CatmullRomInterpolator> (MultichannelInterpolator::Algorithm::catmullRom, true);
+    }
+};
+
+static MultichannelInterpolatorTests multichannelInterpolatorTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,172 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+/**
+    Interpolator for resampling several channels of floats at once, using either
+    Catmull-Rom or 4-point lagrange interpolation.
+
+    This gives the same results as using a separate LagrangeInterpolator or
+    CatmullRomInterpolator for each channel (to within floating-point rounding), but
+    the read positions and interpolation coefficients are only calculated once per
+    output sample and are shared between all the channels, and the interpolation
+    itself is vectorised. With a single channel, it just uses the same code as those
+    classes.
+
+    Like them, this is stateful, so when there's a break in the continuity of the
+    input stream you're feeding it, you should call reset() before feeding it any
+    new data.
+
+    @see LagrangeInterpolator, CatmullRomInterpolator
+
+    @tags{Audio}
+*/
+class JUCE_API  MultichannelInterpolator
+{
+public:
+    /** The interpolation algorithms that can be used. */
+    enum class Algorithm
+    {
+        lagrange,
+        catmullRom
+    };
+
+    /** Creates an interpolator for a given number of channels. */
+    MultichannelInterpolator (Algorithm algorithm, int numChannels);
+
+    /** Destructor. */
+    ~MultichannelInterpolator() noexcept;
+
+    /** Resets the state of the interpolator.
+        Call this when there's a break in the continuity of the input data stream.
+    */
+    void reset() noexcept;
+
+    /** Returns the number of channels that this interpolator was created for. */
+    int getNumChannels() const noexcept                 { return numChannels; }
+
+    /** Returns the algorithm that this interpolator was created with. */
+    Algorithm getAlgorithm() const noexcept             { return algorithm; }
+
+    /** Resamples a block of samples on each channel.
+
+        @param speedRatio       the number of input samples to use for each output sample
+        @param inputChannels    an array of getNumChannels() pointers to the source data. Each
+                                channel must contain at least (speedRatio * numOutputSamplesToProduce)
+                                samples.
+        @param outputChannels   an array of getNumChannels() pointers to write the results into
+        @param numOutputSamplesToProduce    the number of output samples that should be created
+                                            on each channel
+
+        @returns the actual number of input samples that were used from each channel
+    */
+    int process (double speedRatio,
+                 const float* const* inputChannels,
+                 float* const* outputChannels,
+                 int numOutputSamplesToProduce) noexcept;
+
+    /** Resamples a block of samples on each channel.
+
+        @param speedRatio       the number of input samples to use for each output sample
+        @param inputChannels    an array of getNumChannels() pointers to the source data
+        @param outputChannels   an array of getNumChannels() pointers to write the results into
+        @param numOutputSamplesToProduce    the number of output samples that should be created
+                                            on each channel
+        @param available        the number of available input samples. If it needs more samples
+                                than available, it either wraps back for wrapAround samples, or
+                                it feeds zeroes
+        @param wrapAround       if the stream exceeds available samples, it wraps back for
+                                wrapAround samples. If wrapAround is set to 0, it will feed zeroes.
+
+        @returns the actual number of input samples that were used from each channel
+    */
+    int process (double speedRatio,
+                 const float* const* inputChannels,
+                 float* const* outputChannels,
+                 int numOutputSamplesToProduce,
+                 int available,
+                 int wrapAround) noexcept;
+
+    /** Resamples a block of samples on each channel, adding the results to the output
+        data with a gain.
+
+        @param speedRatio       the number of input samples to use for each output sample
+        @param inputChannels    an array of getNumChannels() pointers to the source data. Each
+                                channel must contain at least (speedRatio * numOutputSamplesToProduce)
+                                samples.
+        @param outputChannels   an array of getNumChannels() pointers to the output data - the result
+                                values will be added to any pre-existing data in these buffers after
+                                being multiplied by the gain factor
+        @param numOutputSamplesToProduce    the number of output samples that should be created
+                                            on each channel
+        @param gain             a gain factor to multiply the resulting samples by before
+                                adding them to the destination buffers
+
+        @returns the actual number of input samples that were used from each channel
+    */
+    int processAdding (double speedRatio,
+                       const float* const* inputChannels,
+                       float* const* outputChannels,
+                       int numOutputSamplesToProduce,
+                       float gain) noexcept;
+
+    /** Resamples a block of samples on each channel, adding the results to the output
+        data with a gain.
+
+        @param speedRatio       the number of input samples to use for each output sample
+        @param inputChannels    an array of getNumChannels() pointers to the source data
+        @param outputChannels   an array of getNumChannels() pointers to the output data - the result
+                                values will be added to any pre-existing data in these buffers after
+                                being multiplied by the gain factor
+        @param numOutputSamplesToProduce    the number of output samples that should be created
+                                            on each channel
+        @param available        the number of available input samples. If it needs more samples
+                                than available, it either wraps back for wrapAround samples, or
+                                it feeds zeroes
+        @param wrapAround       if the stream exceeds available samples, it wraps back for
+                                wrapAround samples. If wrapAround is set to 0, it will feed zeroes.
+        @param gain             a gain factor to multiply the resulting samples by before
+                                adding them to the destination buffers
+
+        @returns the actual number of input samples that were used from each channel
+    */
+    int processAdding (double speedRatio,
+                       const float* const* inputChannels,
+                       float* const* outputChannels,
+                       int numOutputSamplesToProduce,
+                       int available,
+                       int wrapAround,
+                       float gain) noexcept;
+
+private:
+    const Algorithm algorithm;
+    const int numChannels;
+    HeapBlock<float> lastInputSamples;
+    HeapBlock<float*> channelStates;
+    double subSamplePos;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MultichannelInterpolator)
+};
+
+} // namespace juce
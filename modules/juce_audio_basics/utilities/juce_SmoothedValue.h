@@ -80,6 +80,22 @@ public:
         countdown = 0;
     }
 
+    //==============================================================================
+    /** Fills an array with the next numSamples values of the ramp.
+        This is the same as calling getNextValue() numSamples times and storing the
+        results, but the smoothed value classes may calculate the values more
+        efficiently.
+        @param values       Pointer to a raw array to write the values into
+        @param numSamples   The number of values to write
+    */
+    void getNextValues (FloatType* values, int numSamples) noexcept
+    {
+        jassert (numSamples >= 0);
+
+        for (int i = 0; i < numSamples; ++i)
+            values[i] = getNextSmoothedValue();
+    }
+
     //==============================================================================
     /** Applies a smoothed gain to a stream of samples
         S[i] *= gain
@@ -88,17 +104,7 @@ public:
     */
     void applyGain (FloatType* samples, int numSamples) noexcept
     {
-        jassert (numSamples >= 0);
-
-        if (isSmoothing())
-        {
-            for (int i = 0; i < numSamples; ++i)
-                samples[i] *= getNextSmoothedValue();
-        }
-        else
-        {
-            FloatVectorOperations::multiply (samples, target, numSamples);
-        }
+        applyGain (samples, samples, numSamples);
     }
 
     /** Computes output as a smoothed gain applied to a stream of samples.
@@ -111,46 +117,54 @@ public:
     {
         jassert (numSamples >= 0);
 
-        if (isSmoothing())
+        FloatType gains[gainBlockSize];
+
+        while (isSmoothing() && numSamples > 0)
         {
-            for (int i = 0; i < numSamples; ++i)
-                samplesOut[i] = samplesIn[i] * getNextSmoothedValue();
+            auto num = jmin (numSamples, countdown, (int) gainBlockSize);
+            getNextSmoothedValues (gains, num);
+            FloatVectorOperations::multiply (samplesOut, samplesIn, gains, num);
+
+            samplesOut += num;
+            samplesIn += num;
+            numSamples -= num;
         }
-        else
-        {
+
+        if (numSamples > 0)
             FloatVectorOperations::multiply (samplesOut, samplesIn, target, numSamples);
-        }
     }
 
     /** Applies a smoothed gain to a buffer */
     void applyGain (AudioBuffer<FloatType>& buffer, int numSamples) noexcept
     {
-        jassert (numSamples >= 0);
+        applyGain (buffer, 0, numSamples);
+    }
 
-        if (isSmoothing())
-        {
-            if (buffer.getNumChannels() == 1)
-            {
-                auto* samples = buffer.getWritePointer (0);
+    /** Applies a smoothed gain to a region of all the channels of a buffer.
+        @param buffer       The buffer to process
+        @param startSample  The first sample in each channel to apply the gain to
+        @param numSamples   The number of samples to process
+    */
+    void applyGain (AudioBuffer<FloatType>& buffer, int startSample, int numSamples) noexcept
+    {
+        jassert (startSample >= 0 && numSamples >= 0 && startSample + numSamples <= buffer.getNumSamples());
 
-                for (int i = 0; i < numSamples; ++i)
-                    samples[i] *= getNextSmoothedValue();
-            }
-            else
-            {
-                for (auto i = 0; i < numSamples; ++i)
-                {
-                    auto gain = getNextSmoothedValue();
+        FloatType gains[gainBlockSize];
 
-                    for (int channel = 0; channel < buffer.getNumChannels(); channel++)
-                        buffer.setSample (channel, i, buffer.getSample (channel, i) * gain);
-                }
-            }
-        }
-        else
+        while (isSmoothing() && numSamples > 0)
         {
-            buffer.applyGain (0, numSamples, target);
+            auto num = jmin (numSamples, countdown, (int) gainBlockSize);
+            getNextSmoothedValues (gains, num);
+
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                FloatVectorOperations::multiply (buffer.getWritePointer (channel, startSample), gains, num);
+
+            startSample += num;
+            numSamples -= num;
         }
+
+        if (numSamples > 0)
+            buffer.applyGain (startSample, numSamples, target);
     }
 
 private:
@@ -160,6 +174,13 @@ private:
         return static_cast <SmoothedValueType*> (this)->getNextValue();
     }
 
+    void getNextSmoothedValues (FloatType* values, int numSamples) noexcept
+    {
+        static_cast <SmoothedValueType*> (this)->getNextValues (values, numSamples);
+    }
+
+    enum { gainBlockSize = 256 };
+
 protected:
     //==============================================================================
     FloatType currentValue = 0;
@@ -301,6 +322,44 @@ public:
         return this->currentValue;
     }
 
+    //==============================================================================
+    /** Fills an array with the next numSamples values of the ramp.
+
+        This produces exactly the same values as calling getNextValue numSamples
+        times, but without any per-sample overhead: the steps of the ramp are
+        accumulated in a tight loop, and any values after the end of the ramp are
+        filled in with vector operations.
+
+        @param values       Pointer to a raw array to write the values into
+        @param numSamples   The number of values to write
+        @see getNextValue, applyGain
+    */
+    void getNextValues (FloatType* values, int numSamples) noexcept
+    {
+        jassert (numSamples >= 0);
+
+        // the last step of the ramp always lands exactly on the target, so it's
+        // handled along with the values that follow it
+        auto numRampValues = jmin (numSamples, jmax (0, this->countdown - 1));
+
+        if (numRampValues > 0)
+        {
+            auto value = this->currentValue;
+
+            for (int i = 0; i < numRampValues; ++i)
+                values[i] = value = getValueAfterStep (value);
+
+            this->currentValue = value;
+            this->countdown -= numRampValues;
+        }
+
+        if (numSamples > numRampValues)
+        {
+            this->setCurrentAndTargetValue (this->target);
+            FloatVectorOperations::fill (values + numRampValues, this->target, numSamples - numRampValues);
+        }
+    }
+
     //==============================================================================
     /** Skip the next numSamples samples.
         This is identical to calling getNextValue numSamples times. It returns
@@ -390,6 +449,21 @@ private:
         this->currentValue *= (FloatType) std::pow (step, numSamples);
     }
 
+    //==============================================================================
+    template <typename T = SmoothingType>
+    typename std::enable_if <std::is_same <T, ValueSmoothingTypes::Linear>::value, FloatType>::type
+    getValueAfterStep (FloatType value) const noexcept
+    {
+        return value + step;
+    }
+
+    template <typename T = SmoothingType>
+    typename std::enable_if <std::is_same <T, ValueSmoothingTypes::Multiplicative>::value, FloatType>::type
+    getValueAfterStep (FloatType value) const noexcept
+    {
+        return value * step;
+    }
+
     //==============================================================================
     FloatType step = FloatType();
     int stepsToTarget = 0;
@@ -546,6 +620,59 @@ public:
             compareData (testData, referenceData);
         }
 
+        beginTest ("Filling blocks of values");
+        {
+            SmoothedValueType sv (1.0f);
+
+            const auto numSteps = 1000, numSamples = 1100;
+            sv.reset (numSteps);
+            sv.setTargetValue (2.0f);
+
+            auto referenceSv = sv;
+            std::vector<float> reference, values ((size_t) numSamples);
+
+            for (int i = 0; i < numSamples; ++i)
+                reference.push_back (referenceSv.getNextValue());
+
+            auto random = getRandom();
+
+            for (int start = 0; start < numSamples;)
+            {
+                auto num = jmin (random.nextInt (300), numSamples - start);
+                sv.getNextValues (values.data() + start, num);
+                start += num;
+
+                expect (sv.isSmoothing() == (start < numSteps));
+
+                if (sv.isSmoothing())
+                    expectEquals (sv.getCurrentValue(), start > 0 ? reference[(size_t) start - 1] : 1.0f);
+            }
+
+            expect (values == reference);
+            expectEquals (sv.getNextValue(), 2.0f);
+
+            AudioBuffer<float> buffer (3, numSamples);
+
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                FloatVectorOperations::fill (buffer.getWritePointer (channel), 1.0f, numSamples);
+
+            sv.setCurrentAndTargetValue (1.0f);
+            sv.setTargetValue (2.0f);
+            sv.applyGain (buffer, 10, numSamples - 20);
+
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            {
+                for (int i = 0; i < 10; ++i)
+                {
+                    expectEquals (buffer.getSample (channel, i), 1.0f);
+                    expectEquals (buffer.getSample (channel, numSamples - 1 - i), 1.0f);
+                }
+
+                for (int i = 10; i < numSamples - 10; ++i)
+                    expectEquals (buffer.getSample (channel, i), reference[(size_t) i - 10]);
+            }
+        }
+
         beginTest ("Skip");
         {
             SmoothedValueType sv;
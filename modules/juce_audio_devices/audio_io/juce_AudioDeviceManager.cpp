@@ -815,6 +815,11 @@ double AudioDeviceManager::getCpuUsage() const
     return loadMeasurer.getLoadAsProportion();
 }
 
+AudioProcessLoadMeasurer::Statistics AudioDeviceManager::getLoadStatistics() const
+{
+    return loadMeasurer.getStatistics();
+}
+
 //==============================================================================
 void AudioDeviceManager::setMidiInputEnabled (const String& name, const bool enabled)
 {
@@ -304,6 +304,13 @@ public:
     */
     double getCpuUsage() const;
 
+    /** Returns a snapshot of the distribution of the time spent inside the audio callbacks,
+        including percentiles and the slowest callback, since the current device was started.
+        This can be called from any thread.
+        @see AudioProcessLoadMeasurer::getStatistics
+    */
+    AudioProcessLoadMeasurer::Statistics getLoadStatistics() const;
+
     //==============================================================================
     /** Enables or disables a midi input device.
 
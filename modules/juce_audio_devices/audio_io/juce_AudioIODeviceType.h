@@ -167,6 +167,12 @@ public:
     static AudioIODeviceType* createAudioIODeviceType_Oboe();
     /** Creates a Bela device type if it's available on this platform, or returns null. */
     static AudioIODeviceType* createAudioIODeviceType_Bela();
+    /** Creates a device type whose device isn't connected to any hardware, and which renders
+        audio as fast as possible on a background thread. This is available on all platforms,
+        but isn't included in the types that AudioDeviceManager creates by default.
+        @see OfflineAudioIODevice
+    */
+    static AudioIODeviceType* createAudioIODeviceType_Offline();
 
 protected:
     explicit AudioIODeviceType (const String& typeName);
@@ -0,0 +1,420 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+OfflineAudioIODevice::OfflineAudioIODevice (const String& deviceName, int numInputChannels, int numOutputChannels)
+    : AudioIODevice (deviceName, "Offline"),
+      Thread ("Offline audio"),
+      numInputs (jmax (0, numInputChannels)),
+      numOutputs (jmax (0, numOutputChannels))
+{
+}
+
+OfflineAudioIODevice::~OfflineAudioIODevice()
+{
+    close();
+}
+
+//==============================================================================
+void OfflineAudioIODevice::setSpeed (double multipleOfRealtime)
+{
+    jassert (multipleOfRealtime >= 0);
+    speed = jmax (0.0, multipleOfRealtime);
+}
+
+double OfflineAudioIODevice::getSpeed() const noexcept
+{
+    return speed;
+}
+
+void OfflineAudioIODevice::setLengthInSamples (int64 numSamplesToRender)
+{
+    lengthInSamples = numSamplesToRender;
+}
+
+void OfflineAudioIODevice::setOutputFunction (OutputFunction newOutputFunction)
+{
+    const ScopedLock sl (callbackLock);
+    outputFunction = std::move (newOutputFunction);
+}
+
+bool OfflineAudioIODevice::waitForRenderToFinish (int timeOutMilliseconds)
+{
+    return renderFinished.wait (timeOutMilliseconds);
+}
+
+int64 OfflineAudioIODevice::getNumSamplesRendered() const noexcept
+{
+    return numSamplesRendered;
+}
+
+double OfflineAudioIODevice::getRenderSpeed() const noexcept
+{
+    auto endTime = isThreadRunning() ? Time::getMillisecondCounterHiRes() : renderEndTime.load();
+    auto elapsedMs = endTime - renderStartTime;
+
+    if (elapsedMs <= 0)
+        return 0;
+
+    return ((double) numSamplesRendered / currentSampleRate) / (elapsedMs * 0.001);
+}
+
+AudioProcessLoadMeasurer::Statistics OfflineAudioIODevice::getLoadStatistics() const
+{
+    return loadMeasurer.getStatistics();
+}
+
+//==============================================================================
+StringArray OfflineAudioIODevice::getOutputChannelNames()
+{
+    StringArray names;
+
+    for (int i = 0; i < numOutputs; ++i)
+        names.add ("Output " + String (i + 1));
+
+    return names;
+}
+
+StringArray OfflineAudioIODevice::getInputChannelNames()
+{
+    StringArray names;
+
+    for (int i = 0; i < numInputs; ++i)
+        names.add ("Input " + String (i + 1));
+
+    return names;
+}
+
+Array<double> OfflineAudioIODevice::getAvailableSampleRates()
+{
+    return { 22050.0, 32000.0, 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+}
+
+Array<int> OfflineAudioIODevice::getAvailableBufferSizes()
+{
+    Array<int> sizes;
+
+    for (int size = 16; size <= 8192; size *= 2)
+        sizes.add (size);
+
+    return sizes;
+}
+
+int OfflineAudioIODevice::getDefaultBufferSize()                  { return 512; }
+
+//==============================================================================
+String OfflineAudioIODevice::open (const BigInteger& inputChannels, const BigInteger& outputChannels,
+                                   double sampleRate, int bufferSizeSamples)
+{
+    close();
+
+    // Any sample rate or buffer size can be used, not just the ones listed by
+    // getAvailableSampleRates() and getAvailableBufferSizes()
+    if (sampleRate <= 0)
+        return "Invalid sample rate";
+
+    activeInputs = inputChannels;
+    activeInputs.setRange (numInputs, jmax (0, activeInputs.getHighestBit() + 1 - numInputs), false);
+    activeOutputs = outputChannels;
+    activeOutputs.setRange (numOutputs, jmax (0, activeOutputs.getHighestBit() + 1 - numOutputs), false);
+
+    currentSampleRate = sampleRate;
+    currentBufferSize = bufferSizeSamples > 0 ? bufferSizeSamples : getDefaultBufferSize();
+    deviceIsOpen = true;
+    return {};
+}
+
+void OfflineAudioIODevice::close()
+{
+    stop();
+    deviceIsOpen = false;
+}
+
+bool OfflineAudioIODevice::isOpen()                               { return deviceIsOpen; }
+
+void OfflineAudioIODevice::start (AudioIODeviceCallback* newCallback)
+{
+    if (! deviceIsOpen || newCallback == nullptr)
+        return;
+
+    stop();
+
+    newCallback->audioDeviceAboutToStart (this);
+
+    loadMeasurer.reset (currentSampleRate, currentBufferSize);
+    numSamplesRendered = 0;
+    renderFinished.reset();
+
+    {
+        const ScopedLock sl (callbackLock);
+        callback = newCallback;
+    }
+
+    startThread (9);
+}
+
+void OfflineAudioIODevice::stop()
+{
+    stopThread (5000);
+
+    AudioIODeviceCallback* oldCallback;
+
+    {
+        const ScopedLock sl (callbackLock);
+        oldCallback = callback;
+        callback = nullptr;
+    }
+
+    if (oldCallback != nullptr)
+        oldCallback->audioDeviceStopped();
+}
+
+bool OfflineAudioIODevice::isPlaying()
+{
+    const ScopedLock sl (callbackLock);
+    return callback != nullptr && ! renderFinished.wait (0);
+}
+
+String OfflineAudioIODevice::getLastError()                       { return {}; }
+int OfflineAudioIODevice::getCurrentBufferSizeSamples()           { return currentBufferSize; }
+double OfflineAudioIODevice::getCurrentSampleRate()               { return currentSampleRate; }
+int OfflineAudioIODevice::getCurrentBitDepth()                    { return 32; }
+BigInteger OfflineAudioIODevice::getActiveOutputChannels() const  { return activeOutputs; }
+BigInteger OfflineAudioIODevice::getActiveInputChannels() const   { return activeInputs; }
+int OfflineAudioIODevice::getOutputLatencyInSamples()             { return 0; }
+int OfflineAudioIODevice::getInputLatencyInSamples()              { return 0; }
+
+//==============================================================================
+void OfflineAudioIODevice::run()
+{
+    const auto numActiveInputs = activeInputs.countNumberOfSetBits();
+    const auto numActiveOutputs = activeOutputs.countNumberOfSetBits();
+    const auto bufferSize = currentBufferSize;
+
+    AudioBuffer<float> inputBuffer (jmax (1, numActiveInputs), bufferSize);
+    AudioBuffer<float> outputBuffer (jmax (1, numActiveOutputs), bufferSize);
+    inputBuffer.clear();
+
+    const auto length = lengthInSamples.load();
+    const auto startTime = Time::getMillisecondCounterHiRes();
+    renderStartTime = startTime;
+
+    while (! threadShouldExit())
+    {
+        auto numRendered = numSamplesRendered.load();
+
+        if (length > 0 && numRendered >= length)
+            break;
+
+        {
+            const ScopedLock sl (callbackLock);
+
+            if (callback != nullptr)
+            {
+                // the callback is allowed to overwrite its input buffers, so they have
+                // to be cleared again for each block
+                if (numActiveInputs > 0)
+                    inputBuffer.clear();
+
+                const AudioProcessLoadMeasurer::ScopedTimer timer (loadMeasurer);
+
+                callback->audioDeviceIOCallback (inputBuffer.getArrayOfReadPointers(), numActiveInputs,
+                                                 outputBuffer.getArrayOfWritePointers(), numActiveOutputs,
+                                                 bufferSize);
+            }
+            else
+            {
+                outputBuffer.clear();
+            }
+
+            if (outputFunction != nullptr)
+                outputFunction (outputBuffer.getArrayOfReadPointers(), numActiveOutputs,
+                                length > 0 ? (int) jmin ((int64) bufferSize, length - numRendered) : bufferSize);
+        }
+
+        numRendered += bufferSize;
+
+        if (length > 0)
+            numRendered = jmin (length, numRendered);
+
+        numSamplesRendered = numRendered;
+
+        auto currentSpeed = speed.load();
+
+        if (currentSpeed > 0)
+        {
+            auto targetTime = startTime + 1000.0 * (double) numRendered / (currentSampleRate * currentSpeed);
+            auto msToWait = (int) (targetTime - Time::getMillisecondCounterHiRes());
+
+            if (msToWait > 0)
+                wait (msToWait);
+        }
+    }
+
+    renderEndTime = Time::getMillisecondCounterHiRes();
+    renderFinished.signal();
+}
+
+//==============================================================================
+struct OfflineAudioIODeviceType  : public AudioIODeviceType
+{
+    OfflineAudioIODeviceType() : AudioIODeviceType ("Offline") {}
+
+    void scanForDevices() override {}
+    StringArray getDeviceNames (bool) const override                           { return StringArray ("Offline Renderer"); }
+    int getDefaultDeviceIndex (bool) const override                            { return 0; }
+    bool hasSeparateInputsAndOutputs() const override                          { return false; }
+
+    int getIndexOfDevice (AudioIODevice* device, bool asInput) const override
+    {
+        if (auto* d = dynamic_cast<OfflineAudioIODevice*> (device))
+            return getDeviceNames (asInput).indexOf (d->getName());
+
+        return -1;
+    }
+
+    AudioIODevice* createDevice (const String& outputName, const String& inputName) override
+    {
+        auto name = outputName.isNotEmpty() ? outputName : inputName;
+
+        if (getDeviceNames (false).contains (name))
+            return new OfflineAudioIODevice (name, 2, 2);
+
+        return nullptr;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OfflineAudioIODeviceType)
+};
+
+AudioIODeviceType* AudioIODeviceType::createAudioIODeviceType_Offline()
+{
+    return new OfflineAudioIODeviceType();
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct OfflineAudioIODeviceTests  : public UnitTest
+{
+    OfflineAudioIODeviceTests()  : UnitTest ("OfflineAudioIODevice", "Audio") {}
+
+    struct CountingCallback  : public AudioIODeviceCallback
+    {
+        void audioDeviceIOCallback (const float**, int, float** outputs, int numOutputs, int numSamples) override
+        {
+            for (int i = 0; i < numOutputs; ++i)
+                FloatVectorOperations::fill (outputs[i], 1.0f, numSamples);
+
+            ++numCallbacks;
+        }
+
+        void audioDeviceAboutToStart (AudioIODevice*) override  { stopped = false; }
+        void audioDeviceStopped() override                      { stopped = true; }
+
+        std::atomic<int> numCallbacks { 0 };
+        std::atomic<bool> stopped { false };
+    };
+
+    void runTest() override
+    {
+        beginTest ("Rendering a fixed length");
+        {
+            OfflineAudioIODevice device ("Test", 0, 2);
+            CountingCallback callback;
+            int64 numSamplesOutput = 0;
+            int numChannelsOutput = 0;
+            float total = 0;
+
+            device.setOutputFunction ([&] (const float* const* channels, int numChannels, int numSamples)
+            {
+                numSamplesOutput += numSamples;
+                numChannelsOutput = numChannels;
+
+                for (int i = 0; i < numSamples; ++i)
+                    total += channels[0][i];
+            });
+
+            device.setLengthInSamples (1000);
+            expect (device.open ({}, 3, 44100.0, 256).isEmpty());
+            device.start (&callback);
+            expect (device.waitForRenderToFinish (10000));
+            expect (! device.isPlaying());
+
+            expectEquals (callback.numCallbacks.load(), 4);
+            expectEquals (device.getNumSamplesRendered(), (int64) 1000);
+            expectEquals (numSamplesOutput, (int64) 1000);
+            expectEquals (numChannelsOutput, 2);
+            expectEquals (total, 1000.0f);
+
+            device.close();
+            expect (callback.stopped);
+            expectEquals (callback.numCallbacks.load(), 4);
+        }
+
+        beginTest ("Stopping");
+        {
+            OfflineAudioIODevice device ("Test", 0, 2);
+            CountingCallback callback;
+
+            expect (device.open ({}, 3, 44100.0, 64).isEmpty());
+            device.start (&callback);
+            expect (device.isPlaying());
+
+            for (int i = 0; i < 1000 && callback.numCallbacks < 10; ++i)
+                Thread::sleep (1);
+
+            expect (callback.numCallbacks >= 10);
+
+            device.stop();
+            expect (! device.isPlaying());
+            expect (callback.stopped);
+
+            auto numCallbacks = callback.numCallbacks.load();
+            expectEquals (device.getNumSamplesRendered(), (int64) numCallbacks * 64);
+
+            Thread::sleep (10);
+            expectEquals (callback.numCallbacks.load(), numCallbacks);
+        }
+
+        beginTest ("Device type");
+        {
+            std::unique_ptr<AudioIODeviceType> type (AudioIODeviceType::createAudioIODeviceType_Offline());
+            auto deviceName = type->getDeviceNames (false)[0];
+            std::unique_ptr<AudioIODevice> created (type->createDevice (deviceName, {}));
+            expect (created != nullptr);
+            expectEquals (type->getIndexOfDevice (created.get(), false), 0);
+
+            OfflineAudioIODevice other ("Another device", 0, 2);
+            expectEquals (type->getIndexOfDevice (&other, false), -1);
+            expectEquals (type->getIndexOfDevice (nullptr, false), -1);
+        }
+    }
+};
+
+static OfflineAudioIODeviceTests offlineAudioIODeviceTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,173 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    An AudioIODevice that isn't connected to any hardware, and which drives its
+    callback from a background thread either as fast as possible, or at a fixed
+    multiple of realtime.
+
+    This lets you run the same AudioIODeviceCallback objects that you'd normally
+    attach to a sound card (e.g. an AudioSourcePlayer or AudioProcessorPlayer) to
+    bounce audio to a file, or to benchmark them on a machine with no audio
+    hardware. The device can be opened with any sample rate and buffer size, its
+    inputs are silent, and the output of each block can be passed to a function -
+    for example, to write it to an AudioFormatWriter:
+
+    @code
+    OfflineAudioIODevice device ("Bounce", 0, 2);
+    device.setOutputFunction ([&] (const float* const* channels, int numChannels, int numSamples)
+    {
+        writer->writeFromFloatArrays (channels, numChannels, numSamples);
+    });
+
+    device.setLengthInSamples (44100 * 60);
+    device.open ({}, 3, 44100.0, 512);
+    device.start (&player);
+    device.waitForRenderToFinish (-1);
+    device.close();
+    @endcode
+
+    The time taken by each callback is recorded, and can be retrieved with
+    getLoadStatistics().
+
+    @see AudioIODeviceType::createAudioIODeviceType_Offline
+
+    @tags{Audio}
+*/
+class JUCE_API  OfflineAudioIODevice  : public AudioIODevice,
+                                        private Thread
+{
+public:
+    //==============================================================================
+    /** Creates a device with the given number of input and output channels. */
+    OfflineAudioIODevice (const String& deviceName, int numInputChannels, int numOutputChannels);
+
+    /** Destructor. */
+    ~OfflineAudioIODevice() override;
+
+    //==============================================================================
+    /** Sets how fast the device should run, as a multiple of realtime.
+
+        A value of 1.0 will make it run at the same rate that a real device would, 2.0
+        at twice that speed, and so on. A value of 0 (the default) makes it render
+        each block as soon as the previous one has finished.
+    */
+    void setSpeed (double multipleOfRealtime);
+
+    /** Returns the speed that was set with setSpeed(). */
+    double getSpeed() const noexcept;
+
+    /** Sets the number of samples that the device should render after being started,
+        after which it'll stop making callbacks. A value of zero or less (the default)
+        means that it keeps running until stop() is called.
+
+        If the length isn't a multiple of the buffer size, the last block will still
+        be a whole buffer, but only the part before the end will be passed to the
+        output function.
+
+        Once the length has been rendered, isPlaying() returns false, although the
+        callback's audioDeviceStopped() method isn't called until the device is stopped
+        or closed.
+    */
+    void setLengthInSamples (int64 numSamplesToRender);
+
+    /** A function that is called with the output of each block. */
+    using OutputFunction = std::function<void (const float* const* channels, int numChannels, int numSamples)>;
+
+    /** Sets a function which will be called on the rendering thread with the output of
+        each block, after the callback has been called. The channels passed to it are
+        the device's active output channels.
+    */
+    void setOutputFunction (OutputFunction newOutputFunction);
+
+    /** Waits until the length set by setLengthInSamples() has been rendered.
+        @param timeOutMilliseconds  the maximum time to wait, or -1 to wait forever
+        @returns true if rendering has finished, or false if it timed out
+    */
+    bool waitForRenderToFinish (int timeOutMilliseconds);
+
+    /** Returns the number of samples that have been rendered since the device was started. */
+    int64 getNumSamplesRendered() const noexcept;
+
+    /** Returns how fast the device has been running since it was started, as a
+        multiple of realtime.
+    */
+    double getRenderSpeed() const noexcept;
+
+    /** Returns statistics about the time taken by the callbacks since the device was
+        started.
+    */
+    AudioProcessLoadMeasurer::Statistics getLoadStatistics() const;
+
+    //==============================================================================
+    StringArray getOutputChannelNames() override;
+    StringArray getInputChannelNames() override;
+    Array<double> getAvailableSampleRates() override;
+    Array<int> getAvailableBufferSizes() override;
+    int getDefaultBufferSize() override;
+
+    String open (const BigInteger& inputChannels, const BigInteger& outputChannels,
+                 double sampleRate, int bufferSizeSamples) override;
+    void close() override;
+    bool isOpen() override;
+    void start (AudioIODeviceCallback*) override;
+    void stop() override;
+    bool isPlaying() override;
+    String getLastError() override;
+
+    int getCurrentBufferSizeSamples() override;
+    double getCurrentSampleRate() override;
+    int getCurrentBitDepth() override;
+    BigInteger getActiveOutputChannels() const override;
+    BigInteger getActiveInputChannels() const override;
+    int getOutputLatencyInSamples() override;
+    int getInputLatencyInSamples() override;
+
+private:
+    //==============================================================================
+    const int numInputs, numOutputs;
+    BigInteger activeInputs, activeOutputs;
+    double currentSampleRate = 44100.0;
+    int currentBufferSize = 512;
+    bool deviceIsOpen = false;
+
+    CriticalSection callbackLock;
+    AudioIODeviceCallback* callback = nullptr;
+    OutputFunction outputFunction;
+    AudioProcessLoadMeasurer loadMeasurer;
+    WaitableEvent renderFinished { true };
+
+    std::atomic<double> speed { 0.0 };
+    std::atomic<int64> lengthInSamples { 0 }, numSamplesRendered { 0 };
+    std::atomic<double> renderStartTime { 0.0 }, renderEndTime { 0.0 };
+
+    void run() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OfflineAudioIODevice)
+};
+
+} // namespace juce
@@ -883,6 +883,9 @@ public:
 
     void readMaxLevels (int64 startSampleInFile, int64 numSamples, Range<float>* results, int numChannelsToRead) override
     {
+        if (readMaxLevelsFromPeakIndex (startSampleInFile, numSamples, results, numChannelsToRead))
+            return;
+
         numSamples = jmin (numSamples, lengthInSamples - startSampleInFile);
 
         if (map == nullptr || numSamples <= 0 || ! mappedSection.contains (Range<int64> (startSampleInFile, startSampleInFile + numSamples)))
@@ -971,6 +974,97 @@ AudioFormatReader* AiffAudioFormat::createReaderFor (InputStream* sourceStream,
     return nullptr;
 }
 
+AudioFormat::ProbeResult AiffAudioFormat::probe (InputStream& in)
+{
+    using namespace AiffFileHelpers;
+
+    // This follows the same rules as AiffAudioFormatReader, but only looks at
+    // the COMM and SSND chunks, so it can stop as soon as it's seen them.
+    ProbeResult result;
+
+    if (in.readInt() != chunkName ("FORM"))
+        return result;
+
+    auto len = in.readIntBigEndian();
+    auto end = in.getPosition() + len;
+    auto nextType = in.readInt();
+
+    if (nextType != chunkName ("AIFF") && nextType != chunkName ("AIFC"))
+        return result;
+
+    bool hasGotType = false, hasGotData = false;
+    int bytesPerFrame = 0;
+
+    while (in.getPosition() < end && ! (hasGotType && hasGotData))
+    {
+        auto type = in.readInt();
+        auto length = (uint32) in.readIntBigEndian();
+        auto chunkEnd = in.getPosition() + length;
+
+        if (type == chunkName ("FVER"))
+        {
+            auto ver = in.readIntBigEndian();
+
+            if (ver != 0 && ver != (int) 0xa2805140)
+                break;
+        }
+        else if (type == chunkName ("COMM"))
+        {
+            hasGotType = true;
+
+            result.numChannels = (unsigned int) in.readShortBigEndian();
+            result.lengthInSamples = in.readIntBigEndian();
+            result.bitsPerSample = (unsigned int) in.readShortBigEndian();
+            bytesPerFrame = (int) ((result.numChannels * result.bitsPerSample) >> 3);
+
+            unsigned char sampleRateBytes[10];
+            in.read (sampleRateBytes, 10);
+            const int byte0 = sampleRateBytes[0];
+
+            if ((byte0 & 0x80) != 0
+                 || byte0 <= 0x3F || byte0 > 0x40
+                 || (byte0 == 0x40 && sampleRateBytes[1] > 0x1C))
+                break;
+
+            auto sampRate = ByteOrder::bigEndianInt (sampleRateBytes + 2);
+            sampRate >>= (16414 - ByteOrder::bigEndianShort (sampleRateBytes));
+            result.sampleRate = (int) sampRate;
+
+            if (length > 18)
+            {
+                auto compType = in.readInt();
+
+                if (compType == chunkName ("fl32") || compType == chunkName ("FL32"))
+                {
+                    result.usesFloatingPointData = true;
+                }
+                else if (compType != chunkName ("NONE") && compType != chunkName ("twos")
+                          && compType != chunkName ("sowt"))
+                {
+                    result.sampleRate = 0;
+                    break;
+                }
+            }
+        }
+        else if (type == chunkName ("SSND"))
+        {
+            hasGotData = true;
+            result.lengthInSamples = (bytesPerFrame > 0) ? jmin (result.lengthInSamples, ((int64) length) / (int64) bytesPerFrame) : 0;
+        }
+        else if (chunkEnd < in.getPosition() || in.isExhausted())
+        {
+            break;
+        }
+
+        in.setPosition (chunkEnd + (chunkEnd & 1)); // (chunks should be aligned to an even byte address)
+    }
+
+    if (result.sampleRate > 0 && result.numChannels > 0)
+        result.format = this;
+
+    return result;
+}
+
 MemoryMappedAudioFormatReader* AiffAudioFormat::createMemoryMappedReader (const File& file)
 {
     return createMemoryMappedReader (file.createInputStream());
@@ -377,6 +377,64 @@ private:
 };
 
 
+//==============================================================================
+static void setFlacEncoderOptions (FlacNamespace::FLAC__StreamEncoder* encoder, double sampleRate,
+                                   unsigned int numChannels, unsigned int bitsPerSample, int qualityOptionIndex)
+{
+    if (qualityOptionIndex > 0)
+        FLAC__stream_encoder_set_compression_level (encoder, (uint32) jmin (8, qualityOptionIndex));
+
+    FLAC__stream_encoder_set_do_mid_side_stereo (encoder, numChannels == 2);
+    FLAC__stream_encoder_set_loose_mid_side_stereo (encoder, numChannels == 2);
+    FLAC__stream_encoder_set_channels (encoder, numChannels);
+    FLAC__stream_encoder_set_bits_per_sample (encoder, jmin ((unsigned int) 24, bitsPerSample));
+    FLAC__stream_encoder_set_sample_rate (encoder, (unsigned int) sampleRate);
+    FLAC__stream_encoder_set_blocksize (encoder, 0);
+    FLAC__stream_encoder_set_do_escape_coding (encoder, true);
+}
+
+static void packUint32 (FlacNamespace::FLAC__uint32 val, FlacNamespace::FLAC__byte* b, const int bytes)
+{
+    b += bytes;
+
+    for (int i = 0; i < bytes; ++i)
+    {
+        *(--b) = (FlacNamespace::FLAC__byte) (val & 0xff);
+        val >>= 8;
+    }
+}
+
+static void writeFlacStreamInfo (OutputStream& output, int64 streamStartPos,
+                                 const FlacNamespace::FLAC__StreamMetadata_StreamInfo& info)
+{
+    using namespace FlacNamespace;
+
+    unsigned char buffer[FLAC__STREAM_METADATA_STREAMINFO_LENGTH];
+    const unsigned int channelsMinus1 = info.channels - 1;
+    const unsigned int bitsMinus1 = info.bits_per_sample - 1;
+
+    packUint32 (info.min_blocksize, buffer, 2);
+    packUint32 (info.max_blocksize, buffer + 2, 2);
+    packUint32 (info.min_framesize, buffer + 4, 3);
+    packUint32 (info.max_framesize, buffer + 7, 3);
+    buffer[10] = (uint8) ((info.sample_rate >> 12) & 0xff);
+    buffer[11] = (uint8) ((info.sample_rate >> 4) & 0xff);
+    buffer[12] = (uint8) (((info.sample_rate & 0x0f) << 4) | (channelsMinus1 << 1) | (bitsMinus1 >> 4));
+    buffer[13] = (FLAC__byte) (((bitsMinus1 & 0x0f) << 4) | (unsigned int) ((info.total_samples >> 32) & 0x0f));
+    packUint32 ((FLAC__uint32) info.total_samples, buffer + 14, 4);
+    memcpy (buffer + 18, info.md5sum, 16);
+
+    const bool seekOk = output.setPosition (streamStartPos + 4);
+    ignoreUnused (seekOk);
+
+    // if this fails, you've given it an output stream that can't seek! It needs
+    // to be able to seek back to write the header
+    jassert (seekOk);
+
+    output.writeIntBigEndian (FLAC__STREAM_METADATA_STREAMINFO_LENGTH);
+    output.write (buffer, FLAC__STREAM_METADATA_STREAMINFO_LENGTH);
+}
+
 //==============================================================================
 class FlacWriter  : public AudioFormatWriter
 {
@@ -386,17 +444,7 @@ public:
           streamStartPos (output != nullptr ? jmax (output->getPosition(), 0ll) : 0ll)
     {
         encoder = FlacNamespace::FLAC__stream_encoder_new();
-
-        if (qualityOptionIndex > 0)
-            FLAC__stream_encoder_set_compression_level (encoder, (uint32) jmin (8, qualityOptionIndex));
-
-        FLAC__stream_encoder_set_do_mid_side_stereo (encoder, numChannels == 2);
-        FLAC__stream_encoder_set_loose_mid_side_stereo (encoder, numChannels == 2);
-        FLAC__stream_encoder_set_channels (encoder, numChannels);
-        FLAC__stream_encoder_set_bits_per_sample (encoder, jmin ((unsigned int) 24, bitsPerSample));
-        FLAC__stream_encoder_set_sample_rate (encoder, (unsigned int) sampleRate);
-        FLAC__stream_encoder_set_blocksize (encoder, 0);
-        FLAC__stream_encoder_set_do_escape_coding (encoder, true);
+        setFlacEncoderOptions (encoder, sampleRate, numChannels, bitsPerSample, qualityOptionIndex);
 
         ok = FLAC__stream_encoder_init_stream (encoder,
                                                encodeWriteCallback, encodeSeekCallback,
@@ -458,46 +506,9 @@ public:
         return output->write (data, (size_t) size);
     }
 
-    static void packUint32 (FlacNamespace::FLAC__uint32 val, FlacNamespace::FLAC__byte* b, const int bytes)
-    {
-        b += bytes;
-
-        for (int i = 0; i < bytes; ++i)
-        {
-            *(--b) = (FlacNamespace::FLAC__byte) (val & 0xff);
-            val >>= 8;
-        }
-    }
-
     void writeMetaData (const FlacNamespace::FLAC__StreamMetadata* metadata)
     {
-        using namespace FlacNamespace;
-        auto& info = metadata->data.stream_info;
-
-        unsigned char buffer[FLAC__STREAM_METADATA_STREAMINFO_LENGTH];
-        const unsigned int channelsMinus1 = info.channels - 1;
-        const unsigned int bitsMinus1 = info.bits_per_sample - 1;
-
-        packUint32 (info.min_blocksize, buffer, 2);
-        packUint32 (info.max_blocksize, buffer + 2, 2);
-        packUint32 (info.min_framesize, buffer + 4, 3);
-        packUint32 (info.max_framesize, buffer + 7, 3);
-        buffer[10] = (uint8) ((info.sample_rate >> 12) & 0xff);
-        buffer[11] = (uint8) ((info.sample_rate >> 4) & 0xff);
-        buffer[12] = (uint8) (((info.sample_rate & 0x0f) << 4) | (channelsMinus1 << 1) | (bitsMinus1 >> 4));
-        buffer[13] = (FLAC__byte) (((bitsMinus1 & 0x0f) << 4) | (unsigned int) ((info.total_samples >> 32) & 0x0f));
-        packUint32 ((FLAC__uint32) info.total_samples, buffer + 14, 4);
-        memcpy (buffer + 18, info.md5sum, 16);
-
-        const bool seekOk = output->setPosition (streamStartPos + 4);
-        ignoreUnused (seekOk);
-
-        // if this fails, you've given it an output stream that can't seek! It needs
-        // to be able to seek back to write the header
-        jassert (seekOk);
-
-        output->writeIntBigEndian (FLAC__STREAM_METADATA_STREAMINFO_LENGTH);
-        output->write (buffer, FLAC__STREAM_METADATA_STREAMINFO_LENGTH);
+        writeFlacStreamInfo (*output, streamStartPos, metadata->data.stream_info);
     }
 
     //==============================================================================
@@ -541,6 +552,332 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FlacWriter)
 };
 
+#if JUCE_INCLUDE_FLAC_CODE || ! defined (JUCE_INCLUDE_FLAC_CODE)
+
+//==============================================================================
+// Splits the audio into groups of frames that are compressed independently on a thread
+// pool, and then joins the results back together into a single stream.
+class ParallelFlacWriter  : public AudioFormatWriter
+{
+public:
+    ParallelFlacWriter (OutputStream* out, double rate, uint32 numChans, uint32 bits,
+                        int qualityOption, ThreadPool& threadPool)
+        : AudioFormatWriter (out, flacFormatName, rate, numChans, bits),
+          pool (threadPool), qualityOptionIndex (qualityOption),
+          streamStartPos (output != nullptr ? jmax (output->getPosition(), 0ll) : 0ll)
+    {
+        // An encoder that's given no audio just writes the stream header, and tells us
+        // the block size that all the other encoders will end up using
+        auto* encoder = FlacNamespace::FLAC__stream_encoder_new();
+        setFlacEncoderOptions (encoder, sampleRate, numChannels, bitsPerSample, qualityOptionIndex);
+        FLAC__stream_encoder_set_do_md5 (encoder, false);
+
+        ok = headerWritten = FLAC__stream_encoder_init_stream (encoder, headerWriteCallback, nullptr, nullptr, nullptr, this)
+                                == FlacNamespace::FLAC__STREAM_ENCODER_INIT_STATUS_OK;
+
+        blockSize = (int) FLAC__stream_encoder_get_blocksize (encoder);
+        FlacNamespace::FLAC__stream_encoder_delete (encoder);
+
+        samplesPerJob = blockSize * framesPerJob;
+        maxJobsInProgress = jmax (2, pool.getNumThreads() * 2);
+        FlacNamespace::FLAC__MD5Init (&md5);
+
+        if (ok)
+            startNewJob();
+    }
+
+    ~ParallelFlacWriter() override
+    {
+        if (ok && currentJob->numSamples > 0)
+            launchCurrentJob();
+
+        // (if anything has failed, this just waits for the jobs and discards their output)
+        while (! jobsInProgress.isEmpty())
+            writeOldestJob();
+
+        FlacNamespace::FLAC__MD5Final (md5Sum, &md5);
+
+        if (ok)
+        {
+            writeStreamInfo();
+            output->flush();
+        }
+        else if (! headerWritten)
+        {
+            output = nullptr; // to stop the base class deleting this, as it needs to be returned
+                              // to the caller of createWriter()
+        }
+    }
+
+    //==============================================================================
+    bool write (const int** samplesToWrite, int numSamples) override
+    {
+        if (! ok)
+            return false;
+
+        auto bitsToShift = 32 - (int) bitsPerSample;
+        HeapBlock<FlacNamespace::FLAC__int32*> channels (numChannels);
+        int offset = 0;
+
+        while (offset < numSamples)
+        {
+            auto numToCopy = jmin (numSamples - offset, samplesPerJob - currentJob->numSamples);
+
+            for (unsigned int i = 0; i < numChannels; ++i)
+            {
+                auto* dest = currentJob->samples.get() + i * (size_t) samplesPerJob + currentJob->numSamples;
+                channels[i] = dest;
+
+                if (auto* src = samplesToWrite[i])
+                    for (int j = 0; j < numToCopy; ++j)
+                        dest[j] = (src[offset + j] >> bitsToShift);
+                else
+                    zeromem (dest, sizeof (int) * (size_t) numToCopy);
+            }
+
+            FlacNamespace::FLAC__MD5Accumulate (&md5, channels, numChannels, (unsigned) numToCopy, (bitsPerSample + 7) / 8);
+
+            currentJob->numSamples += numToCopy;
+            offset += numToCopy;
+
+            if (currentJob->numSamples == samplesPerJob)
+            {
+                launchCurrentJob();
+
+                if (! ok)
+                    return false;
+
+                startNewJob();
+            }
+        }
+
+        return true;
+    }
+
+    bool ok = false;
+
+private:
+    //==============================================================================
+    struct EncoderJob  : public ThreadPoolJob
+    {
+        EncoderJob (ParallelFlacWriter& w, int64 firstFrame)
+            : ThreadPoolJob ("FLAC encoder"), owner (w), firstFrameNumber (firstFrame)
+        {
+            samples.malloc (owner.numChannels * (size_t) owner.samplesPerJob);
+        }
+
+        JobStatus runJob() override
+        {
+            auto* encoder = FlacNamespace::FLAC__stream_encoder_new();
+            setFlacEncoderOptions (encoder, owner.sampleRate, owner.numChannels,
+                                   owner.bitsPerSample, owner.qualityOptionIndex);
+            FLAC__stream_encoder_set_do_md5 (encoder, false);
+
+            if (FLAC__stream_encoder_init_stream (encoder, frameWriteCallback, nullptr, nullptr, nullptr, this)
+                  == FlacNamespace::FLAC__STREAM_ENCODER_INIT_STATUS_OK)
+            {
+                HeapBlock<const FlacNamespace::FLAC__int32*> channels (owner.numChannels);
+
+                for (unsigned int i = 0; i < owner.numChannels; ++i)
+                    channels[i] = samples.get() + i * (size_t) owner.samplesPerJob;
+
+                ok = FLAC__stream_encoder_process (encoder, channels, (unsigned) numSamples) != 0;
+                ok = (FlacNamespace::FLAC__stream_encoder_finish (encoder) != 0) && ok;
+            }
+
+            FlacNamespace::FLAC__stream_encoder_delete (encoder);
+            samples.free();
+            return jobHasFinished;
+        }
+
+        // Each encoder numbers its frames from zero, so they need to be given their real
+        // numbers in the stream, which means re-writing the header and both checksums
+        bool appendFrame (const uint8* frame, size_t size, unsigned int frameNumberInJob)
+        {
+            const size_t fixedHeaderSize = 4;
+
+            if (size < fixedHeaderSize + 4 || (frame[1] & 1) != 0)
+                return false;
+
+            auto firstNumberByte = frame[fixedHeaderSize];
+            size_t oldNumberSize = 1;
+
+            if ((firstNumberByte & 0x80) != 0)
+                while (oldNumberSize < 7 && (firstNumberByte & (0x80 >> oldNumberSize)) != 0)
+                    ++oldNumberSize;
+
+            auto blockSizeCode  = frame[2] >> 4;
+            auto sampleRateCode = frame[2] & 15;
+            auto extraSize = (size_t) (blockSizeCode == 6 ? 1 : (blockSizeCode == 7 ? 2 : 0))
+                           + (size_t) (sampleRateCode == 12 ? 1 : ((sampleRateCode == 13 || sampleRateCode == 14) ? 2 : 0));
+
+            auto oldHeaderSize = fixedHeaderSize + oldNumberSize + extraSize;
+
+            if (size < oldHeaderSize + 3)
+                return false;
+
+            uint8 header[fixedHeaderSize + 6 + 4 + 1];
+            memcpy (header, frame, fixedHeaderSize);
+            auto headerSize = fixedHeaderSize + writeFrameNumber (header + fixedHeaderSize, firstFrameNumber + frameNumberInJob);
+            memcpy (header + headerSize, frame + fixedHeaderSize + oldNumberSize, extraSize);
+            headerSize += extraSize;
+            header[headerSize] = FlacNamespace::FLAC__crc8 (header, (unsigned) headerSize);
+            ++headerSize;
+
+            auto* body = frame + oldHeaderSize + 1;
+            auto bodySize = size - (oldHeaderSize + 1) - 2;
+
+            MemoryBlock newFrame (headerSize + bodySize + 2);
+            auto* dest = static_cast<uint8*> (newFrame.getData());
+            memcpy (dest, header, headerSize);
+            memcpy (dest + headerSize, body, bodySize);
+
+            auto newCrc = FlacNamespace::FLAC__crc16 (dest, (unsigned) (headerSize + bodySize));
+            dest[headerSize + bodySize]     = (uint8) (newCrc >> 8);
+            dest[headerSize + bodySize + 1] = (uint8) newCrc;
+
+            auto newSize = (unsigned int) newFrame.getSize();
+            minFrameSize = jmin (minFrameSize, newSize);
+            maxFrameSize = jmax (maxFrameSize, newSize);
+            return encoded.write (dest, newFrame.getSize());
+        }
+
+        // Frame numbers are stored using the same variable-length scheme as UTF-8
+        static size_t writeFrameNumber (uint8* dest, int64 number)
+        {
+            auto value = (uint64) number;
+
+            if (value < 0x80)
+            {
+                dest[0] = (uint8) value;
+                return 1;
+            }
+
+            size_t numBytes = 2;
+
+            while (numBytes < 6 && value >= ((uint64) 1 << (5 * numBytes + 1)))
+                ++numBytes;
+
+            dest[0] = (uint8) ((0xff00 >> numBytes) | (value >> (6 * (numBytes - 1))));
+
+            for (size_t i = 1; i < numBytes; ++i)
+                dest[i] = (uint8) (0x80 | ((value >> (6 * (numBytes - 1 - i))) & 0x3f));
+
+            return numBytes;
+        }
+
+        static FlacNamespace::FLAC__StreamEncoderWriteStatus frameWriteCallback (const FlacNamespace::FLAC__StreamEncoder*,
+                                                                                 const FlacNamespace::FLAC__byte buffer[],
+                                                                                 size_t bytes,
+                                                                                 unsigned int samples,
+                                                                                 unsigned int currentFrame,
+                                                                                 void* clientData)
+        {
+            // (the stream header has already been written, so any metadata can be skipped)
+            if (samples == 0)
+                return FlacNamespace::FLAC__STREAM_ENCODER_WRITE_STATUS_OK;
+
+            return static_cast<EncoderJob*> (clientData)->appendFrame (buffer, bytes, currentFrame)
+                    ? FlacNamespace::FLAC__STREAM_ENCODER_WRITE_STATUS_OK
+                    : FlacNamespace::FLAC__STREAM_ENCODER_WRITE_STATUS_FATAL_ERROR;
+        }
+
+        ParallelFlacWriter& owner;
+        const int64 firstFrameNumber;
+        HeapBlock<FlacNamespace::FLAC__int32> samples;
+        int numSamples = 0;
+        MemoryOutputStream encoded;
+        unsigned int minFrameSize = std::numeric_limits<unsigned int>::max(), maxFrameSize = 0;
+        bool ok = false;
+
+        JUCE_DECLARE_NON_COPYABLE (EncoderJob)
+    };
+
+    //==============================================================================
+    void startNewJob()
+    {
+        currentJob.reset (new EncoderJob (*this, numSamplesLaunched / blockSize));
+    }
+
+    void launchCurrentJob()
+    {
+        while (jobsInProgress.size() >= maxJobsInProgress
+                || (! jobsInProgress.isEmpty() && pool.waitForJobToFinish (jobsInProgress.getFirst(), 0)))
+            writeOldestJob();
+
+        numSamplesLaunched += currentJob->numSamples;
+        pool.addJob (currentJob.get(), false);
+        jobsInProgress.add (currentJob.release());
+    }
+
+    void writeOldestJob()
+    {
+        auto* job = jobsInProgress.getFirst();
+        pool.waitForJobToFinish (job, -1);
+
+        if (ok && job->ok && output->write (job->encoded.getData(), job->encoded.getDataSize()))
+        {
+            minFrameSize = jmin (minFrameSize, job->minFrameSize);
+            maxFrameSize = jmax (maxFrameSize, job->maxFrameSize);
+        }
+        else
+        {
+            ok = false;
+        }
+
+        jobsInProgress.remove (0);
+    }
+
+    void writeStreamInfo()
+    {
+        FlacNamespace::FLAC__StreamMetadata_StreamInfo info;
+        zerostruct (info);
+
+        info.min_blocksize   = (unsigned) blockSize;
+        info.max_blocksize   = (unsigned) blockSize;
+        info.min_framesize   = numSamplesLaunched > 0 ? minFrameSize : 0;
+        info.max_framesize   = maxFrameSize;
+        info.sample_rate     = (unsigned) sampleRate;
+        info.channels        = numChannels;
+        info.bits_per_sample = jmin ((unsigned int) 24, bitsPerSample);
+        info.total_samples   = (FlacNamespace::FLAC__uint64) numSamplesLaunched;
+        memcpy (info.md5sum, md5Sum, sizeof (md5Sum));
+
+        writeFlacStreamInfo (*output, streamStartPos, info);
+    }
+
+    static FlacNamespace::FLAC__StreamEncoderWriteStatus headerWriteCallback (const FlacNamespace::FLAC__StreamEncoder*,
+                                                                              const FlacNamespace::FLAC__byte buffer[],
+                                                                              size_t bytes,
+                                                                              unsigned int /*samples*/,
+                                                                              unsigned int /*currentFrame*/,
+                                                                              void* clientData)
+    {
+        return static_cast<ParallelFlacWriter*> (clientData)->output->write (buffer, bytes)
+                ? FlacNamespace::FLAC__STREAM_ENCODER_WRITE_STATUS_OK
+                : FlacNamespace::FLAC__STREAM_ENCODER_WRITE_STATUS_FATAL_ERROR;
+    }
+
+    //==============================================================================
+    enum { framesPerJob = 64 };
+
+    ThreadPool& pool;
+    const int qualityOptionIndex;
+    const int64 streamStartPos;
+    int blockSize = 0, samplesPerJob = 0, maxJobsInProgress = 0;
+    int64 numSamplesLaunched = 0;
+    bool headerWritten = false;
+    unsigned int minFrameSize = std::numeric_limits<unsigned int>::max(), maxFrameSize = 0;
+    FlacNamespace::FLAC__MD5Context md5;
+    FlacNamespace::FLAC__byte md5Sum[16];
+    std::unique_ptr<EncoderJob> currentJob;
+    OwnedArray<EncoderJob> jobsInProgress;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParallelFlacWriter)
+};
+
+#endif
+
 
 //==============================================================================
 FlacAudioFormat::FlacAudioFormat()  : AudioFormat (flacFormatName, ".flac") {}
@@ -574,6 +911,59 @@ AudioFormatReader* FlacAudioFormat::createReaderFor (InputStream* in, const bool
     return nullptr;
 }
 
+AudioFormat::ProbeResult FlacAudioFormat::probe (InputStream& in)
+{
+    ProbeResult result;
+    auto streamStartPos = in.getPosition();
+    uint8 header[10];
+
+    if (in.read (header, 4) != 4)
+        return result;
+
+    // like libFLAC, skip over any ID3v2 tag that precedes the stream marker
+    if (memcmp (header, "ID3", 3) == 0)
+    {
+        if (in.read (header + 4, 6) != 6 || ((header[6] | header[7] | header[8] | header[9]) & 0x80) != 0)
+            return result;
+
+        auto tagSize = (((int64) header[6]) << 21) | (((int64) header[7]) << 14)
+                     | (((int64) header[8]) << 7)  |  ((int64) header[9]);
+
+        in.setPosition (in.getPosition() + tagSize + ((header[5] & 0x10) != 0 ? 10 : 0));
+
+        if (in.read (header, 4) != 4)
+            return result;
+    }
+
+    if (memcmp (header, "fLaC", 4) != 0)
+        return result;
+
+    // the STREAMINFO block always comes first
+    uint8 info[38];
+
+    if (in.read (info, sizeof (info)) != (int) sizeof (info) || (info[0] & 0x7f) != 0)
+        return result;
+
+    const uint8* d = info + 4 + 10;
+    result.sampleRate = (int) ((((uint32) d[0]) << 12) | (((uint32) d[1]) << 4) | (d[2] >> 4));
+    result.numChannels = (unsigned int) ((d[2] >> 1) & 7) + 1;
+    result.bitsPerSample = (unsigned int) (((d[2] & 1) << 4) | (d[3] >> 4)) + 1;
+    result.lengthInSamples = (((int64) (d[3] & 15)) << 32) | (int64) ByteOrder::bigEndianInt (d + 4);
+
+    if (result.sampleRate <= 0)
+        return {};
+
+    if (result.lengthInSamples == 0)
+    {
+        // the length isn't in the metadata, so the reader will need to scan the whole stream for it
+        in.setPosition (streamStartPos);
+        return AudioFormat::probe (in);
+    }
+
+    result.format = this;
+    return result;
+}
+
 AudioFormatWriter* FlacAudioFormat::createWriterFor (OutputStream* out,
                                                      double sampleRate,
                                                      unsigned int numberOfChannels,
@@ -592,11 +982,122 @@ AudioFormatWriter* FlacAudioFormat::createWriterFor (OutputStream* out,
     return nullptr;
 }
 
+AudioFormatWriter* FlacAudioFormat::createWriterFor (OutputStream* out,
+                                                     double sampleRate,
+                                                     unsigned int numberOfChannels,
+                                                     int bitsPerSample,
+                                                     const StringPairArray& metadataValues,
+                                                     int qualityOptionIndex,
+                                                     ThreadPool* threadPool)
+{
+   #if JUCE_INCLUDE_FLAC_CODE || ! defined (JUCE_INCLUDE_FLAC_CODE)
+    if (threadPool != nullptr)
+    {
+        if (out != nullptr && getPossibleBitDepths().contains (bitsPerSample))
+        {
+            std::unique_ptr<ParallelFlacWriter> w (new ParallelFlacWriter (out, sampleRate, numberOfChannels,
+                                                                           (uint32) bitsPerSample, qualityOptionIndex,
+                                                                           *threadPool));
+            if (w->ok)
+                return w.release();
+        }
+
+        return nullptr;
+    }
+   #endif
+
+    return createWriterFor (out, sampleRate, numberOfChannels, bitsPerSample, metadataValues, qualityOptionIndex);
+}
+
 StringArray FlacAudioFormat::getQualityOptions()
 {
     return { "0 (Fastest)", "1", "2", "3", "4", "5 (Default)","6", "7", "8 (Highest quality)" };
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS && (JUCE_INCLUDE_FLAC_CODE || ! defined (JUCE_INCLUDE_FLAC_CODE))
+
+struct FlacAudioFormatTests  : public UnitTest
+{
+    FlacAudioFormatTests()  : UnitTest ("FLAC audio format", "Audio") {}
+
+    enum
+    {
+        numTestChannels = 2,
+        numTestSamples = 200000,
+        samplesPerWrite = 1000
+    };
+
+    MemoryBlock writeTestFile (const HeapBlock<int>& data, int qualityOptionIndex, ThreadPool* threadPool)
+    {
+        FlacAudioFormat format;
+        MemoryBlock block;
+
+        std::unique_ptr<AudioFormatWriter> writer (format.createWriterFor (new MemoryOutputStream (block, false),
+                                                                           44100.0, numTestChannels, 16, {},
+                                                                           qualityOptionIndex, threadPool));
+        expect (writer != nullptr);
+
+        for (int pos = 0; pos < numTestSamples; pos += samplesPerWrite)
+        {
+            const int* channels[] = { data + pos, data + numTestSamples + pos, nullptr };
+            expect (writer->write (channels, jmin ((int) samplesPerWrite, numTestSamples - pos)));
+        }
+
+        writer.reset();
+        return block;
+    }
+
+    void expectFileMatchesData (const MemoryBlock& file, const HeapBlock<int>& data)
+    {
+        FlacAudioFormat format;
+        std::unique_ptr<AudioFormatReader> reader (format.createReaderFor (new MemoryInputStream (file, false), true));
+        expect (reader != nullptr);
+        expectEquals (reader->lengthInSamples, (int64) numTestSamples);
+
+        HeapBlock<int> decoded ((size_t) (numTestChannels * numTestSamples));
+        int* channels[] = { decoded, decoded + numTestSamples, nullptr };
+        expect (reader->read (channels, numTestChannels, 0, numTestSamples, false));
+        expect (memcmp (decoded, data, sizeof (int) * (size_t) (numTestChannels * numTestSamples)) == 0);
+    }
+
+    void runTest() override
+    {
+        auto r = getRandom();
+        HeapBlock<int> data ((size_t) (numTestChannels * numTestSamples));
+
+        for (int i = 0; i < numTestSamples; ++i)
+        {
+            auto tone = 10000.0 * std::sin (i * 0.01);
+            data[i]                  = (roundToInt (tone) + r.nextInt (200) - 100) << 16;
+            data[numTestSamples + i] = (roundToInt (tone * 0.5) + r.nextInt (2000) - 1000) << 16;
+        }
+
+        ThreadPool pool (2);
+
+        for (int quality : { 0, 5 })
+        {
+            beginTest ("Parallel encoding, compression level " + String (quality));
+
+            auto serial = writeTestFile (data, quality, nullptr);
+            auto parallel = writeTestFile (data, quality, &pool);
+
+            expectFileMatchesData (serial, data);
+            expectFileMatchesData (parallel, data);
+
+            // both writers should have calculated the same MD5 signature of the audio
+            const size_t md5Offset = 4 + 4 + 18;
+            expect (parallel.getSize() > md5Offset + 16);
+            expect (memcmp (addBytesToPointer (serial.getData(), md5Offset),
+                            addBytesToPointer (parallel.getData(), md5Offset), 16) == 0);
+        }
+    }
+};
+
+static FlacAudioFormatTests flacAudioFormatTests;
+
+#endif
+
 #endif
 
 } // namespace juce
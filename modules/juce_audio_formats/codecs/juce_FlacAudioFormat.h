@@ -58,12 +58,36 @@ public:
     AudioFormatReader* createReaderFor (InputStream* sourceStream,
                                         bool deleteStreamIfOpeningFails) override;
 
+    ProbeResult probe (InputStream&) override;
+
     AudioFormatWriter* createWriterFor (OutputStream* streamToWriteTo,
                                         double sampleRateToUse,
                                         unsigned int numberOfChannels,
                                         int bitsPerSample,
                                         const StringPairArray& metadataValues,
                                         int qualityOptionIndex) override;
+
+    /** Creates a writer that uses several threads to compress the audio.
+
+        This takes the same parameters as the other createWriterFor() method, but the audio
+        that gets written is split up into groups of frames, which are compressed at the same
+        time by jobs running on the thread pool that you provide, and then joined back together
+        into a single stream. For long files, especially at the higher compression levels, this
+        can be a lot quicker than the normal writer.
+
+        The thread pool must not be deleted until the writer has been deleted, and the output
+        stream must be able to seek, as the stream's header is re-written when the writer is
+        deleted. If the thread pool is nullptr, or if the FLAC library that's being used isn't
+        the one that comes with JUCE, this just returns a normal single-threaded writer.
+    */
+    AudioFormatWriter* createWriterFor (OutputStream* streamToWriteTo,
+                                        double sampleRateToUse,
+                                        unsigned int numberOfChannels,
+                                        int bitsPerSample,
+                                        const StringPairArray& metadataValues,
+                                        int qualityOptionIndex,
+                                        ThreadPool* threadPool);
+
 private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FlacAudioFormat)
 };
@@ -43,6 +43,12 @@ namespace juce
 namespace MP3Decoder
 {
 
+#if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+ #define JUCE_MP3_USE_SIMD 1
+#else
+ #define JUCE_MP3_USE_SIMD 0
+#endif
+
 struct AllocationTable  { int16 bits, d; };
 
 const struct AllocationTable allocTable0[] =
@@ -490,6 +496,18 @@ struct MP3Frame
         return frequencies[sampleRateIndex];
     }
 
+    static bool isValidHeader (uint32 header, int oldLayer) noexcept
+    {
+        int newLayer = 4 - ((header >> 17) & 3);
+
+        return (header & 0xffe00000) == 0xffe00000
+                && newLayer != 4
+                && (oldLayer <= 0 || newLayer == oldLayer)
+                && ((header >> 12) & 15) != 15
+                && ((header >> 10) & 3) != 3
+                && (header & 3) != 2;
+    }
+
     void decodeHeader (const uint32 header)
     {
         jassert (((header >> 10) & 3) != 3);
@@ -590,6 +608,13 @@ struct Constants
     float decodeWin[512 + 32];
     float* cosTables[5];
 
+   #if JUCE_MP3_USE_SIMD
+    // The synthesis window re-arranged so that the coefficients needed for the same
+    // term of adjacent output samples are next to each other
+    float synthesisWindowForwards[32][16];
+    float synthesisWindowBackwards[33][16];
+   #endif
+
 private:
     int mapbuf0[9][152];
     int mapbuf1[9][156];
@@ -632,6 +657,16 @@ private:
             if (i % 32 == 31) table -= 1023;
             if (i % 64 == 63) scaleval = -scaleval;
         }
+
+       #if JUCE_MP3_USE_SIMD
+        for (i = 0; i < 32; ++i)
+            for (j = 0; j < 16; ++j)
+                synthesisWindowForwards[i][j] = decodeWin[32 * j + i];
+
+        for (i = 0; i < 33; ++i)
+            for (j = 0; j < 16; ++j)
+                synthesisWindowBackwards[i][j] = decodeWin[480 + i - 32 * (15 - j)];
+       #endif
     }
 
     void initLayer2Tables()
@@ -862,6 +897,235 @@ private:
 
 static const Constants constants;
 
+//==============================================================================
+/*  The layer 3 alias reduction, IMDCT and the polyphase synthesis window are
+    vectorised by working on four independent sub-bands (or four output samples)
+    at once. Each lane performs exactly the same operations in the same order as
+    the scalar code, so the results are identical to it, unless the compiler has
+    been allowed to fuse multiply-adds differently in the two versions.
+*/
+namespace Kernels
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    struct Lanes
+    {
+        static forcedinline Lanes load (const float* src) noexcept                       { return { _mm_loadu_ps (src) }; }
+        static forcedinline Lanes fromValues (float a, float b, float c, float d) noexcept { return { _mm_setr_ps (a, b, c, d) }; }
+        forcedinline void store (float* dest) const noexcept                             { _mm_storeu_ps (dest, value); }
+        forcedinline Lanes reversed() const noexcept                                     { return { _mm_shuffle_ps (value, value, _MM_SHUFFLE (0, 1, 2, 3)) }; }
+
+        forcedinline Lanes operator+ (Lanes other) const noexcept                        { return { _mm_add_ps (value, other.value) }; }
+        forcedinline Lanes operator- (Lanes other) const noexcept                        { return { _mm_sub_ps (value, other.value) }; }
+        forcedinline Lanes operator* (Lanes other) const noexcept                        { return { _mm_mul_ps (value, other.value) }; }
+        forcedinline Lanes operator* (float other) const noexcept                        { return { _mm_mul_ps (value, _mm_set1_ps (other)) }; }
+        forcedinline Lanes operator-() const noexcept                                    { return { _mm_xor_ps (value, _mm_set1_ps (-0.0f)) }; }
+
+        static forcedinline void transpose (Lanes& a, Lanes& b, Lanes& c, Lanes& d) noexcept
+        {
+            _MM_TRANSPOSE4_PS (a.value, b.value, c.value, d.value);
+        }
+
+        __m128 value;
+    };
+   #elif JUCE_USE_ARM_NEON
+    struct Lanes
+    {
+        static forcedinline Lanes load (const float* src) noexcept                       { return { vld1q_f32 (src) }; }
+        static forcedinline Lanes fromValues (float a, float b, float c, float d) noexcept { const float values[] = { a, b, c, d }; return load (values); }
+        forcedinline void store (float* dest) const noexcept                             { vst1q_f32 (dest, value); }
+        forcedinline Lanes reversed() const noexcept                                     { auto r = vrev64q_f32 (value); return { vcombine_f32 (vget_high_f32 (r), vget_low_f32 (r)) }; }
+
+        forcedinline Lanes operator+ (Lanes other) const noexcept                        { return { vaddq_f32 (value, other.value) }; }
+        forcedinline Lanes operator- (Lanes other) const noexcept                        { return { vsubq_f32 (value, other.value) }; }
+        forcedinline Lanes operator* (Lanes other) const noexcept                        { return { vmulq_f32 (value, other.value) }; }
+        forcedinline Lanes operator* (float other) const noexcept                        { return { vmulq_n_f32 (value, other) }; }
+        forcedinline Lanes operator-() const noexcept                                    { return { vnegq_f32 (value) }; }
+
+        static forcedinline void transpose (Lanes& a, Lanes& b, Lanes& c, Lanes& d) noexcept
+        {
+            auto ab = vtrnq_f32 (a.value, b.value);
+            auto cd = vtrnq_f32 (c.value, d.value);
+            a.value = vcombine_f32 (vget_low_f32  (ab.val[0]), vget_low_f32  (cd.val[0]));
+            b.value = vcombine_f32 (vget_low_f32  (ab.val[1]), vget_low_f32  (cd.val[1]));
+            c.value = vcombine_f32 (vget_high_f32 (ab.val[0]), vget_high_f32 (cd.val[0]));
+            d.value = vcombine_f32 (vget_high_f32 (ab.val[1]), vget_high_f32 (cd.val[1]));
+        }
+
+        float32x4_t value;
+    };
+   #endif
+
+   #if JUCE_MP3_USE_SIMD
+    static forcedinline Lanes& operator+= (Lanes& a, Lanes b) noexcept    { return a = a + b; }
+    static forcedinline Lanes& operator-= (Lanes& a, Lanes b) noexcept    { return a = a - b; }
+
+    static forcedinline void store (float* dest, Lanes value) noexcept    { value.store (dest); }
+
+    // Loads four values from each of four rows, and transposes them so that each of
+    // the results holds one column, i.e. the same element from all four rows
+    static forcedinline void loadColumns (const float* firstRow, int rowStride, Lanes* columns) noexcept
+    {
+        for (int i = 0; i < 4; ++i)
+            columns[i] = Lanes::load (firstRow + i * rowStride);
+
+        Lanes::transpose (columns[0], columns[1], columns[2], columns[3]);
+    }
+   #endif
+
+    static forcedinline void store (float* dest, float value) noexcept    { *dest = value; }
+
+    template <typename Value> Value load (const float*) noexcept;
+    template <> forcedinline float load (const float* src) noexcept       { return *src; }
+
+   #if JUCE_MP3_USE_SIMD
+    template <> forcedinline Lanes load (const float* src) noexcept       { return Lanes::load (src); }
+   #endif
+
+    //==============================================================================
+    // Performs the alias-reduction butterflies across the given number of sub-band
+    // boundaries, where xr1 points to the first sample above the first boundary.
+    template <bool useSIMD>
+    static void antialias (float* xr1, int numBoundaries) noexcept
+    {
+       #if JUCE_MP3_USE_SIMD
+        if (useSIMD)
+        {
+            auto cs0 = Lanes::load (constants.antiAliasingCs), cs1 = Lanes::load (constants.antiAliasingCs + 4);
+            auto ca0 = Lanes::load (constants.antiAliasingCa), ca1 = Lanes::load (constants.antiAliasingCa + 4);
+
+            for (; numBoundaries > 0; --numBoundaries, xr1 += 18)
+            {
+                auto bu0 = Lanes::load (xr1 - 4).reversed();
+                auto bu1 = Lanes::load (xr1 - 8).reversed();
+                auto bd0 = Lanes::load (xr1);
+                auto bd1 = Lanes::load (xr1 + 4);
+
+                ((bu0 * cs0) - (bd0 * ca0)).reversed().store (xr1 - 4);
+                ((bu1 * cs1) - (bd1 * ca1)).reversed().store (xr1 - 8);
+                ((bd0 * cs0) + (bu0 * ca0)).store (xr1);
+                ((bd1 * cs1) + (bu1 * ca1)).store (xr1 + 4);
+            }
+
+            return;
+        }
+       #endif
+
+        for (; numBoundaries > 0; --numBoundaries, xr1 += 10)
+        {
+            auto* cs = constants.antiAliasingCs;
+            auto* ca = constants.antiAliasingCa;
+            auto* xr2 = xr1;
+
+            for (int ss = 7; ss >= 0; --ss)
+            {
+                const float bu = *--xr2, bd = *xr1;
+                *xr2   = (bu * *cs)   - (bd * *ca);
+                *xr1++ = (bd * *cs++) + (bu * *ca++);
+            }
+        }
+    }
+
+    //==============================================================================
+    // The synthesis buffers hold 16 slots, each of which is a column of 17 values
+    // written by a call to dct64()
+    enum { synthSlotSize = 17 };
+
+    static forcedinline float windowForwards (const float* window, const float* b0) noexcept
+    {
+        auto sum = window[0] * b0[0];  sum -= window[1] * b0[1 * synthSlotSize];
+        sum += window[2]  * b0[2  * synthSlotSize];   sum -= window[3]  * b0[3  * synthSlotSize];
+        sum += window[4]  * b0[4  * synthSlotSize];   sum -= window[5]  * b0[5  * synthSlotSize];
+        sum += window[6]  * b0[6  * synthSlotSize];   sum -= window[7]  * b0[7  * synthSlotSize];
+        sum += window[8]  * b0[8  * synthSlotSize];   sum -= window[9]  * b0[9  * synthSlotSize];
+        sum += window[10] * b0[10 * synthSlotSize];   sum -= window[11] * b0[11 * synthSlotSize];
+        sum += window[12] * b0[12 * synthSlotSize];   sum -= window[13] * b0[13 * synthSlotSize];
+        sum += window[14] * b0[14 * synthSlotSize];   sum -= window[15] * b0[15 * synthSlotSize];
+        return sum;
+    }
+
+    static forcedinline float windowBackwards (const float* window, const float* b0) noexcept
+    {
+        auto sum = -window[-1] * b0[0];  sum -= window[-2] * b0[1 * synthSlotSize];
+        sum -= window[-3]  * b0[2  * synthSlotSize];   sum -= window[-4]  * b0[3  * synthSlotSize];
+        sum -= window[-5]  * b0[4  * synthSlotSize];   sum -= window[-6]  * b0[5  * synthSlotSize];
+        sum -= window[-7]  * b0[6  * synthSlotSize];   sum -= window[-8]  * b0[7  * synthSlotSize];
+        sum -= window[-9]  * b0[8  * synthSlotSize];   sum -= window[-10] * b0[9  * synthSlotSize];
+        sum -= window[-11] * b0[10 * synthSlotSize];   sum -= window[-12] * b0[11 * synthSlotSize];
+        sum -= window[-13] * b0[12 * synthSlotSize];   sum -= window[-14] * b0[13 * synthSlotSize];
+        sum -= window[-15] * b0[14 * synthSlotSize];   sum -= window[0]   * b0[15 * synthSlotSize];
+        return sum;
+    }
+
+    // Applies the synthesis window to the output of the polyphase DCT, producing 32 samples
+    template <bool useSIMD>
+    static void applySynthesisWindow (const float* b0, int bo1, float* out) noexcept
+    {
+        const float* window = constants.decodeWin + 16 - bo1;
+        int j = 0;
+
+       #if JUCE_MP3_USE_SIMD
+        if (useSIMD)
+        {
+            auto* table = constants.synthesisWindowForwards[16 - bo1];
+
+            for (; j < 16; j += 4)
+            {
+                auto sum = Lanes::load (table + j) * Lanes::load (b0 + j);
+
+                for (int k = 1; k < 15; k += 2)
+                {
+                    sum -= Lanes::load (table + 16 * k + j)       * Lanes::load (b0 + synthSlotSize * k + j);
+                    sum += Lanes::load (table + 16 * (k + 1) + j) * Lanes::load (b0 + synthSlotSize * (k + 1) + j);
+                }
+
+                sum -= Lanes::load (table + 16 * 15 + j) * Lanes::load (b0 + synthSlotSize * 15 + j);
+                sum.store (out + j);
+            }
+        }
+       #endif
+
+        for (; j < 16; ++j)
+            out[j] = windowForwards (window + 32 * j, b0 + j);
+
+        {
+            window += 32 * 16;
+            auto* b = b0 + 16;
+            auto sum = window[0] * b[0];   sum += window[2] * b[2 * synthSlotSize];
+            sum += window[4]  * b[4  * synthSlotSize];   sum += window[6]  * b[6  * synthSlotSize];
+            sum += window[8]  * b[8  * synthSlotSize];   sum += window[10] * b[10 * synthSlotSize];
+            sum += window[12] * b[12 * synthSlotSize];   sum += window[14] * b[14 * synthSlotSize];
+            out[16] = sum;
+            window += (bo1 << 1) - 32;
+        }
+
+        // The remaining outputs use rows 15 down to 1 of the buffer
+        j = 0;
+        out += 17;
+
+       #if JUCE_MP3_USE_SIMD
+        if (useSIMD)
+        {
+            auto* table = constants.synthesisWindowBackwards[15 + bo1];
+
+            for (; j < 12; j += 4)
+            {
+                auto row = 12 - j;
+                auto sum = -(Lanes::load (table + row) * Lanes::load (b0 + row));
+
+                for (int k = 1; k < 15; ++k)
+                    sum -= Lanes::load (table - 16 * k + row) * Lanes::load (b0 + synthSlotSize * k + row);
+
+                sum -= Lanes::load (table + 16 + row) * Lanes::load (b0 + synthSlotSize * 15 + row);
+                sum.reversed().store (out + j);
+            }
+        }
+       #endif
+
+        for (; j < 15; ++j)
+            out[j] = windowBackwards (window - 32 * j, b0 + 15 - j);
+    }
+}
+
 
 //==============================================================================
 struct Layer3SideInfo
@@ -883,19 +1147,7 @@ struct Layer3SideInfo
             else
                 sb = (int) maxb - 1;
 
-            for (; sb != 0; --sb, xr1 += 10)
-            {
-                auto* cs = constants.antiAliasingCs;
-                auto* ca = constants.antiAliasingCa;
-                auto* xr2 = xr1;
-
-                for (int ss = 7; ss >= 0; --ss)
-                {
-                    const float bu = *--xr2, bd = *xr1;
-                    *xr2   = (bu * *cs)   - (bd * *ca);
-                    *xr1++ = (bd * *cs++) + (bu * *ca++);
-                }
-            }
+            Kernels::antialias<JUCE_MP3_USE_SIMD != 0> (xr1, sb);
         }
 
         void doIStereo (float xrBuffer[2][32][18], const int* scaleFactors,
@@ -1075,24 +1327,32 @@ namespace DCT
     static const float cos36[] = { 0.501909912f, 0.517638087f, 0.551688969f, 0.610387266f, 0.707106769f, 0.871723413f, 1.18310082f, 1.93185163f, 5.73685646f };
     static const float cos12[] = { 0.517638087f, 0.707106769f, 1.93185163f };
 
-    inline void dct36_0 (int v, float* ts, float* out1, float* out2, const float* wintab, float sum0, float sum1) noexcept
+    /*  The IMDCT functions work on either a single float, or a Kernels::Lanes object holding
+        four adjacent sub-bands. The overlap buffers (out1, out2) are laid out like the ts
+        output, with the sub-bands of each sample next to each other.
+    */
+    template <typename Value>
+    forcedinline void dct36_0 (int v, float* ts, const float* out1, float* out2, const Value* wintab, Value sum0, Value sum1) noexcept
     {
+        using namespace Kernels;
         auto tmp = sum0 + sum1;
-        out2[9 + v] = tmp * wintab[27 + v];
-        out2[8 - v] = tmp * wintab[26 - v];
+        store (out2 + subBandLimit * (9 + v), tmp * wintab[27 + v]);
+        store (out2 + subBandLimit * (8 - v), tmp * wintab[26 - v]);
         sum0 -= sum1;
-        ts[subBandLimit * (8 - v)] = out1[8 - v] + sum0 * wintab[8 - v];
-        ts[subBandLimit * (9 + v)] = out1[9 + v] + sum0 * wintab[9 + v];
+        store (ts + subBandLimit * (8 - v), load<Value> (out1 + subBandLimit * (8 - v)) + sum0 * wintab[8 - v]);
+        store (ts + subBandLimit * (9 + v), load<Value> (out1 + subBandLimit * (9 + v)) + sum0 * wintab[9 + v]);
     }
 
-    inline void dct36_12 (int v1, int v2, float* ts, float* out1, float* out2, const float* wintab,
-                          float tmp1a, float tmp1b, float tmp2a, float tmp2b) noexcept
+    template <typename Value>
+    forcedinline void dct36_12 (int v1, int v2, float* ts, const float* out1, float* out2, const Value* wintab,
+                                Value tmp1a, Value tmp1b, Value tmp2a, Value tmp2b) noexcept
     {
         dct36_0 (v1, ts, out1, out2, wintab, tmp1a + tmp2a, (tmp1b + tmp2b) * cos36[v1]);
         dct36_0 (v2, ts, out1, out2, wintab, tmp2a - tmp1a, (tmp2b - tmp1b) * cos36[v2]);
     }
 
-    static void dct36 (float* in, float* out1, float* out2, const float* wintab, float* ts) noexcept
+    template <typename Value>
+    static void dct36 (Value* in, const float* out1, float* out2, const Value* wintab, float* ts) noexcept
     {
         in[17] += in[16]; in[16] += in[15]; in[15] += in[14]; in[14] += in[13]; in[13] += in[12];
         in[12] += in[11]; in[11] += in[10]; in[10] += in[9];  in[9]  += in[8];  in[8]  += in[7];
@@ -1166,11 +1426,11 @@ namespace DCT
     {
         {
             ts[0] = out1[0];
-            ts[subBandLimit * 1] = out1[1];
-            ts[subBandLimit * 2] = out1[2];
-            ts[subBandLimit * 3] = out1[3];
-            ts[subBandLimit * 4] = out1[4];
-            ts[subBandLimit * 5] = out1[5];
+            ts[subBandLimit * 1] = out1[subBandLimit * 1];
+            ts[subBandLimit * 2] = out1[subBandLimit * 2];
+            ts[subBandLimit * 3] = out1[subBandLimit * 3];
+            ts[subBandLimit * 4] = out1[subBandLimit * 4];
+            ts[subBandLimit * 5] = out1[subBandLimit * 5];
 
             DCT12Inputs inputs (in);
 
@@ -1180,23 +1440,23 @@ namespace DCT
                 auto tmp0 = tmp1 + tmp2;
                 tmp1 -= tmp2;
 
-                ts[16 * subBandLimit] = out1[16] + tmp0 * wi[10];
-                ts[13 * subBandLimit] = out1[13] + tmp0 * wi[7];
-                ts[7  * subBandLimit] = out1[7]  + tmp1 * wi[1];
-                ts[10 * subBandLimit] = out1[10] + tmp1 * wi[4];
+                ts[16 * subBandLimit] = out1[subBandLimit * 16] + tmp0 * wi[10];
+                ts[13 * subBandLimit] = out1[subBandLimit * 13] + tmp0 * wi[7];
+                ts[7  * subBandLimit] = out1[subBandLimit * 7]  + tmp1 * wi[1];
+                ts[10 * subBandLimit] = out1[subBandLimit * 10] + tmp1 * wi[4];
             }
 
             inputs.process();
 
-            ts[17 * subBandLimit] = out1[17] + inputs.in2 * wi[11];
-            ts[12 * subBandLimit] = out1[12] + inputs.in2 * wi[6];
-            ts[14 * subBandLimit] = out1[14] + inputs.in3 * wi[8];
-            ts[15 * subBandLimit] = out1[15] + inputs.in3 * wi[9];
+            ts[17 * subBandLimit] = out1[subBandLimit * 17] + inputs.in2 * wi[11];
+            ts[12 * subBandLimit] = out1[subBandLimit * 12] + inputs.in2 * wi[6];
+            ts[14 * subBandLimit] = out1[subBandLimit * 14] + inputs.in3 * wi[8];
+            ts[15 * subBandLimit] = out1[subBandLimit * 15] + inputs.in3 * wi[9];
 
-            ts[6  * subBandLimit] = out1[6]  + inputs.in0 * wi[0];
-            ts[11 * subBandLimit] = out1[11] + inputs.in0 * wi[5];
-            ts[8  * subBandLimit] = out1[8]  + inputs.in4 * wi[2];
-            ts[9  * subBandLimit] = out1[9]  + inputs.in4 * wi[3];
+            ts[6  * subBandLimit] = out1[subBandLimit * 6]  + inputs.in0 * wi[0];
+            ts[11 * subBandLimit] = out1[subBandLimit * 11] + inputs.in0 * wi[5];
+            ts[8  * subBandLimit] = out1[subBandLimit * 8]  + inputs.in4 * wi[2];
+            ts[9  * subBandLimit] = out1[subBandLimit * 9]  + inputs.in4 * wi[3];
         }
 
         {
@@ -1205,17 +1465,17 @@ namespace DCT
             auto tmp2 = (inputs.in1 - inputs.in5) * cos12[1];
             auto tmp0 = tmp1 + tmp2;
             tmp1 -= tmp2;
-            out2[4] = tmp0 * wi[10];
-            out2[1] = tmp0 * wi[7];
+            out2[subBandLimit * 4] = tmp0 * wi[10];
+            out2[subBandLimit * 1] = tmp0 * wi[7];
             ts[13 * subBandLimit] += tmp1 * wi[1];
             ts[16 * subBandLimit] += tmp1 * wi[4];
 
             inputs.process();
 
-            out2[5] = inputs.in2 * wi[11];
+            out2[subBandLimit * 5] = inputs.in2 * wi[11];
             out2[0] = inputs.in2 * wi[6];
-            out2[2] = inputs.in3 * wi[8];
-            out2[3] = inputs.in3 * wi[9];
+            out2[subBandLimit * 2] = inputs.in3 * wi[8];
+            out2[subBandLimit * 3] = inputs.in3 * wi[9];
             ts[12 * subBandLimit] += inputs.in0 * wi[0];
             ts[17 * subBandLimit] += inputs.in0 * wi[5];
             ts[14 * subBandLimit] += inputs.in4 * wi[2];
@@ -1224,28 +1484,28 @@ namespace DCT
 
         {
             DCT12Inputs inputs (++in);
-            out2[12] = out2[13] = out2[14] = out2[15] = out2[16] = out2[17] = 0;
+            out2[subBandLimit * 12] = out2[subBandLimit * 13] = out2[subBandLimit * 14] = out2[subBandLimit * 15] = out2[subBandLimit * 16] = out2[subBandLimit * 17] = 0;
 
             auto tmp1 = (inputs.in0 - inputs.in4);
             auto tmp2 = (inputs.in1 - inputs.in5) * cos12[1];
             auto tmp0 = tmp1 + tmp2;
             tmp1 -= tmp2;
 
-            out2[10] = tmp0 * wi[10];
-            out2[7]  = tmp0 * wi[7];
-            out2[1] += tmp1 * wi[1];
-            out2[4] += tmp1 * wi[4];
+            out2[subBandLimit * 10] = tmp0 * wi[10];
+            out2[subBandLimit * 7]  = tmp0 * wi[7];
+            out2[subBandLimit * 1] += tmp1 * wi[1];
+            out2[subBandLimit * 4] += tmp1 * wi[4];
 
             inputs.process();
 
-            out2[11] = inputs.in2 * wi[11];
-            out2[6]  = inputs.in2 * wi[6];
-            out2[8]  = inputs.in3 * wi[8];
-            out2[9]  = inputs.in3 * wi[9];
+            out2[subBandLimit * 11] = inputs.in2 * wi[11];
+            out2[subBandLimit * 6]  = inputs.in2 * wi[6];
+            out2[subBandLimit * 8]  = inputs.in3 * wi[8];
+            out2[subBandLimit * 9]  = inputs.in3 * wi[9];
             out2[0] += inputs.in0 * wi[0];
-            out2[5] += inputs.in0 * wi[5];
-            out2[2] += inputs.in4 * wi[2];
-            out2[3] += inputs.in4 * wi[3];
+            out2[subBandLimit * 5] += inputs.in0 * wi[5];
+            out2[subBandLimit * 2] += inputs.in4 * wi[2];
+            out2[subBandLimit * 3] += inputs.in4 * wi[3];
         }
     }
 
@@ -1358,30 +1618,32 @@ namespace DCT
             b1[0x1E] += b1[0x1F];    b1[0x1C] += b1[0x1E]; b1[0x1E] += b1[0x1D];  b1[0x1D] += b1[0x1F];
         }
 
-        out0[0x10 * 16] = b1[0x00];  out0[0x10 * 12] = b1[0x04]; out0[0x10 * 8]  = b1[0x02];  out0[0x10 * 4]  = b1[0x06];
-        out0[0] = b1[0x01];  out1[0]  = b1[0x01]; out1[0x10 * 4]  = b1[0x05];  out1[0x10 * 8]  = b1[0x03];
-        out1[0x10 * 12] = b1[0x07];
+        out0[16] = b1[0x00];  out0[12] = b1[0x04]; out0[8] = b1[0x02];  out0[4] = b1[0x06];
+        out0[0] = b1[0x01];  out1[0] = b1[0x01]; out1[4] = b1[0x05];  out1[8] = b1[0x03];
+        out1[12] = b1[0x07];
 
-        b1[0x08] += b1[0x0C];  out0[0x10 * 14] = b1[0x08];  b1[0x0C] += b1[0x0a];  out0[0x10 * 10] = b1[0x0C];
-        b1[0x0A] += b1[0x0E];  out0[0x10 * 6]  = b1[0x0A];  b1[0x0E] += b1[0x09];  out0[0x10 * 2]  = b1[0x0E];
-        b1[0x09] += b1[0x0D];  out1[0x10 * 2]  = b1[0x09];  b1[0x0D] += b1[0x0B];  out1[0x10 * 6]  = b1[0x0D];
-        b1[0x0B] += b1[0x0F];  out1[0x10 * 10] = b1[0x0B];  out1[0x10 * 14] = b1[0x0F];
+        b1[0x08] += b1[0x0C];  out0[14] = b1[0x08];  b1[0x0C] += b1[0x0a];  out0[10] = b1[0x0C];
+        b1[0x0A] += b1[0x0E];  out0[6] = b1[0x0A];  b1[0x0E] += b1[0x09];  out0[2] = b1[0x0E];
+        b1[0x09] += b1[0x0D];  out1[2] = b1[0x09];  b1[0x0D] += b1[0x0B];  out1[6] = b1[0x0D];
+        b1[0x0B] += b1[0x0F];  out1[10] = b1[0x0B];  out1[14] = b1[0x0F];
 
-        b1[0x18] += b1[0x1C];  out0[0x10 * 15] = b1[0x10] + b1[0x18];   out0[0x10 * 13] = b1[0x18] + b1[0x14];
-        b1[0x1C] += b1[0x1a];  out0[0x10 * 11] = b1[0x14] + b1[0x1C];   out0[0x10 * 9]  = b1[0x1C] + b1[0x12];
-        b1[0x1A] += b1[0x1E];  out0[0x10 * 7]  = b1[0x12] + b1[0x1A];   out0[0x10 * 5]  = b1[0x1A] + b1[0x16];
-        b1[0x1E] += b1[0x19];  out0[0x10 * 3]  = b1[0x16] + b1[0x1E];   out0[0x10 * 1]  = b1[0x1E] + b1[0x11];
-        b1[0x19] += b1[0x1D];  out1[0x10 * 1]  = b1[0x11] + b1[0x19];   out1[0x10 * 3]  = b1[0x19] + b1[0x15];
-        b1[0x1D] += b1[0x1B];  out1[0x10 * 5]  = b1[0x15] + b1[0x1D];   out1[0x10 * 7]  = b1[0x1D] + b1[0x13];
-        b1[0x1B] += b1[0x1F];  out1[0x10 * 9]  = b1[0x13] + b1[0x1B];   out1[0x10 * 11] = b1[0x1B] + b1[0x17];
-        out1[0x10 * 13] = b1[0x17] + b1[0x1F];  out1[0x10 * 15] = b1[0x1F];
+        b1[0x18] += b1[0x1C];  out0[15] = b1[0x10] + b1[0x18];   out0[13] = b1[0x18] + b1[0x14];
+        b1[0x1C] += b1[0x1a];  out0[11] = b1[0x14] + b1[0x1C];   out0[9] = b1[0x1C] + b1[0x12];
+        b1[0x1A] += b1[0x1E];  out0[7] = b1[0x12] + b1[0x1A];   out0[5] = b1[0x1A] + b1[0x16];
+        b1[0x1E] += b1[0x19];  out0[3] = b1[0x16] + b1[0x1E];   out0[1] = b1[0x1E] + b1[0x11];
+        b1[0x19] += b1[0x1D];  out1[1] = b1[0x11] + b1[0x19];   out1[3] = b1[0x19] + b1[0x15];
+        b1[0x1D] += b1[0x1B];  out1[5] = b1[0x15] + b1[0x1D];   out1[7] = b1[0x1D] + b1[0x13];
+        b1[0x1B] += b1[0x1F];  out1[9] = b1[0x13] + b1[0x1B];   out1[11] = b1[0x1B] + b1[0x17];
+        out1[13] = b1[0x17] + b1[0x1F];  out1[15] = b1[0x1F];
     }
 }
 
 //==============================================================================
 struct MP3Stream
 {
-    MP3Stream (InputStream& source)  : stream (source, 8192)
+    MP3Stream (InputStream& source, MP3AudioFormat::FrameIndex* sharedIndex)
+        : stream (source, 8192),
+          index (sharedIndex != nullptr ? sharedIndex : new MP3AudioFormat::FrameIndex())
     {
         reset();
     }
@@ -1549,31 +1811,105 @@ struct MP3Stream
     {
         frameIndex = jmax (0, frameIndex);
 
-        while (frameIndex >= frameStreamPositions.size() * storedStartPosInterval)
+        if (frameIndex >= index->getNumFrames())
         {
-            int dummy = 0;
-            auto result = decodeNextBlock (nullptr, nullptr, dummy);
+            if (index->isComplete())
+                return false;
 
-            if (result < 0)
+            if (index->isApproximateSeekingEnabled() && seekUsingTableOfContents (frameIndex))
+                return true;
+
+            if (! scanForwardsTo (frameIndex))
                 return false;
+        }
 
-            if (result > 0)
-                break;
+        int64 position = 0;
+        auto indexedFrame = index->findFrameAtOrBefore (frameIndex, position);
+
+        if (indexedFrame < 0)
+            return false;
+
+        stream.setPosition (position);
+        currentFrameIndex = indexedFrame;
+        positionIsApproximate = false;
+        reset();
+        return true;
+    }
+
+    // Scans the stream without decoding it, until the given frame has been added to the index
+    bool scanForwardsTo (int frameIndex)
+    {
+        // Any reader sharing the index may have got further than this one, so carry
+        // on from the last frame that's been found
+        auto numKnown = index->getNumFrames();
+
+        if (positionIsApproximate || currentFrameIndex < numKnown)
+        {
+            int64 position = 0;
+            auto indexedFrame = index->findFrameAtOrBefore (numKnown - 1, position);
+
+            if (indexedFrame >= 0)
+            {
+                stream.setPosition (position);
+                currentFrameIndex = indexedFrame;
+                positionIsApproximate = false;
+                reset();
+            }
         }
 
-        frameIndex = jmin (frameIndex & ~(storedStartPosInterval - 1),
-                           frameStreamPositions.size() * storedStartPosInterval - 1);
-        stream.setPosition (frameStreamPositions.getUnchecked (frameIndex / storedStartPosInterval));
+        while (frameIndex >= index->getNumFrames())
+        {
+            if (Thread::currentThreadShouldExit())
+                return false;
+
+            int dummy = 0;
+
+            if (decodeNextBlock (nullptr, nullptr, dummy) < 0)
+                return false;
+        }
+
+        return true;
+    }
+
+    // Jumps to an estimated position for a frame, using the Xing table of contents
+    bool seekUsingTableOfContents (int frameIndex)
+    {
+        const unsigned int framesBytesAndTOC = 7;
+
+        if (! vbrHeaderFound || (vbrTagData.flags & framesBytesAndTOC) != framesBytesAndTOC
+             || numFrames <= 0 || frameIndex >= numFrames)
+            return false;
+
+        int64 firstFramePosition = 0;
+
+        if (index->findFrameAtOrBefore (0, firstFramePosition) != 0)
+            return false;
+
+        auto percent = jlimit (0.0, 99.99, 100.0 * frameIndex / numFrames);
+        auto entry = (int) percent;
+        auto start = (double) vbrTagData.toc[entry];
+        auto end = entry < 99 ? (double) vbrTagData.toc[entry + 1] : 256.0;
+        auto offset = (start + (end - start) * (percent - entry)) * vbrTagData.bytes / 256.0;
+
+        stream.setPosition (firstFramePosition + (int64) offset);
         currentFrameIndex = frameIndex;
+        positionIsApproximate = true;
         reset();
         return true;
     }
 
+    bool scanToEnd()
+    {
+        scanForwardsTo (std::numeric_limits<int>::max() - 1);
+        return ! Thread::currentThreadShouldExit();
+    }
+
     MP3Frame frame;
     VBRTagData vbrTagData;
     BufferedInputStream stream;
     int numFrames = 0, currentFrameIndex = 0;
-    bool vbrHeaderFound = false;
+    bool vbrHeaderFound = false, positionIsApproximate = false;
+    MP3AudioFormat::FrameIndex::Ptr index;
 
 private:
     bool headerParsed, sideParsed, dataParsed, needToSyncBitStream;
@@ -1585,9 +1921,9 @@ private:
     uint8 bufferSpace[2][2880 + 1024];
     uint8* bufferPointer;
     int bitIndex, synthBo;
-    float hybridBlock[2][2][32 * 18];
+    float hybridBlock[2][2][18 * 32]; // 18 samples of 32 sub-bands, like hybridOut
     int hybridBlockIndex[2];
-    float synthBuffers[2][2][0x110];
+    float synthBuffers[2][2][16 * Kernels::synthSlotSize];
     float hybridIn[2][32][18];
     float hybridOut[2][18][32];
 
@@ -1608,9 +1944,6 @@ private:
         zeromem (synthBuffers, sizeof (synthBuffers));
     }
 
-    enum { storedStartPosInterval = 4 };
-    Array<int64> frameStreamPositions;
-
     struct SideInfoLayer1
     {
         uint8 allocation[32][2];
@@ -1623,18 +1956,6 @@ private:
         uint8 scaleFactor[32][2][3];
     };
 
-    static bool isValidHeader (uint32 header, int oldLayer) noexcept
-    {
-        int newLayer = 4 - ((header >> 17) & 3);
-
-        return (header & 0xffe00000) == 0xffe00000
-                && newLayer != 4
-                && (oldLayer <= 0 || newLayer == oldLayer)
-                && ((header >> 12) & 15) != 15
-                && ((header >> 10) & 3) != 3
-                && (header & 3) != 2;
-    }
-
     bool rollBackBufferPointer (int backstep) noexcept
     {
         if (lastFrameSize < 0 && backstep > 0)
@@ -1700,7 +2021,7 @@ private:
 
             header = (header << 8) | (uint8) stream.readByte();
 
-            if (offset >= 0 && isValidHeader (header, frame.layer))
+            if (offset >= 0 && MP3Frame::isValidHeader (header, frame.layer))
             {
                 if (! checkTypeAgainstLastFrame)
                     break;
@@ -1721,8 +2042,8 @@ private:
 
         if (offset >= 0)
         {
-            if ((currentFrameIndex & (storedStartPosInterval - 1)) == 0)
-                frameStreamPositions.set (currentFrameIndex / storedStartPosInterval, oldPos + offset);
+            if (! positionIsApproximate)
+                index->addFrame (currentFrameIndex, oldPos + offset);
 
             ++currentFrameIndex;
         }
@@ -2826,9 +3147,9 @@ private:
         {
             sb = 2;
             DCT::dct36 (fsIn[0], rawout1, rawout2, constants.win[0], ts);
-            DCT::dct36 (fsIn[1], rawout1 + 18, rawout2 + 18, constants.win1[0], ts + 1);
-            rawout1 += 36;
-            rawout2 += 36;
+            DCT::dct36 (fsIn[1], rawout1 + 1, rawout2 + 1, constants.win1[0], ts + 1);
+            rawout1 += 2;
+            rawout2 += 2;
             ts += 2;
         }
 
@@ -2836,27 +3157,52 @@ private:
 
         if (bt == 2)
         {
-            for (; sb < (int) granule.maxb; sb += 2, ts += 2, rawout1 += 36, rawout2 += 36)
+            for (; sb < (int) granule.maxb; sb += 2, ts += 2, rawout1 += 2, rawout2 += 2)
             {
                 DCT::dct12 (fsIn[sb], rawout1, rawout2, constants.win[2], ts);
-                DCT::dct12 (fsIn[sb + 1], rawout1 + 18, rawout2 + 18, constants.win1[2], ts + 1);
+                DCT::dct12 (fsIn[sb + 1], rawout1 + 1, rawout2 + 1, constants.win1[2], ts + 1);
             }
         }
         else
         {
-            for (; sb < (int) granule.maxb; sb += 2, ts += 2, rawout1 += 36, rawout2 += 36)
+           #if JUCE_MP3_USE_SIMD
+            if (sb + 4 <= (int) granule.maxb)
+            {
+                using Kernels::Lanes;
+                Lanes window[36];
+
+                for (int i = 0; i < 36; ++i)
+                    window[i] = Lanes::fromValues (constants.win[bt][i], constants.win1[bt][i],
+                                                   constants.win[bt][i], constants.win1[bt][i]);
+
+                for (; sb + 4 <= (int) granule.maxb; sb += 4, ts += 4, rawout1 += 4, rawout2 += 4)
+                {
+                    Lanes in[18];
+
+                    for (int i = 0; i < 16; i += 4)
+                        Kernels::loadColumns (fsIn[sb] + i, 18, in + i);
+
+                    for (int i = 16; i < 18; ++i)
+                        in[i] = Lanes::fromValues (fsIn[sb][i], fsIn[sb + 1][i], fsIn[sb + 2][i], fsIn[sb + 3][i]);
+
+                    DCT::dct36 (in, rawout1, rawout2, window, ts);
+                }
+            }
+           #endif
+
+            for (; sb < (int) granule.maxb; sb += 2, ts += 2, rawout1 += 2, rawout2 += 2)
             {
                 DCT::dct36 (fsIn[sb], rawout1, rawout2, constants.win[bt], ts);
-                DCT::dct36 (fsIn[sb + 1], rawout1 + 18, rawout2 + 18, constants.win1[bt], ts + 1);
+                DCT::dct36 (fsIn[sb + 1], rawout1 + 1, rawout2 + 1, constants.win1[bt], ts + 1);
             }
         }
 
-        for (; sb < 32; ++sb, ++ts)
+        for (; sb < 32; ++sb, ++ts, ++rawout1, ++rawout2)
         {
             for (int i = 0; i < 18; ++i)
             {
-                ts[i * 32] = *rawout1++;
-                *rawout2++ = 0;
+                ts[i * 32] = rawout1[i * 32];
+                rawout2[i * 32] = 0;
             }
         }
     }
@@ -2872,61 +3218,24 @@ private:
     {
         out += samplesDone;
         const int bo = channel == 0 ? ((synthBo - 1) & 15) : synthBo;
-        float (*buf)[0x110] = synthBuffers[channel];
+        float (*buf)[16 * Kernels::synthSlotSize] = synthBuffers[channel];
         float* b0;
         auto bo1 = bo;
 
         if (bo & 1)
         {
             b0 = buf[0];
-            DCT::dct64 (buf[1] + ((bo + 1) & 15), buf[0] + bo, bandPtr);
+            DCT::dct64 (buf[1] + Kernels::synthSlotSize * ((bo + 1) & 15), buf[0] + Kernels::synthSlotSize * bo, bandPtr);
         }
         else
         {
             ++bo1;
             b0 = buf[1];
-            DCT::dct64 (buf[0] + bo, buf[1] + bo1, bandPtr);
+            DCT::dct64 (buf[0] + Kernels::synthSlotSize * bo, buf[1] + Kernels::synthSlotSize * bo1, bandPtr);
         }
 
         synthBo = bo;
-        const float* window = constants.decodeWin + 16 - bo1;
-
-        for (int j = 16; j != 0; --j, b0 += 16, window += 32)
-        {
-            auto sum = window[0] * b0[0];  sum -= window[1] * b0[1];
-            sum += window[2]  * b0[2];   sum -= window[3]  * b0[3];
-            sum += window[4]  * b0[4];   sum -= window[5]  * b0[5];
-            sum += window[6]  * b0[6];   sum -= window[7]  * b0[7];
-            sum += window[8]  * b0[8];   sum -= window[9]  * b0[9];
-            sum += window[10] * b0[10];  sum -= window[11] * b0[11];
-            sum += window[12] * b0[12];  sum -= window[13] * b0[13];
-            sum += window[14] * b0[14];  sum -= window[15] * b0[15];
-            *out++ = sum;
-        }
-
-        {
-            auto sum = window[0] * b0[0];   sum += window[2] * b0[2];
-            sum += window[4]  * b0[4];   sum += window[6]  * b0[6];
-            sum += window[8]  * b0[8];   sum += window[10] * b0[10];
-            sum += window[12] * b0[12];  sum += window[14] * b0[14];
-            *out++ = sum;
-            b0 -= 16; window -= 32;
-            window += bo1 << 1;
-        }
-
-        for (int j = 15; j != 0; --j, b0 -= 16, window -= 32)
-        {
-            auto sum = -window[-1] * b0[0];  sum -= window[-2] * b0[1];
-            sum -= window[-3]  * b0[2];   sum -= window[-4]  * b0[3];
-            sum -= window[-5]  * b0[4];   sum -= window[-6]  * b0[5];
-            sum -= window[-7]  * b0[6];   sum -= window[-8]  * b0[7];
-            sum -= window[-9]  * b0[8];   sum -= window[-10] * b0[9];
-            sum -= window[-11] * b0[10];  sum -= window[-12] * b0[11];
-            sum -= window[-13] * b0[12];  sum -= window[-14] * b0[13];
-            sum -= window[-15] * b0[14];  sum -= window[0]   * b0[15];
-            *out++ = sum;
-        }
-
+        Kernels::applySynthesisWindow<JUCE_MP3_USE_SIMD != 0> (b0, bo1, out);
         samplesDone += 32;
     }
 
@@ -2940,9 +3249,9 @@ static const char* const mp3FormatName = "MP3 file";
 class MP3Reader : public AudioFormatReader
 {
 public:
-    MP3Reader (InputStream* const in)
+    MP3Reader (InputStream* const in, MP3AudioFormat::FrameIndex* sharedIndex = nullptr)
         : AudioFormatReader (in, mp3FormatName),
-          stream (*in), currentPosition (0),
+          stream (*in, sharedIndex), currentPosition (0),
           decodedStart (0), decodedEnd (0)
     {
         skipID3();
@@ -3028,6 +3337,8 @@ public:
     }
 
 private:
+    friend class MP3AudioFormat::FrameIndex;
+
     MP3Stream stream;
     int64 currentPosition;
     enum { decodedDataSize = 1152 };
@@ -3132,7 +3443,19 @@ StringArray MP3AudioFormat::getQualityOptions()     { return {}; }
 
 AudioFormatReader* MP3AudioFormat::createReaderFor (InputStream* sourceStream, const bool deleteStreamIfOpeningFails)
 {
-    std::unique_ptr<MP3Decoder::MP3Reader> r (new MP3Decoder::MP3Reader (sourceStream));
+    return createReaderFor (sourceStream, deleteStreamIfOpeningFails, nullptr);
+}
+
+AudioFormatReader* MP3AudioFormat::createReaderFor (InputStream* sourceStream, const bool deleteStreamIfOpeningFails,
+                                                    FrameIndex::Ptr sharedIndex)
+{
+    if (sharedIndex != nullptr && ! sharedIndex->matchesSourceLength (sourceStream->getTotalLength()))
+    {
+        jassertfalse; // this index was made for a different stream!
+        sharedIndex = nullptr;
+    }
+
+    std::unique_ptr<MP3Decoder::MP3Reader> r (new MP3Decoder::MP3Reader (sourceStream, sharedIndex.get()));
 
     if (r->lengthInSamples > 0)
         return r.release();
@@ -3143,6 +3466,266 @@ AudioFormatReader* MP3AudioFormat::createReaderFor (InputStream* sourceStream, c
     return nullptr;
 }
 
+AudioFormat::ProbeResult MP3AudioFormat::probe (InputStream& in)
+{
+    using namespace MP3Decoder;
+    ProbeResult result;
+
+    // skip any ID3v2 tag, in the same way as MP3Reader::skipID3()
+    auto streamStartPos = in.getPosition();
+    uint8 id3[10];
+
+    if (in.read (id3, 10) == 10 && memcmp (id3, "ID3", 3) == 0 && id3[4] != 0xff
+         && ((id3[6] | id3[7] | id3[8] | id3[9]) & 0x80) == 0)
+    {
+        streamStartPos += 10 + ((((int64) id3[6]) << 21) | (((int64) id3[7]) << 14)
+                                  | (((int64) id3[8]) << 7) |  ((int64) id3[9]));
+    }
+
+    if (! in.setPosition (streamStartPos))
+        return result;
+
+    // Look for a frame header that's followed by another one of the same type (or by the
+    // end of the stream), which is enough to rule out most random data. The first frame
+    // is usually right at the start, so this only reads further if it has to.
+    MemoryBlock head;
+
+    for (auto headSize : { 8192, 32768 + 2 * 2880 })
+    {
+        in.readIntoMemoryBlock (head, headSize - (ssize_t) head.getSize());
+        auto* data = static_cast<const uint8*> (head.getData());
+        auto numBytes = (int) head.getSize();
+        const bool isWholeStream = in.isExhausted();
+        auto lastOffset = isWholeStream ? numBytes - 4 : jmin (32768, numBytes - 2 * 2884);
+
+        for (int offset = 0; offset <= lastOffset; ++offset)
+        {
+            auto header = ByteOrder::bigEndianInt (data + offset);
+
+            if (! MP3Frame::isValidHeader (header, 0) || ((header >> 12) & 15) == 0) // (free-format isn't supported)
+                continue;
+
+            MP3Frame frame;
+            frame.decodeHeader (header);
+            auto nextOffset = offset + frame.frameSize + 4;
+
+            if (nextOffset + 4 <= numBytes)
+            {
+                auto nextHeader = ByteOrder::bigEndianInt (data + nextOffset);
+
+                if (! MP3Frame::isValidHeader (nextHeader, frame.layer)
+                     || (nextHeader & 0x001e0c00) != (header & 0x001e0c00) // (version, layer and rate)
+                     || (((nextHeader >> 6) & 3) == 3) != (frame.numChannels == 1))
+                    continue;
+            }
+            else if (nextOffset > numBytes)
+            {
+                continue;
+            }
+
+            result.format = this;
+            result.sampleRate = frame.getFrequency();
+            result.numChannels = (unsigned int) frame.numChannels;
+            result.bitsPerSample = 32;
+            result.usesFloatingPointData = true;
+
+            VBRTagData vbrTagData;
+            int64 numFrames = 0;
+
+            if (offset + 194 <= numBytes && vbrTagData.read (data + offset) && (vbrTagData.flags & 1) != 0)
+                numFrames = (int) vbrTagData.frames;
+
+            if (numFrames <= 0)
+            {
+                // no frame count, so estimate it from the stream's size, like MP3Reader::findLength()
+                result.lengthIsEstimate = true;
+                auto streamSize = in.getTotalLength();
+                auto bytesPerFrame = frame.frameSize + 4;
+
+                if (bytesPerFrame == 417 || bytesPerFrame == 418)
+                    numFrames = roundToInt ((streamSize - streamStartPos) / 417.95918); // more accurate for 128k
+                else
+                    numFrames = (streamSize - streamStartPos) / bytesPerFrame;
+            }
+
+            result.lengthInSamples = numFrames * 1152;
+
+            if (result.lengthInSamples <= 0)
+                return {};
+
+            return result;
+        }
+
+        if (isWholeStream)
+            break;
+    }
+
+    return result;
+}
+
+//==============================================================================
+MP3AudioFormat::FrameIndex::FrameIndex() {}
+MP3AudioFormat::FrameIndex::~FrameIndex() {}
+
+bool MP3AudioFormat::FrameIndex::build (InputStream& source)
+{
+    if (! matchesSourceLength (source.getTotalLength()))
+    {
+        jassertfalse; // this index was made for a different stream!
+        return false;
+    }
+
+    MP3Decoder::MP3Reader reader (&source, this);
+    reader.input = nullptr;
+
+    if (reader.lengthInSamples <= 0 || ! reader.stream.scanToEnd())
+        return false;
+
+    const ScopedLock sl (lock);
+    complete = true;
+    return true;
+}
+
+bool MP3AudioFormat::FrameIndex::isComplete() const noexcept
+{
+    const ScopedLock sl (lock);
+    return complete;
+}
+
+int MP3AudioFormat::FrameIndex::getNumFrames() const noexcept
+{
+    const ScopedLock sl (lock);
+    return numFrames;
+}
+
+int MP3AudioFormat::FrameIndex::findFrameAtOrBefore (int frameNumber, int64& streamPosition) const noexcept
+{
+    const ScopedLock sl (lock);
+    frameNumber = jmin (frameNumber, numFrames - 1);
+
+    if (frameNumber < 0)
+        return -1;
+
+    auto entry = frameNumber / framesPerEntry;
+    streamPosition = positions.getUnchecked (entry);
+    return entry * framesPerEntry;
+}
+
+void MP3AudioFormat::FrameIndex::addFrame (int frameNumber, int64 streamPosition) noexcept
+{
+    const ScopedLock sl (lock);
+
+    if (frameNumber == numFrames && ! complete)
+    {
+        if (frameNumber % framesPerEntry == 0)
+            positions.add (streamPosition);
+
+        ++numFrames;
+    }
+}
+
+void MP3AudioFormat::FrameIndex::setApproximateSeekingEnabled (bool shouldBeEnabled) noexcept
+{
+    approximateSeekingEnabled = shouldBeEnabled;
+}
+
+bool MP3AudioFormat::FrameIndex::isApproximateSeekingEnabled() const noexcept
+{
+    return approximateSeekingEnabled;
+}
+
+bool MP3AudioFormat::FrameIndex::matchesSourceLength (int64 length) noexcept
+{
+    const ScopedLock sl (lock);
+
+    if (sourceLength < 0)
+        sourceLength = length;
+
+    return sourceLength == length;
+}
+
+static const int mp3FrameIndexMagicNumber = (int) ByteOrder::littleEndianInt ("MP3X");
+static const int mp3FrameIndexVersion = 1;
+
+bool MP3AudioFormat::FrameIndex::writeTo (OutputStream& out) const
+{
+    const ScopedLock sl (lock);
+
+    if (! (out.writeInt (mp3FrameIndexMagicNumber)
+            && out.writeInt (mp3FrameIndexVersion)
+            && out.writeInt64 (sourceLength)
+            && out.writeInt (numFrames)
+            && out.writeBool (complete)))
+        return false;
+
+    // the positions are stored as the (small) differences between neighbouring entries
+    int64 lastPosition = 0;
+
+    for (auto position : positions)
+    {
+        if (! out.writeCompressedInt ((int) (position - lastPosition)))
+            return false;
+
+        lastPosition = position;
+    }
+
+    return true;
+}
+
+bool MP3AudioFormat::FrameIndex::readFrom (InputStream& in)
+{
+    const ScopedLock sl (lock);
+
+    positions.clearQuick();
+    numFrames = 0;
+    sourceLength = -1;
+    complete = false;
+
+    if (in.readInt() != mp3FrameIndexMagicNumber || in.readInt() != mp3FrameIndexVersion)
+        return false;
+
+    auto length = in.readInt64();
+    auto frames = in.readInt();
+    auto isFinished = in.readBool();
+
+    // every frame takes up at least one byte of the source, and every entry at least one byte of this stream
+    auto numEntries = ((int64) frames + framesPerEntry - 1) / framesPerEntry;
+    auto bytesRemaining = in.getNumBytesRemaining();
+
+    if (frames < 0 || length < 0 || frames > length
+         || (bytesRemaining >= 0 && numEntries > bytesRemaining))
+        return false;
+
+    // (the array grows as the entries are read, so a bogus frame count can't make it allocate much)
+    int64 position = 0;
+
+    for (int64 i = 0; i < numEntries; ++i)
+    {
+        if (in.isExhausted())
+            break;
+
+        auto delta = in.readCompressedInt();
+        position += delta;
+
+        if (delta < 0 || position >= length)
+            break;
+
+        positions.add (position);
+    }
+
+    if (positions.size() != numEntries)
+    {
+        positions.clearQuick();
+        return false;
+    }
+
+    numFrames = frames;
+    sourceLength = length;
+    complete = isFinished;
+    return true;
+}
+
+//==============================================================================
 AudioFormatWriter* MP3AudioFormat::createWriterFor (OutputStream*, double /*sampleRateToUse*/,
                                                     unsigned int /*numberOfChannels*/, int /*bitsPerSample*/,
                                                     const StringPairArray& /*metadataValues*/, int /*qualityOptionIndex*/)
@@ -3151,6 +3734,252 @@ AudioFormatWriter* MP3AudioFormat::createWriterFor (OutputStream*, double /*samp
     return nullptr;
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS && JUCE_MP3_USE_SIMD
+
+struct MP3DecoderKernelTests  : public UnitTest
+{
+    MP3DecoderKernelTests()  : UnitTest ("MP3 decoder kernels", "Audio") {}
+
+    void fillRandomly (Random& r, float* data, int num)
+    {
+        for (int i = 0; i < num; ++i)
+            data[i] = r.nextFloat() * 2.0f - 1.0f;
+    }
+
+    void expectAllWithinTolerance (const float* a, const float* b, int num)
+    {
+        // The vector kernels do the same arithmetic as the scalar ones, but when the compiler
+        // is able to fuse multiply-adds it may do so differently in the two versions
+        const float tolerance = 1.0e-5f;
+
+        for (int i = 0; i < num; ++i)
+            expectWithinAbsoluteError (a[i], b[i], tolerance);
+    }
+
+    void runTest() override
+    {
+        using namespace MP3Decoder;
+        auto r = getRandom();
+
+        beginTest ("Alias reduction");
+        {
+            float scalar[32][18], vector[32][18];
+
+            for (int numBoundaries = 1; numBoundaries < 32; ++numBoundaries)
+            {
+                fillRandomly (r, scalar[0], 32 * 18);
+                memcpy (vector, scalar, sizeof (scalar));
+
+                Kernels::antialias<false> (scalar[1], numBoundaries);
+                Kernels::antialias<true>  (vector[1], numBoundaries);
+
+                expectAllWithinTolerance (scalar[0], vector[0], 32 * 18);
+            }
+        }
+
+        beginTest ("Synthesis window");
+        {
+            float buffer[16 * Kernels::synthSlotSize];
+            float scalar[32], vector[32];
+
+            for (int bo1 = 1; bo1 <= 16; ++bo1)
+            {
+                fillRandomly (r, buffer, numElementsInArray (buffer));
+
+                Kernels::applySynthesisWindow<false> (buffer, bo1, scalar);
+                Kernels::applySynthesisWindow<true>  (buffer, bo1, vector);
+
+                expectAllWithinTolerance (scalar, vector, 32);
+            }
+        }
+
+        beginTest ("IMDCT");
+        {
+            for (int blockType = 0; blockType < 4; ++blockType)
+            {
+                if (blockType == 2)
+                    continue;
+
+                float in[4][18], out1[18 * 32], scalarOut2[18 * 32], vectorOut2[18 * 32];
+                float scalarTs[18 * 32], vectorTs[18 * 32];
+                fillRandomly (r, in[0], 4 * 18);
+                fillRandomly (r, out1, 18 * 32);
+
+                Kernels::Lanes lanes[18], window[36];
+
+                for (int i = 0; i < 18; ++i)
+                    lanes[i] = Kernels::Lanes::fromValues (in[0][i], in[1][i], in[2][i], in[3][i]);
+
+                for (int i = 0; i < 36; ++i)
+                    window[i] = Kernels::Lanes::fromValues (constants.win[blockType][i], constants.win1[blockType][i],
+                                                            constants.win[blockType][i], constants.win1[blockType][i]);
+
+                DCT::dct36 (lanes, out1, vectorOut2, window, vectorTs);
+
+                for (int sb = 0; sb < 4; ++sb)
+                    DCT::dct36 (in[sb], out1 + sb, scalarOut2 + sb,
+                                (sb & 1) != 0 ? constants.win1[blockType] : constants.win[blockType],
+                                scalarTs + sb);
+
+                for (int i = 0; i < 18; ++i)
+                {
+                    expectAllWithinTolerance (scalarTs + i * 32, vectorTs + i * 32, 4);
+                    expectAllWithinTolerance (scalarOut2 + i * 32, vectorOut2 + i * 32, 4);
+                }
+            }
+        }
+    }
+};
+
+static MP3DecoderKernelTests mp3DecoderKernelTests;
+
+#endif
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct MP3FrameIndexTests  : public UnitTest
+{
+    MP3FrameIndexTests()  : UnitTest ("MP3 frame index", "Audio") {}
+
+    enum { frameSize = 417, numTestFrames = 200 };
+
+    // A stream of silent 128kbps, 44.1kHz mono MPEG-1 layer 3 frames
+    static MemoryBlock createSilentStream()
+    {
+        const uint8 header[] = { 0xff, 0xfb, 0x90, 0xc0 };
+        MemoryBlock data ((size_t) (frameSize * numTestFrames), true);
+
+        for (int i = 0; i < numTestFrames; ++i)
+            data.copyFrom (header, i * frameSize, sizeof (header));
+
+        return data;
+    }
+
+    void expectIndexesMatch (const MP3AudioFormat::FrameIndex& a, const MP3AudioFormat::FrameIndex& b)
+    {
+        expectEquals (a.getNumFrames(), b.getNumFrames());
+        expect (a.isComplete() == b.isComplete());
+
+        for (int i = 0; i < a.getNumFrames(); ++i)
+        {
+            int64 posA = -1, posB = -1;
+            expectEquals (a.findFrameAtOrBefore (i, posA), b.findFrameAtOrBefore (i, posB));
+            expectEquals (posA, posB);
+        }
+    }
+
+    void runTest() override
+    {
+        auto data = createSilentStream();
+        MP3AudioFormat format;
+
+        beginTest ("Building");
+        {
+            MP3AudioFormat::FrameIndex::Ptr index (new MP3AudioFormat::FrameIndex());
+            MemoryInputStream source (data, false);
+
+            expect (index->build (source));
+            expect (index->isComplete());
+            expectEquals (index->getNumFrames(), (int) numTestFrames);
+
+            int64 position = -1;
+            expectEquals (index->findFrameAtOrBefore (10, position), 8);
+            expectEquals (position, (int64) (8 * frameSize));
+
+            expectEquals (index->findFrameAtOrBefore (numTestFrames + 10, position), numTestFrames - 4);
+            expectEquals (position, (int64) ((numTestFrames - 4) * frameSize));
+        }
+
+        beginTest ("Serialisation");
+        {
+            MP3AudioFormat::FrameIndex::Ptr index (new MP3AudioFormat::FrameIndex());
+            MemoryInputStream source (data, false);
+            index->build (source);
+
+            MemoryOutputStream out;
+            expect (index->writeTo (out));
+
+            MP3AudioFormat::FrameIndex::Ptr loaded (new MP3AudioFormat::FrameIndex());
+            MemoryInputStream in (out.getData(), out.getDataSize(), false);
+            expect (loaded->readFrom (in));
+            expectIndexesMatch (*index, *loaded);
+
+            MemoryInputStream truncated (out.getData(), out.getDataSize() / 2, false);
+            expect (! loaded->readFrom (truncated));
+            expectEquals (loaded->getNumFrames(), 0);
+
+            // a header that claims far more frames than there's data for
+            MemoryBlock corrupt (out.getData(), out.getDataSize());
+            auto hugeFrameCount = ByteOrder::swapIfBigEndian ((int) std::numeric_limits<int>::max());
+            corrupt.copyFrom (&hugeFrameCount, 16, sizeof (hugeFrameCount));
+            MemoryInputStream corruptStream (corrupt, false);
+            expect (! loaded->readFrom (corruptStream));
+            expectEquals (loaded->getNumFrames(), 0);
+        }
+
+        beginTest ("Seeking on a new reader");
+        {
+            // A reader's first seek has to scan forwards from the start, and the frames it
+            // finds on the way must be indexed at their real positions
+            MP3AudioFormat::FrameIndex::Ptr index (new MP3AudioFormat::FrameIndex());
+            std::unique_ptr<AudioFormatReader> reader (format.createReaderFor (new MemoryInputStream (data, false), true, index));
+            expect (reader != nullptr);
+
+            AudioBuffer<float> buffer (1, 1000);
+            reader->read (&buffer, 0, 1000, 150 * 1152, true, false);
+            expect (index->getNumFrames() > 100);
+
+            for (int i = 0; i < index->getNumFrames(); ++i)
+            {
+                int64 position = -1;
+                auto indexedFrame = index->findFrameAtOrBefore (i, position);
+                expectEquals (position, (int64) indexedFrame * frameSize);
+            }
+        }
+
+        beginTest ("Sharing between readers");
+        {
+            MP3AudioFormat::FrameIndex::Ptr shared (new MP3AudioFormat::FrameIndex());
+
+            std::unique_ptr<AudioFormatReader> reader1 (format.createReaderFor (new MemoryInputStream (data, false), true, shared));
+            std::unique_ptr<AudioFormatReader> reader2 (format.createReaderFor (new MemoryInputStream (data, false), true, shared));
+            expect (reader1 != nullptr && reader2 != nullptr);
+
+            AudioBuffer<float> buffer (1, 1000);
+            auto lastBlock = reader1->lengthInSamples - 1000;
+
+            reader1->read (&buffer, 0, 1000, lastBlock, true, false);
+            auto numFound = shared->getNumFrames();
+            expect (numFound > (int) (lastBlock / 1152));
+            expect (! shared->isComplete());
+
+            // the second reader shouldn't have to add anything to get to the same place
+            reader2->read (&buffer, 0, 1000, lastBlock, true, false);
+            expectEquals (shared->getNumFrames(), numFound);
+
+            MP3AudioFormat::FrameIndex::Ptr built (new MP3AudioFormat::FrameIndex());
+            MemoryInputStream source (data, false);
+            built->build (source);
+
+            for (int i = 0; i < numFound; ++i)
+            {
+                int64 sharedPos = -1, builtPos = -1;
+                shared->findFrameAtOrBefore (i, sharedPos);
+                built->findFrameAtOrBefore (i, builtPos);
+                expectEquals (sharedPos, builtPos);
+            }
+        }
+    }
+};
+
+static MP3FrameIndexTests mp3FrameIndexTests;
+
+#endif
+
+#undef JUCE_MP3_USE_SIMD
+
 #endif
 
 } // namespace juce
@@ -60,9 +60,133 @@ public:
     bool isCompressed() override;
     StringArray getQualityOptions() override;
 
+    //==============================================================================
+    /**
+        An index of the positions of the frames in an MP3 stream.
+
+        There's no fixed relationship between time and position in an MP3 stream, so when
+        a reader is asked for a part of the file that it hasn't reached yet, it has to scan
+        through all the frames before it. A reader remembers the frames it has found, but
+        that's lost when it's deleted, so every new reader of a long file has to repeat the
+        slow scan the first time it seeks towards the end.
+
+        A FrameIndex can be passed to createReaderFor() to be shared by any number of readers
+        of the same stream. They'll all use the frame positions that it contains, and add any
+        new frames that they come across. It can be filled in advance with build(), e.g. on a
+        background thread, and saved and re-loaded with writeTo() and readFrom() so that it
+        only ever needs to be built once for each file.
+
+        All of its methods are thread-safe.
+
+        @tags{Audio}
+    */
+    class JUCE_API  FrameIndex  : public ReferenceCountedObject
+    {
+    public:
+        /** Creates an empty index. */
+        FrameIndex();
+
+        /** Destructor. */
+        ~FrameIndex() override;
+
+        using Ptr = ReferenceCountedObjectPtr<FrameIndex>;
+
+        //==============================================================================
+        /** Scans an MP3 stream, adding all of its frames to the index.
+
+            This can take a while for a long file, so you may want to call it on a background
+            thread, in which case it'll stop early if Thread::currentThreadShouldExit() returns
+            true. Readers that share the index can carry on being used while it's being built,
+            and will take advantage of any frames that have been found so far.
+
+            @returns true if the whole stream was scanned
+        */
+        bool build (InputStream& source);
+
+        /** Returns true if build() has scanned all the frames in the stream. */
+        bool isComplete() const noexcept;
+
+        /** Returns the number of frames, from the start of the stream, whose positions are known. */
+        int getNumFrames() const noexcept;
+
+        /** Looks for the last indexed frame at or before the given one.
+            @returns the number of the frame that was found, or -1 if there isn't one, in which
+                     case streamPosition is left unchanged
+        */
+        int findFrameAtOrBefore (int frameNumber, int64& streamPosition) const noexcept;
+
+        /** Adds the position of a frame to the index.
+            Readers that share the index call this for each frame they find, so you won't
+            normally need to call it yourself. Frames must be added in order, so a frame
+            that isn't the next one after the last known frame is ignored.
+        */
+        void addFrame (int frameNumber, int64 streamPosition) noexcept;
+
+        //==============================================================================
+        /** Lets readers that use this index make a fast but approximate seek when they're
+            asked for a position beyond the frames that it contains.
+
+            If this is enabled, and the stream has a Xing or Info header with a table of
+            contents, a reader will use that table to jump straight to an estimated position
+            rather than scanning forwards from the last indexed frame. The samples it reads
+            will only be roughly in the right place until it next seeks to a frame that is in
+            the index, so this is mainly useful for starting playback quickly while the index
+            is being built in the background. It's disabled by default.
+        */
+        void setApproximateSeekingEnabled (bool shouldBeEnabled) noexcept;
+
+        /** Returns true if approximate seeking has been enabled.
+            @see setApproximateSeekingEnabled
+        */
+        bool isApproximateSeekingEnabled() const noexcept;
+
+        //==============================================================================
+        /** Writes the contents of the index to a stream, so it can be re-loaded with readFrom(). */
+        bool writeTo (OutputStream&) const;
+
+        /** Replaces the contents of the index with data that was written by writeTo().
+            @returns false if the data wasn't a valid index, in which case the index will be empty
+        */
+        bool readFrom (InputStream&);
+
+    private:
+        //==============================================================================
+        friend class MP3AudioFormat;
+
+        enum { framesPerEntry = 4 };
+
+        CriticalSection lock;
+        Array<int64> positions;
+        int numFrames = 0;
+        int64 sourceLength = -1;
+        bool complete = false;
+        std::atomic<bool> approximateSeekingEnabled { false };
+
+        bool matchesSourceLength (int64) noexcept;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FrameIndex)
+    };
+
     //==============================================================================
     AudioFormatReader* createReaderFor (InputStream*, bool deleteStreamIfOpeningFails) override;
 
+    /** Identifies an MP3 stream from its first two frame headers.
+
+        The length is taken from the Xing/Info header if there is one, otherwise it's
+        estimated from the stream's size in the same way that the reader does it, and
+        lengthIsEstimate is set.
+    */
+    ProbeResult probe (InputStream&) override;
+
+    /** Creates a reader that uses, and adds to, a frame index which can be shared with
+        other readers of the same stream.
+
+        If the index was built for a stream of a different length, it will be ignored.
+        @see FrameIndex
+    */
+    AudioFormatReader* createReaderFor (InputStream* sourceStream, bool deleteStreamIfOpeningFails,
+                                        FrameIndex::Ptr sharedIndex);
+
     AudioFormatWriter* createWriterFor (OutputStream*, double sampleRateToUse,
                                         unsigned int numberOfChannels, int bitsPerSample,
                                         const StringPairArray& metadataValues, int qualityOptionIndex) override;
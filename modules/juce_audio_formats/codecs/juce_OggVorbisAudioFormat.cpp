@@ -145,7 +145,8 @@ public:
             bitsPerSample = 16;
             sampleRate = info->rate;
 
-            reservoir.setSize ((int) numChannels, (int) jmin (lengthInSamples, (int64) 4096));
+            for (auto& block : cache)
+                block.buffer.setSize ((int) numChannels, samplesPerCacheBlock);
         }
     }
 
@@ -164,64 +165,23 @@ public:
     bool readSamples (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
                       int64 startSampleInFile, int numSamples) override
     {
-        while (numSamples > 0)
+        while (numSamples > 0 && startSampleInFile < lengthInSamples)
         {
-            auto numAvailable = (int) (reservoirStart + samplesInReservoir - startSampleInFile);
+            auto blockStart = (startSampleInFile / samplesPerCacheBlock) * samplesPerCacheBlock;
+            auto& block = getCachedBlock (blockStart);
 
-            if (startSampleInFile >= reservoirStart && numAvailable > 0)
-            {
-                // got a few samples overlapping, so use them before seeking..
-
-                auto numToUse = jmin (numSamples, numAvailable);
-
-                for (int i = jmin (numDestChannels, reservoir.getNumChannels()); --i >= 0;)
-                    if (destSamples[i] != nullptr)
-                        memcpy (destSamples[i] + startOffsetInDestBuffer,
-                                reservoir.getReadPointer (i, (int) (startSampleInFile - reservoirStart)),
-                                sizeof (float) * (size_t) numToUse);
-
-                startSampleInFile += numToUse;
-                numSamples -= numToUse;
-                startOffsetInDestBuffer += numToUse;
-
-                if (numSamples == 0)
-                    break;
-            }
-
-            if (startSampleInFile < reservoirStart
-                || startSampleInFile + numSamples > reservoirStart + samplesInReservoir)
-            {
-                // buffer miss, so refill the reservoir
-                reservoirStart = jmax (0, (int) startSampleInFile);
-                samplesInReservoir = reservoir.getNumSamples();
-
-                if (reservoirStart != (int) ov_pcm_tell (&ovFile))
-                    ov_pcm_seek (&ovFile, reservoirStart);
-
-                int bitStream = 0;
-                int offset = 0;
-                int numToRead = samplesInReservoir;
-
-                while (numToRead > 0)
-                {
-                    float** dataIn = nullptr;
-                    auto samps = ov_read_float (&ovFile, &dataIn, numToRead, &bitStream);
-
-                    if (samps <= 0)
-                        break;
-
-                    jassert (samps <= numToRead);
+            auto offset = (int) (startSampleInFile - blockStart);
+            auto numToUse = jmin (numSamples, samplesPerCacheBlock - offset);
 
-                    for (int i = jmin ((int) numChannels, reservoir.getNumChannels()); --i >= 0;)
-                        memcpy (reservoir.getWritePointer (i, offset), dataIn[i], sizeof (float) * (size_t) samps);
-
-                    numToRead -= samps;
-                    offset += samps;
-                }
+            for (int i = jmin (numDestChannels, block.buffer.getNumChannels()); --i >= 0;)
+                if (destSamples[i] != nullptr)
+                    memcpy (destSamples[i] + startOffsetInDestBuffer,
+                            block.buffer.getReadPointer (i, offset),
+                            sizeof (float) * (size_t) numToUse);
 
-                if (numToRead > 0)
-                    reservoir.clear (offset, numToRead);
-            }
+            startSampleInFile += numToUse;
+            numSamples -= numToUse;
+            startOffsetInDestBuffer += numToUse;
         }
 
         if (numSamples > 0)
@@ -264,10 +224,81 @@ public:
     }
 
 private:
+    //==============================================================================
+    // Decoded audio is kept in a few aligned blocks, so that reads which jump between
+    // several positions in the file (e.g. from a thumbnail and a sampler) don't each
+    // force a new seek.
+    enum { samplesPerCacheBlock = 4096, numCacheBlocks = 8 };
+
+    struct CachedBlock
+    {
+        AudioBuffer<float> buffer;
+        int64 start = -1;
+        uint32 lastUsed = 0;
+    };
+
+    CachedBlock& getCachedBlock (int64 blockStart)
+    {
+        auto* leastRecentlyUsed = &cache[0];
+
+        for (auto& block : cache)
+        {
+            if (block.start == blockStart)
+            {
+                block.lastUsed = ++cacheUseCounter;
+                return block;
+            }
+
+            if (block.lastUsed < leastRecentlyUsed->lastUsed)
+                leastRecentlyUsed = &block;
+        }
+
+        fillBlock (*leastRecentlyUsed, blockStart);
+        leastRecentlyUsed->lastUsed = ++cacheUseCounter;
+        return *leastRecentlyUsed;
+    }
+
+    void fillBlock (CachedBlock& block, int64 blockStart)
+    {
+        block.start = blockStart;
+
+        // When reading sequentially, the decoder will already be at the start of the block
+        if (blockStart != (int64) ov_pcm_tell (&ovFile) && ov_pcm_seek (&ovFile, blockStart) != 0)
+        {
+            block.buffer.clear();
+            return;
+        }
+
+        int bitStream = 0;
+        int offset = 0;
+
+        while (offset < samplesPerCacheBlock)
+        {
+            auto numToRead = samplesPerCacheBlock - offset;
+
+            float** dataIn = nullptr;
+            auto samps = (int) ov_read_float (&ovFile, &dataIn, numToRead, &bitStream);
+
+            if (samps <= 0)
+                break;
+
+            jassert (samps <= numToRead);
+
+            for (int i = jmin ((int) numChannels, block.buffer.getNumChannels()); --i >= 0;)
+                memcpy (block.buffer.getWritePointer (i, offset), dataIn[i], sizeof (float) * (size_t) samps);
+
+            offset += samps;
+        }
+
+        if (offset < samplesPerCacheBlock)
+            block.buffer.clear (offset, samplesPerCacheBlock - offset);
+    }
+
+    //==============================================================================
     OggVorbisNamespace::OggVorbis_File ovFile;
     OggVorbisNamespace::ov_callbacks callbacks;
-    AudioBuffer<float> reservoir;
-    int reservoirStart = 0, samplesInReservoir = 0;
+    CachedBlock cache[numCacheBlocks];
+    uint32 cacheUseCounter = 0;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OggReader)
 };
@@ -462,6 +493,71 @@ AudioFormatReader* OggVorbisAudioFormat::createReaderFor (InputStream* in, bool
     return nullptr;
 }
 
+AudioFormat::ProbeResult OggVorbisAudioFormat::probe (InputStream& in)
+{
+    ProbeResult result;
+    auto streamStartPos = in.getPosition();
+
+    // the first page must contain just the vorbis identification header
+    uint8 page[27 + 1 + 30];
+
+    if (in.read (page, sizeof (page)) != (int) sizeof (page)
+         || memcmp (page, "OggS", 4) != 0 || page[4] != 0 || page[26] != 1
+         || page[28] != 1 || memcmp (page + 29, "vorbis", 6) != 0
+         || ByteOrder::littleEndianInt (page + 35) != 0)
+        return result;
+
+    auto serialNumber = ByteOrder::littleEndianInt (page + 14);
+    result.numChannels = page[39];
+    result.sampleRate = (int) ByteOrder::littleEndianInt (page + 40);
+    result.bitsPerSample = 16;
+    result.usesFloatingPointData = true;
+
+    if (result.numChannels == 0 || result.sampleRate <= 0)
+        return {};
+
+    // The length is the granule position of the last page, which will be somewhere in
+    // the last 64K of the stream, and is usually in the last few K. If it can't be found
+    // (e.g. in a chained stream), we'll let the reader work it out instead.
+    auto streamEnd = in.getTotalLength();
+
+    for (auto tailSize : { 8192, 65536 })
+    {
+        auto tailStart = jmax (streamStartPos, streamEnd - tailSize);
+
+        if (streamEnd <= 0 || ! in.setPosition (tailStart))
+            break;
+
+        MemoryBlock tail;
+        in.readIntoMemoryBlock (tail, (ssize_t) (streamEnd - tailStart));
+        auto* data = static_cast<const uint8*> (tail.getData());
+
+        for (auto i = (int) tail.getSize() - 27; i >= 0; --i)
+        {
+            auto* p = data + i;
+
+            if (memcmp (p, "OggS", 4) == 0 && p[4] == 0
+                 && ByteOrder::littleEndianInt (p + 14) == serialNumber)
+            {
+                auto granulePosition = (int64) ByteOrder::littleEndianInt64 (p + 6);
+
+                if (granulePosition >= 0)
+                {
+                    result.lengthInSamples = granulePosition;
+                    result.format = this;
+                    return result;
+                }
+            }
+        }
+
+        if (tailStart == streamStartPos)
+            break;
+    }
+
+    in.setPosition (streamStartPos);
+    return AudioFormat::probe (in);
+}
+
 AudioFormatWriter* OggVorbisAudioFormat::createWriterFor (OutputStream* out,
                                                           double sampleRate,
                                                           unsigned int numChannels,
@@ -516,6 +612,85 @@ int OggVorbisAudioFormat::estimateOggFileQuality (const File& source)
     return 0;
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct OggVorbisAudioFormatTests  : public UnitTest
+{
+    OggVorbisAudioFormatTests()  : UnitTest ("Ogg-Vorbis audio format", "Audio") {}
+
+    enum { numChannels = 2, numSamples = 5 * 44100 };
+
+    void runTest() override
+    {
+        OggVorbisAudioFormat ogg;
+        MemoryBlock file;
+        auto r = getRandom();
+
+        {
+            AudioBuffer<float> buffer (numChannels, numSamples);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int i = 0; i < numSamples; ++i)
+                    buffer.setSample (ch, i, (r.nextFloat() - 0.5f) * std::sin ((float) i * 0.001f));
+
+            std::unique_ptr<AudioFormatWriter> writer (ogg.createWriterFor (new MemoryOutputStream (file, false),
+                                                                            44100.0, numChannels, 16, {}, 0));
+            writer->writeFromAudioSampleBuffer (buffer, 0, numSamples);
+        }
+
+        auto createReader = [&] { return std::unique_ptr<AudioFormatReader> (ogg.createReaderFor (new MemoryInputStream (file, false), true)); };
+
+        AudioBuffer<float> decoded (numChannels, numSamples);
+        createReader()->read (&decoded, 0, numSamples, 0, true, true);
+
+        auto expectMatchesSequentialDecode = [&] (AudioFormatReader& reader, int64 start, int num)
+        {
+            AudioBuffer<float> buffer (numChannels, num);
+            reader.read (&buffer, 0, num, start, true, true);
+            auto numValid = (int) jlimit ((int64) 0, (int64) num, numSamples - start);
+            bool matches = true;
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                matches = matches && memcmp (buffer.getReadPointer (ch), decoded.getReadPointer (ch, (int) start),
+                                             sizeof (float) * (size_t) numValid) == 0;
+
+                for (int i = numValid; i < num; ++i)
+                    matches = matches && buffer.getSample (ch, i) == 0.0f;
+            }
+
+            expect (matches);
+        };
+
+        beginTest ("Random access matches sequential decoding");
+        {
+            auto reader = createReader();
+            expectEquals (reader->lengthInSamples, (int64) numSamples);
+
+            for (int i = 0; i < 100; ++i)
+                expectMatchesSequentialDecode (*reader, r.nextInt (numSamples), 1 + r.nextInt (20000));
+        }
+
+        beginTest ("Interleaved reads from several positions");
+        {
+            auto reader = createReader();
+            int64 positions[] = { 0, 50000, 100000, 150000 };
+
+            for (int i = 0; i < 200; ++i)
+            {
+                auto& pos = positions[i % 4];
+                expectMatchesSequentialDecode (*reader, pos, 1000);
+                pos += 1000;
+            }
+        }
+    }
+};
+
+static OggVorbisAudioFormatTests oggVorbisAudioFormatTests;
+
+#endif
+
 #endif
 
 } // namespace juce
@@ -1602,6 +1602,9 @@ public:
 
     void readMaxLevels (int64 startSampleInFile, int64 numSamples, Range<float>* results, int numChannelsToRead) override
     {
+        if (readMaxLevelsFromPeakIndex (startSampleInFile, numSamples, results, numChannelsToRead))
+            return;
+
         numSamples = jmin (numSamples, lengthInSamples - startSampleInFile);
 
         if (map == nullptr || numSamples <= 0 || ! mappedSection.contains (Range<int64> (startSampleInFile, startSampleInFile + numSamples)))
@@ -1692,6 +1695,141 @@ AudioFormatReader* WavAudioFormat::createReaderFor (InputStream* sourceStream, b
     return nullptr;
 }
 
+AudioFormat::ProbeResult WavAudioFormat::probe (InputStream& in)
+{
+    using namespace WavFileHelpers;
+
+    // This follows the same rules as WavAudioFormatReader, but only looks at
+    // the fmt, ds64 and data chunks, so it can stop as soon as it's seen them.
+    ProbeResult result;
+    uint64 end = 0;
+    int64 dataLength = 0;
+    int bytesPerFrame = 0;
+    bool isRF64 = false, hasGotFormat = false, hasGotData = false;
+
+    auto streamStartPos = in.getPosition();
+    auto firstChunkType = in.readInt();
+
+    if (firstChunkType == chunkName ("RF64"))
+    {
+        in.skipNextBytes (4); // size is -1 for RF64
+        isRF64 = true;
+    }
+    else if (firstChunkType == chunkName ("RIFF"))
+    {
+        auto len = (uint64) (uint32) in.readInt();
+        end = len + (uint64) in.getPosition();
+    }
+    else
+    {
+        return result;
+    }
+
+    auto startOfRIFFChunk = in.getPosition();
+
+    if (in.readInt() != chunkName ("WAVE"))
+        return result;
+
+    if (isRF64 && in.readInt() == chunkName ("ds64"))
+    {
+        auto length = (uint32) in.readInt();
+
+        if (length < 28)
+            return result;
+
+        auto chunkEnd = in.getPosition() + length + (length & 1);
+        end = (uint64) in.readInt64() + (uint64) startOfRIFFChunk;
+        dataLength = in.readInt64();
+        in.setPosition (chunkEnd);
+    }
+
+    while ((uint64) in.getPosition() < end && ! in.isExhausted() && ! (hasGotFormat && hasGotData))
+    {
+        auto chunkType = in.readInt();
+        auto length = (uint32) in.readInt();
+        auto chunkEnd = in.getPosition() + length + (length & 1);
+
+        if (chunkType == chunkName ("fmt "))
+        {
+            hasGotFormat = true;
+            auto format = (unsigned short) in.readShort();
+            result.numChannels = (unsigned int) in.readShort();
+            result.sampleRate = in.readInt();
+            auto bytesPerSec = in.readInt();
+            in.skipNextBytes (2);
+            result.bitsPerSample = (unsigned int) (int) in.readShort();
+
+            if (result.bitsPerSample > 64)
+            {
+                bytesPerFrame = result.sampleRate > 0 ? bytesPerSec / (int) result.sampleRate : 0;
+                result.bitsPerSample = result.numChannels > 0 ? 8 * (unsigned int) bytesPerFrame / result.numChannels : 0;
+            }
+            else
+            {
+                bytesPerFrame = (int) (result.numChannels * result.bitsPerSample / 8);
+            }
+
+            if (format == 3)
+            {
+                result.usesFloatingPointData = true;
+            }
+            else if (format == 0xfffe) // WAVE_FORMAT_EXTENSIBLE
+            {
+                if (length < 40) // too short
+                {
+                    bytesPerFrame = 0;
+                }
+                else
+                {
+                    in.skipNextBytes (8); // skip over size, bitsPerSample and channel mask
+
+                    ExtensibleWavSubFormat subFormat;
+                    subFormat.data1 = (uint32) in.readInt();
+                    subFormat.data2 = (uint16) in.readShort();
+                    subFormat.data3 = (uint16) in.readShort();
+                    in.read (subFormat.data4, sizeof (subFormat.data4));
+
+                    if (subFormat == IEEEFloatFormat)
+                        result.usesFloatingPointData = true;
+                    else if (subFormat != pcmFormat && subFormat != ambisonicFormat)
+                        bytesPerFrame = 0;
+                }
+            }
+            else if (format == 0x674f || format == 0x6750 || format == 0x6751
+                  || format == 0x676f || format == 0x6770 || format == 0x6771)
+            {
+                // Ogg-Vorbis data wrapped in a wav file: leave it to a full reader
+                in.setPosition (streamStartPos);
+                return AudioFormat::probe (in);
+            }
+            else if (format != 1)
+            {
+                bytesPerFrame = 0;
+            }
+        }
+        else if (chunkType == chunkName ("data"))
+        {
+            hasGotData = true;
+
+            if (! isRF64) // data size is expected to be -1, actual data size is in ds64 chunk
+                dataLength = length;
+
+            result.lengthInSamples = (bytesPerFrame > 0) ? (dataLength / bytesPerFrame) : 0;
+        }
+        else if (chunkEnd <= in.getPosition())
+        {
+            break;
+        }
+
+        in.setPosition (chunkEnd);
+    }
+
+    if (result.sampleRate > 0 && result.numChannels > 0 && bytesPerFrame > 0 && result.bitsPerSample <= 32)
+        result.format = this;
+
+    return result;
+}
+
 MemoryMappedAudioFormatReader* WavAudioFormat::createMemoryMappedReader (const File& file)
 {
     return createMemoryMappedReader (file.createInputStream());
@@ -55,6 +55,26 @@ StringArray AudioFormat::getFileExtensions() const              { return fileExt
 bool AudioFormat::isCompressed()                                { return false; }
 StringArray AudioFormat::getQualityOptions()                    { return {}; }
 
+AudioFormat::ProbeResult AudioFormat::probe (InputStream& sourceStream)
+{
+    ProbeResult result;
+
+    // the reader gets a non-owning wrapper, as the caller keeps ownership of the stream
+    auto* wrapper = new SubregionStream (&sourceStream, sourceStream.getPosition(), -1, false);
+
+    if (std::unique_ptr<AudioFormatReader> reader { createReaderFor (wrapper, true) })
+    {
+        result.format                = this;
+        result.sampleRate            = reader->sampleRate;
+        result.numChannels           = reader->numChannels;
+        result.bitsPerSample         = reader->bitsPerSample;
+        result.lengthInSamples       = reader->lengthInSamples;
+        result.usesFloatingPointData = reader->usesFloatingPointData;
+    }
+
+    return result;
+}
+
 MemoryMappedAudioFormatReader* AudioFormat::createMemoryMappedReader (const File&)
 {
     return nullptr;
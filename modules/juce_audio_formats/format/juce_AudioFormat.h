@@ -111,6 +111,43 @@ public:
     virtual AudioFormatReader* createReaderFor (InputStream* sourceStream,
                                                 bool deleteStreamIfOpeningFails) = 0;
 
+    //==============================================================================
+    /** Describes the audio in a stream, as found by probe().
+
+        @see AudioFormat::probe, AudioFormatManager::probe
+    */
+    struct JUCE_API  ProbeResult
+    {
+        /** The format that recognised the stream, or nullptr if it wasn't recognised. */
+        AudioFormat* format = nullptr;
+
+        double sampleRate = 0;
+        unsigned int numChannels = 0;
+        unsigned int bitsPerSample = 0;
+        int64 lengthInSamples = 0;
+        bool usesFloatingPointData = false;
+
+        /** True if the length was estimated, e.g. from the size of a VBR-less MP3. */
+        bool lengthIsEstimate = false;
+
+        /** Returns true if the stream was recognised. */
+        bool wasRecognised() const noexcept     { return format != nullptr; }
+    };
+
+    /** Tries to identify a stream of this format without creating a reader for it.
+
+        This is intended for quickly scanning large numbers of files: formats that
+        override it look only at the stream's headers (and possibly its last few KB),
+        so it's much cheaper than calling createReaderFor() and throwing the reader
+        away. The details it returns should match those of the reader that
+        createReaderFor() would create for the same stream.
+
+        The stream is read from its current position, and its position afterwards is
+        undefined. The base class implementation just creates a reader and copies its
+        details.
+    */
+    virtual ProbeResult probe (InputStream& sourceStream);
+
     /** Attempts to create a MemoryMappedAudioFormatReader, if possible for this format.
         If the format does not support this, the method will return nullptr;
     */
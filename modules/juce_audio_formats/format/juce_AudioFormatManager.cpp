@@ -49,6 +49,9 @@ void AudioFormatManager::registerFormat (AudioFormat* newFormat, bool makeThisTh
             defaultFormatIndex = getNumKnownFormats();
 
         knownFormats.add (newFormat);
+
+        const ScopedLock sl (probeLock);
+        lastProbedFormats.clear();
     }
 }
 
@@ -82,6 +85,9 @@ void AudioFormatManager::clearFormats()
 {
     knownFormats.clear();
     defaultFormatIndex = 0;
+
+    const ScopedLock sl (probeLock);
+    lastProbedFormats.clear();
 }
 
 int AudioFormatManager::getNumKnownFormats() const                  { return knownFormats.size(); }
@@ -163,4 +169,329 @@ AudioFormatReader* AudioFormatManager::createReaderFor (InputStream* audioFileSt
     return nullptr;
 }
 
+//==============================================================================
+AudioFormat::ProbeResult AudioFormatManager::probe (const File& file)
+{
+    // you need to actually register some formats before the manager can
+    // use them to open a file!
+    jassert (getNumKnownFormats() > 0);
+
+    auto extension = file.getFileExtension().toLowerCase();
+    AudioFormat* lastFormat;
+
+    {
+        const ScopedLock sl (probeLock);
+        lastFormat = lastProbedFormats[extension];
+    }
+
+    // (the headers are read a few bytes at a time, so this saves a lot of small reads)
+    std::unique_ptr<BufferedInputStream> in;
+
+    auto tryFormat = [&] (AudioFormat& af)
+    {
+        if (in == nullptr)
+        {
+            if (auto* fileStream = file.createInputStream())
+                in.reset (new BufferedInputStream (fileStream, 4096, true));
+        }
+        else
+        {
+            in->setPosition (0);
+        }
+
+        return in != nullptr ? af.probe (*in) : AudioFormat::ProbeResult();
+    };
+
+    if (lastFormat != nullptr && lastFormat->canHandleFile (file))
+    {
+        auto result = tryFormat (*lastFormat);
+
+        if (result.wasRecognised() || in == nullptr)
+            return result;
+    }
+
+    for (auto* af : knownFormats)
+    {
+        if (af != lastFormat && af->canHandleFile (file))
+        {
+            auto result = tryFormat (*af);
+
+            if (result.wasRecognised())
+            {
+                const ScopedLock sl (probeLock);
+                lastProbedFormats.set (extension, af);
+                return result;
+            }
+
+            if (in == nullptr)
+                break;
+        }
+    }
+
+    return {};
+}
+
+AudioFormat::ProbeResult AudioFormatManager::probe (InputStream& in)
+{
+    // you need to actually register some formats before the manager can
+    // use them to open a file!
+    jassert (getNumKnownFormats() > 0);
+
+    auto originalStreamPos = in.getPosition();
+
+    for (auto* af : knownFormats)
+    {
+        auto result = af->probe (in);
+
+        if (result.wasRecognised())
+            return result;
+
+        in.setPosition (originalStreamPos);
+
+        // the stream that is passed-in must be capable of being repositioned so
+        // that all the formats can have a go at probing it.
+        jassert (in.getPosition() == originalStreamPos);
+    }
+
+    return {};
+}
+
+Array<AudioFormat::ProbeResult> AudioFormatManager::probeFiles (const Array<File>& files, ThreadPool& pool)
+{
+    // This is shared with the pool's jobs, as some of them may not get started until
+    // after all the files have been done and this method has returned.
+    struct SharedState
+    {
+        Array<File> files;
+        Array<AudioFormat::ProbeResult> results;
+        std::atomic<int> nextIndex { 0 }, numDone { 0 };
+        WaitableEvent finished;
+    };
+
+    if (files.isEmpty())
+        return {};
+
+    auto state = std::make_shared<SharedState>();
+    state->files = files;
+    state->results.resize (files.size());
+
+    auto probeNextFiles = [this, state]
+    {
+        for (;;)
+        {
+            auto index = state->nextIndex++;
+
+            if (index >= state->files.size())
+                return;
+
+            state->results.getReference (index) = probe (state->files.getReference (index));
+
+            if (++state->numDone == state->files.size())
+                state->finished.signal();
+        }
+    };
+
+    for (int i = jmin (pool.getNumThreads(), files.size() - 1); --i >= 0;)
+        pool.addJob (probeNextFiles);
+
+    probeNextFiles();
+    state->finished.wait();
+
+    return state->results;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct AudioFormatManagerProbeTests  : public UnitTest
+{
+    AudioFormatManagerProbeTests()  : UnitTest ("Audio format probing", "Audio") {}
+
+    MemoryBlock createTestData (AudioFormat& format, double sampleRate, int numChannels, int bitsPerSample, int numSamples)
+    {
+        AudioBuffer<float> buffer (numChannels, numSamples);
+        auto r = getRandom();
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (ch, i, r.nextFloat() - 0.5f);
+
+        MemoryBlock data;
+        std::unique_ptr<AudioFormatWriter> writer (format.createWriterFor (new MemoryOutputStream (data, false), sampleRate,
+                                                                           (unsigned int) numChannels, bitsPerSample, {}, 0));
+        expect (writer != nullptr);
+
+        if (writer != nullptr)
+            writer->writeFromAudioSampleBuffer (buffer, 0, numSamples);
+
+        writer.reset();
+        return data;
+    }
+
+    // A stream of silent 128kbps, 44.1kHz mono MPEG-1 layer 3 frames
+    static MemoryBlock createMP3Data (int numFrames)
+    {
+        const uint8 header[] = { 0xff, 0xfb, 0x90, 0xc0 };
+        MemoryBlock data ((size_t) (417 * numFrames), true);
+
+        for (int i = 0; i < numFrames; ++i)
+            data.copyFrom (header, i * 417, sizeof (header));
+
+        return data;
+    }
+
+    void expectProbeMatchesReader (AudioFormatManager& manager, const MemoryBlock& data)
+    {
+        MemoryInputStream in (data, false);
+        auto result = manager.probe (in);
+        std::unique_ptr<AudioFormatReader> reader (manager.createReaderFor (new MemoryInputStream (data, false)));
+
+        expect (result.wasRecognised());
+        expect (reader != nullptr);
+
+        if (result.wasRecognised() && reader != nullptr)
+        {
+            expectEquals (result.format->getFormatName(), reader->getFormatName());
+            expectEquals (result.sampleRate, reader->sampleRate);
+            expectEquals ((int) result.numChannels, (int) reader->numChannels);
+            expectEquals ((int) result.bitsPerSample, (int) reader->bitsPerSample);
+            expectEquals (result.lengthInSamples, reader->lengthInSamples);
+            expect (result.usesFloatingPointData == reader->usesFloatingPointData);
+        }
+    }
+
+    void runTest() override
+    {
+        AudioFormatManager manager;
+        manager.registerBasicFormats();
+
+        beginTest ("Probing matches the readers");
+        {
+            WavAudioFormat wav;
+            expectProbeMatchesReader (manager, createTestData (wav, 44100.0, 2, 16, 12345));
+            expectProbeMatchesReader (manager, createTestData (wav, 96000.0, 1, 24, 5000));
+            expectProbeMatchesReader (manager, createTestData (wav, 48000.0, 6, 32, 3000));
+
+            AiffAudioFormat aiff;
+            expectProbeMatchesReader (manager, createTestData (aiff, 44100.0, 2, 16, 12345));
+            expectProbeMatchesReader (manager, createTestData (aiff, 22050.0, 1, 24, 777));
+
+           #if JUCE_USE_FLAC
+            FlacAudioFormat flac;
+            expectProbeMatchesReader (manager, createTestData (flac, 44100.0, 2, 16, 12345));
+            expectProbeMatchesReader (manager, createTestData (flac, 96000.0, 1, 24, 100000));
+           #endif
+
+           #if JUCE_USE_OGGVORBIS
+            OggVorbisAudioFormat ogg;
+            expectProbeMatchesReader (manager, createTestData (ogg, 44100.0, 2, 16, 123456));
+            expectProbeMatchesReader (manager, createTestData (ogg, 22050.0, 1, 16, 999));
+           #endif
+
+           #if JUCE_USE_MP3AUDIOFORMAT
+            auto mp3 = createMP3Data (300);
+            expectProbeMatchesReader (manager, mp3);
+
+            MemoryInputStream in (mp3, false);
+            expect (manager.probe (in).lengthIsEstimate);
+
+            // with an ID3v2 tag in front of it
+            MemoryOutputStream tagged;
+            const uint8 id3Header[] = { 'I', 'D', '3', 3, 0, 0, 0, 0, 1, 0 };
+            tagged.write (id3Header, sizeof (id3Header));
+            tagged.writeRepeatedByte (0, 128);
+            tagged << mp3;
+            expectProbeMatchesReader (manager, tagged.getMemoryBlock());
+
+            // with a Xing header frame giving a frame count that's less than the size of
+            // the data would suggest, so that the length can only have come from the header
+            auto xing = createMP3Data (301);
+            const char xingTag[] = { 'X', 'i', 'n', 'g', 0, 0, 0, 1, 0, 0, 0, (char) 200 };
+            xing.copyFrom (xingTag, 4 + 17, sizeof (xingTag));
+            expectProbeMatchesReader (manager, xing);
+
+            MemoryInputStream xingIn (xing, false), plainIn (mp3, false);
+            auto xingResult = manager.probe (xingIn);
+            expect (! xingResult.lengthIsEstimate);
+            expect (xingResult.lengthInSamples < manager.probe (plainIn).lengthInSamples);
+           #endif
+        }
+
+        beginTest ("Unrecognised data");
+        {
+            auto r = getRandom();
+
+            for (int i = 0; i < 20; ++i)
+            {
+                MemoryBlock data ((size_t) (1 + r.nextInt (4096)));
+                r.fillBitsRandomly (data.getData(), data.getSize());
+
+                // sometimes with a plausible start
+                if (i % 2 == 0 && data.getSize() > 4)
+                    data.copyFrom (i % 4 == 0 ? "RIFF" : "FORM", 0, 4);
+
+                MemoryInputStream in (data, false);
+                expect (! manager.probe (in).wasRecognised());
+            }
+
+            MemoryInputStream empty (nullptr, 0, false);
+            expect (! manager.probe (empty).wasRecognised());
+        }
+
+        beginTest ("Probing files");
+        {
+            auto dir = File::getSpecialLocation (File::tempDirectory).getNonexistentChildFile ("ProbeTest", {});
+            dir.createDirectory();
+
+            WavAudioFormat wav;
+            AiffAudioFormat aiff;
+            Array<File> files;
+
+            auto addFile = [&] (const String& fileName, const MemoryBlock& data)
+            {
+                auto f = dir.getChildFile (fileName);
+                f.replaceWithData (data.getData(), data.getSize());
+                files.add (f);
+            };
+
+            for (int i = 0; i < 20; ++i)
+            {
+                addFile ("test" + String (i) + ".wav",  createTestData (wav,  44100.0, 2, 16, 1000 + i));
+                addFile ("test" + String (i) + ".aiff", createTestData (aiff, 48000.0, 1, 24, 2000 + i));
+            }
+
+            addFile ("wrongExtension.wav", createTestData (aiff, 48000.0, 1, 24, 100));
+            addFile ("notAudio.txt", MemoryBlock (1000, true));
+            files.add (dir.getChildFile ("doesntExist.wav"));
+
+            ThreadPool pool (3);
+            auto results = manager.probeFiles (files, pool);
+            expectEquals (results.size(), files.size());
+
+            for (int i = 0; i < files.size(); ++i)
+            {
+                auto& result = results.getReference (i);
+                std::unique_ptr<AudioFormatReader> reader (manager.createReaderFor (files[i]));
+                expect (result.wasRecognised() == (reader != nullptr));
+
+                if (result.wasRecognised() && reader != nullptr)
+                {
+                    expectEquals (result.sampleRate, reader->sampleRate);
+                    expectEquals ((int) result.numChannels, (int) reader->numChannels);
+                    expectEquals (result.lengthInSamples, reader->lengthInSamples);
+                }
+            }
+
+            expect (manager.probe (files[0]).format == manager.findFormatForFileExtension ("wav"));
+            expect (manager.probeFiles ({}, pool).isEmpty());
+
+            dir.deleteRecursively();
+        }
+    }
+};
+
+static AudioFormatManagerProbeTests audioFormatManagerProbeTests;
+
+#endif
+
 } // namespace juce
@@ -133,11 +133,52 @@ public:
     */
     AudioFormatReader* createReaderFor (InputStream* audioFileStream);
 
+    //==============================================================================
+    /** Finds out which of the known formats can read this file, along with its sample
+        rate, number of channels and length, without creating a reader for it.
+
+        Like createReaderFor(), this only tries the formats that say they can handle the
+        file, but it uses AudioFormat::probe(), which for the built-in formats only reads
+        the file's headers. This makes it much quicker for scanning large numbers of files.
+
+        When more than one format claims a file extension, the one that last recognised a
+        file with that extension gets tried first.
+
+        If the file can't be read, the result's format will be nullptr. This can be called
+        from several threads at once, as long as the list of formats isn't being changed.
+
+        @see probeFiles, AudioFormat::probe
+    */
+    AudioFormat::ProbeResult probe (const File& audioFile);
+
+    /** Finds out which of the known formats can read this stream, without creating a
+        reader for it.
+
+        The stream must be capable of being repositioned so that all the formats can have
+        a go at probing it. If none of them recognise it, the result's format will be nullptr.
+
+        @see AudioFormat::probe
+    */
+    AudioFormat::ProbeResult probe (InputStream& audioFileStream);
+
+    /** Probes a list of files, using the given thread pool to work on several at once.
+
+        This returns one result for each file, in the same order as the array that was
+        passed in. The calling thread helps out while the pool's threads are busy, and
+        the method returns when all the files have been probed.
+
+        @see probe
+    */
+    Array<AudioFormat::ProbeResult> probeFiles (const Array<File>& files, ThreadPool& pool);
+
 private:
     //==============================================================================
     OwnedArray<AudioFormat> knownFormats;
     int defaultFormatIndex = 0;
 
+    CriticalSection probeLock;
+    HashMap<String, AudioFormat*> lastProbedFormats;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioFormatManager)
 };
 
@@ -208,6 +208,9 @@ void AudioFormatReader::readMaxLevels (int64 startSampleInFile, int64 numSamples
         return;
     }
 
+    if (readMaxLevelsFromPeakIndex (startSampleInFile, numSamples, results, channelsToRead))
+        return;
+
     auto bufferSize = (int) jmin (numSamples, (int64) 4096);
     AudioBuffer<float> tempSampleBuffer ((int) channelsToRead, bufferSize);
 
@@ -269,6 +272,40 @@ void AudioFormatReader::readMaxLevels (int64 startSampleInFile, int64 numSamples
     highestRight = levels[1].getEnd();
 }
 
+bool AudioFormatReader::readMaxLevelsFromPeakIndex (int64 startSampleInFile, int64 numSamples,
+                                                    Range<float>* results, int channelsToRead)
+{
+    if (peakIndex == nullptr || ! peakIndex->matches (*this))
+        return false;
+
+    const int64 blockSize = AudioPeakIndex::samplesPerBlock;
+    auto endSample = startSampleInFile + numSamples;
+    auto firstBlock = jmax ((int64) 0, (startSampleInFile + blockSize - 1) / blockSize);
+    auto endBlock = jmin (peakIndex->getNumBlocks(), endSample / blockSize);
+
+    if (endBlock <= firstBlock)
+        return false;
+
+    peakIndex->getLevels (firstBlock, endBlock - firstBlock, results, nullptr, channelsToRead);
+
+    // Neither of the ends can contain a whole block, so these calls won't come back here
+    HeapBlock<Range<float>> edgeLevels (channelsToRead);
+
+    for (auto edge : { Range<int64> (startSampleInFile, firstBlock * blockSize),
+                       Range<int64> (endBlock * blockSize, endSample) })
+    {
+        if (! edge.isEmpty())
+        {
+            readMaxLevels (edge.getStart(), edge.getLength(), edgeLevels, channelsToRead);
+
+            for (int i = 0; i < channelsToRead; ++i)
+                results[i] = results[i].getUnionWith (edgeLevels[i]);
+        }
+    }
+
+    return true;
+}
+
 int64 AudioFormatReader::searchForLevel (int64 startSample,
                                          int64 numSamplesToSearch,
                                          double magnitudeRangeMinimum,
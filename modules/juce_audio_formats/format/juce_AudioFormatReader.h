@@ -28,6 +28,7 @@ namespace juce
 {
 
 class AudioFormat;
+class AudioPeakIndex;
 
 
 //==============================================================================
@@ -216,6 +217,20 @@ public:
                           double magnitudeRangeMaximum,
                           int minimumConsecutiveSamples);
 
+    //==============================================================================
+    /** Gives the reader a peak index that readMaxLevels() can use instead of scanning
+        the samples in the ranges it's asked for.
+
+        The index must have been built from the same audio data that this reader
+        reads, and is ignored if its length or number of channels doesn't match. You
+        should set it before any other threads start calling readMaxLevels().
+
+        @see AudioPeakIndex
+    */
+    void setPeakIndex (std::shared_ptr<const AudioPeakIndex> newIndex) noexcept  { peakIndex = std::move (newIndex); }
+
+    /** Returns the peak index that was set with setPeakIndex(), if there is one. */
+    const std::shared_ptr<const AudioPeakIndex>& getPeakIndex() const noexcept   { return peakIndex; }
 
     //==============================================================================
     /** The sample-rate of the stream. */
@@ -272,6 +287,17 @@ public:
 
 
 protected:
+    //==============================================================================
+    /** Used by subclasses that override readMaxLevels() to make use of a peak index.
+
+        If the reader has a peak index that covers at least one whole block of the range,
+        this finds the levels of those blocks from the index, calls readMaxLevels() for
+        the samples at either end of the range, and returns true. Otherwise it does
+        nothing and returns false.
+    */
+    bool readMaxLevelsFromPeakIndex (int64 startSample, int64 numSamples,
+                                     Range<float>* results, int numChannelsToRead);
+
     //==============================================================================
     /** Used by AudioFormatReader subclasses to copy data to different formats. */
     template <class DestSampleType, class SourceSampleType, class SourceEndianness>
@@ -322,6 +348,7 @@ protected:
 
 private:
     String formatName;
+    std::shared_ptr<const AudioPeakIndex> peakIndex;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioFormatReader)
 };
@@ -227,7 +227,7 @@ public:
         isRunning = false;
         timeSliceThread.removeTimeSliceClient (this);
 
-        while (writePendingData() == 0)
+        while (writePendingData (true) == 0)
         {}
     }
 
@@ -242,7 +242,11 @@ public:
         fifo.prepareToWrite (numSamples, start1, size1, start2, size2);
 
         if (size1 + size2 < numSamples)
+        {
+            ++numOverruns;
+            numSamplesDropped += numSamples;
             return false;
+        }
 
         for (int i = buffer.getNumChannels(); --i >= 0;)
         {
@@ -251,18 +255,45 @@ public:
         }
 
         fifo.finishedWrite (size1 + size2);
-        timeSliceThread.notify();
+
+        auto numBuffered = fifo.getNumReady();
+
+        if (numBuffered > maxSamplesBuffered)
+            maxSamplesBuffered = numBuffered;
+
+        if (numBuffered >= writeBatchSize)
+            timeSliceThread.notify();
+
         return true;
     }
 
     int useTimeSlice() override
     {
-        return writePendingData();
+        return writePendingData (false);
     }
 
-    int writePendingData()
+    int getMillisecondsUntilDeadline() override
+    {
+        auto rate = writer->getSampleRate();
+
+        if (rate <= 0)
+            return std::numeric_limits<int>::max();
+
+        return (int) (fifo.getFreeSpace() * 1000.0 / rate);
+    }
+
+    int writePendingData (bool writeEverything)
     {
         auto numToDo = fifo.getTotalSize() / 4;
+        auto batchSize = writeBatchSize.load();
+
+        if (batchSize > 0 && ! writeEverything)
+        {
+            numToDo = (fifo.getNumReady() / batchSize) * batchSize;
+
+            if (numToDo <= 0)
+                return 10;
+        }
 
         int start1, size1, start2, size2;
         fifo.prepareToRead (numToDo, start1, size1, start2, size2);
@@ -270,38 +301,65 @@ public:
         if (size1 <= 0)
             return 10;
 
+        auto startTime = Time::getMillisecondCounterHiRes();
+
         writer->writeFromAudioSampleBuffer (buffer, start1, size1);
 
-        const ScopedLock sl (thumbnailLock);
+        {
+            const ScopedLock sl (thumbnailLock);
 
-        if (receiver != nullptr)
-            receiver->addBlock (samplesWritten, buffer, start1, size1);
+            if (receiver != nullptr)
+                receiver->addBlock (samplesWritten, buffer, start1, size1);
 
-        samplesWritten += size1;
+            samplesWritten += size1;
 
-        if (size2 > 0)
-        {
-            writer->writeFromAudioSampleBuffer (buffer, start2, size2);
+            if (size2 > 0)
+            {
+                writer->writeFromAudioSampleBuffer (buffer, start2, size2);
 
-            if (receiver != nullptr)
-                receiver->addBlock (samplesWritten, buffer, start2, size2);
+                if (receiver != nullptr)
+                    receiver->addBlock (samplesWritten, buffer, start2, size2);
 
-            samplesWritten += size2;
-        }
+                samplesWritten += size2;
+            }
 
-        fifo.finishedRead (size1 + size2);
+            fifo.finishedRead (size1 + size2);
 
-        if (samplesPerFlush > 0)
-        {
-            flushSampleCounter -= size1 + size2;
+            if (samplesPerFlush > 0)
+            {
+                flushSampleCounter -= size1 + size2;
+
+                if (flushSampleCounter <= 0)
+                {
+                    flushSampleCounter = samplesPerFlush;
+                    writer->flush();
+                }
+            }
 
-            if (flushSampleCounter <= 0)
+            if (samplesPerSync > 0)
             {
-                flushSampleCounter = samplesPerFlush;
-                writer->flush();
+                syncSampleCounter -= size1 + size2;
+
+                if (syncSampleCounter <= 0)
+                {
+                    syncSampleCounter = samplesPerSync;
+                    writer->flush();
+
+                    if (writer->output != nullptr)
+                        writer->output->flush();
+                }
             }
         }
 
+        auto writeTime = Time::getMillisecondCounterHiRes() - startTime;
+
+        {
+            const SpinLock::ScopedLockType statsLock (statisticsLock);
+            ++numWrites;
+            totalWriteTimeMs += writeTime;
+            maxWriteTimeMs = jmax (maxWriteTimeMs, writeTime);
+        }
+
         return 0;
     }
 
@@ -320,6 +378,42 @@ public:
         samplesPerFlush = numSamples;
     }
 
+    void setSyncInterval (int numSamples) noexcept
+    {
+        samplesPerSync = numSamples;
+    }
+
+    void setWriteBatchSize (int numSamples) noexcept
+    {
+        jassert (numSamples <= fifo.getTotalSize() / 2); // the FIFO needs to be bigger than this!
+        writeBatchSize = jmax (0, numSamples);
+    }
+
+    Statistics getStatistics() const
+    {
+        Statistics s;
+        s.numOverruns        = numOverruns;
+        s.numSamplesDropped  = numSamplesDropped;
+        s.maxSamplesBuffered = maxSamplesBuffered;
+
+        const SpinLock::ScopedLockType sl (statisticsLock);
+        s.numWrites        = numWrites;
+        s.totalWriteTimeMs = totalWriteTimeMs;
+        s.maxWriteTimeMs   = maxWriteTimeMs;
+        return s;
+    }
+
+    void resetStatistics()
+    {
+        numOverruns = 0;
+        numSamplesDropped = 0;
+        maxSamplesBuffered = 0;
+
+        const SpinLock::ScopedLockType sl (statisticsLock);
+        numWrites = 0;
+        totalWriteTimeMs = maxWriteTimeMs = 0;
+    }
+
 private:
     AbstractFifo fifo;
     AudioBuffer<float> buffer;
@@ -329,8 +423,16 @@ private:
     IncomingDataReceiver* receiver = {};
     int64 samplesWritten = 0;
     int samplesPerFlush = 0, flushSampleCounter = 0;
+    int samplesPerSync = 0, syncSampleCounter = 0;
+    std::atomic<int> writeBatchSize { 0 };
     std::atomic<bool> isRunning { true };
 
+    std::atomic<int> numOverruns { 0 }, maxSamplesBuffered { 0 };
+    std::atomic<int64> numSamplesDropped { 0 };
+    SpinLock statisticsLock;
+    int64 numWrites = 0;
+    double totalWriteTimeMs = 0, maxWriteTimeMs = 0;
+
     JUCE_DECLARE_NON_COPYABLE (Buffer)
 };
 
@@ -358,4 +460,116 @@ void AudioFormatWriter::ThreadedWriter::setFlushInterval (int numSamplesPerFlush
     buffer->setFlushInterval (numSamplesPerFlush);
 }
 
+void AudioFormatWriter::ThreadedWriter::setSyncInterval (int numSamplesPerSync) noexcept
+{
+    buffer->setSyncInterval (numSamplesPerSync);
+}
+
+void AudioFormatWriter::ThreadedWriter::setWriteBatchSize (int numSamples) noexcept
+{
+    buffer->setWriteBatchSize (numSamples);
+}
+
+AudioFormatWriter::ThreadedWriter::Statistics AudioFormatWriter::ThreadedWriter::getStatistics() const
+{
+    return buffer->getStatistics();
+}
+
+void AudioFormatWriter::ThreadedWriter::resetStatistics()
+{
+    buffer->resetStatistics();
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct ThreadedWriterTests  : public UnitTest
+{
+    ThreadedWriterTests()  : UnitTest ("ThreadedWriter", "Audio") {}
+
+    enum { numChannels = 2, blockSize = 512, numBlocks = 200 };
+
+    static AudioFormatWriter* createWriter (MemoryBlock& block)
+    {
+        WavAudioFormat wav;
+        return wav.createWriterFor (new MemoryOutputStream (block, false), 48000.0, numChannels, 32, {}, 0);
+    }
+
+    void runTest() override
+    {
+        TimeSliceThread thread ("ThreadedWriter test");
+        thread.startThread();
+
+        auto r = getRandom();
+        AudioBuffer<float> source (numChannels, blockSize * numBlocks);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < source.getNumSamples(); ++i)
+                source.setSample (ch, i, r.nextFloat() - 0.5f);
+
+        beginTest ("Batched writing");
+        {
+            MemoryBlock block;
+            AudioFormatWriter::ThreadedWriter::Statistics stats;
+
+            {
+                AudioFormatWriter::ThreadedWriter writer (createWriter (block), thread, 48000);
+                writer.setWriteBatchSize (8192);
+                writer.setSyncInterval (16384);
+
+                for (int i = 0; i < numBlocks; ++i)
+                {
+                    const float* channels[] = { source.getReadPointer (0, i * blockSize),
+                                                source.getReadPointer (1, i * blockSize) };
+
+                    while (! writer.write (channels, blockSize))
+                        Thread::sleep (1);
+
+                    if (i % 16 == 0)
+                        Thread::sleep (1);
+                }
+
+                stats = writer.getStatistics();
+            }
+
+            expect (stats.numWrites <= (blockSize * numBlocks) / 8192);
+            expect (stats.maxSamplesBuffered >= blockSize);
+            expect (stats.totalWriteTimeMs >= stats.maxWriteTimeMs);
+
+            // the last, partial batch is written when the writer is deleted
+            WavAudioFormat wav;
+            std::unique_ptr<AudioFormatReader> reader (wav.createReaderFor (new MemoryInputStream (block, false), true));
+            expect (reader != nullptr);
+            expectEquals (reader->lengthInSamples, (int64) source.getNumSamples());
+
+            AudioBuffer<float> result (numChannels, source.getNumSamples());
+            reader->read (&result, 0, result.getNumSamples(), 0, true, true);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                expect (memcmp (result.getReadPointer (ch), source.getReadPointer (ch), sizeof (float) * (size_t) result.getNumSamples()) == 0);
+        }
+
+        beginTest ("Overruns");
+        {
+            MemoryBlock block;
+            AudioFormatWriter::ThreadedWriter writer (createWriter (block), thread, 1024);
+            const float* channels[] = { source.getReadPointer (0), source.getReadPointer (1) };
+
+            expect (! writer.write (channels, 2048));
+            expect (! writer.write (channels, 4096));
+
+            auto stats = writer.getStatistics();
+            expectEquals (stats.numOverruns, 2);
+            expectEquals (stats.numSamplesDropped, (int64) 6144);
+
+            writer.resetStatistics();
+            expectEquals (writer.getStatistics().numOverruns, 0);
+        }
+    }
+};
+
+static ThreadedWriterTests threadedWriterTests;
+
+#endif
+
 } // namespace juce
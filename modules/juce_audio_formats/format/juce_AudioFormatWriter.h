@@ -180,6 +180,11 @@ public:
     /**
         Provides a FIFO for an AudioFormatWriter, allowing you to push incoming
         data into a buffer which will be flushed to disk by a background thread.
+
+        Any number of ThreadedWriters can share the same TimeSliceThread. The thread
+        will serve whichever writer's FIFO is closest to overflowing first, so when
+        recording many tracks at once, the buffers fill and empty evenly. If one
+        thread can't keep up, the writers can be spread across several threads.
     */
     class ThreadedWriter
     {
@@ -238,6 +243,46 @@ public:
         */
         void setFlushInterval (int numSamplesPerFlush) noexcept;
 
+        /** Sets how many samples should be written before the writer's output stream is
+            flushed, which for a FileOutputStream forces the data out to the physical disk.
+            Set this to 0 to leave it to the OS (this is the default).
+        */
+        void setSyncInterval (int numSamplesPerSync) noexcept;
+
+        /** Sets the minimum number of samples that the background thread will write in one go.
+
+            By default, the thread writes whatever is in the FIFO each time it runs, which can
+            mean lots of small writes. If you set a batch size, it'll wait until there are at
+            least this many samples available and then write a multiple of the batch size. The
+            FIFO should be several times bigger than the batch size.
+        */
+        void setWriteBatchSize (int numSamples) noexcept;
+
+        /** Some counters describing how well the background thread has been keeping up. */
+        struct Statistics
+        {
+            /** The number of calls to write() that failed because the FIFO was full. */
+            int numOverruns = 0;
+
+            /** The number of samples that were rejected by those failed calls. */
+            int64 numSamplesDropped = 0;
+
+            /** The largest number of samples that were waiting in the FIFO, which is the
+                most that the data on disk has lagged behind the incoming data. */
+            int maxSamplesBuffered = 0;
+
+            /** The number of batches that have been written, and the total and longest
+                time that the AudioFormatWriter took to write them, in milliseconds. */
+            int64 numWrites = 0;
+            double totalWriteTimeMs = 0, maxWriteTimeMs = 0;
+        };
+
+        /** Returns the counters for this writer since it was created or last reset. */
+        Statistics getStatistics() const;
+
+        /** Resets the counters returned by getStatistics(). */
+        void resetStatistics();
+
     private:
         class Buffer;
         std::unique_ptr<Buffer> buffer;
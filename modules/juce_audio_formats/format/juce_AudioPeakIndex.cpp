@@ -0,0 +1,501 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+AudioPeakIndex::AudioPeakIndex (int numChans, int64 length, float levelScale)
+    : numChannels (numChans), lengthInSamples (length), scale (levelScale)
+{
+    levels.resize (1);
+    levels[0].resize ((size_t) (getNumBlocks() * numChannels));
+}
+
+std::unique_ptr<AudioPeakIndex> AudioPeakIndex::createFrom (AudioFormatReader& reader,
+                                                            const std::function<bool()>& shouldCancel)
+{
+    auto numChannels = (int) reader.numChannels;
+    auto numBlocks = reader.lengthInSamples / samplesPerBlock;
+
+    if (numChannels <= 0 || reader.lengthInSamples < 0)
+        return {};
+
+    // The exact levels are collected first, so that the scale can be chosen to fit
+    // any floating-point data that goes beyond +/-1.0 before they're quantised.
+    struct ExactLevels  { float minValue, maxValue, rms; };
+    std::vector<ExactLevels> exactLevels ((size_t) (numBlocks * numChannels));
+
+    const int blocksPerChunk = 64;
+    AudioBuffer<float> buffer (numChannels, blocksPerChunk * samplesPerBlock);
+    auto floatData = buffer.getArrayOfWritePointers();
+    float peak = 1.0f;
+
+    for (int64 block = 0; block < numBlocks; block += blocksPerChunk)
+    {
+        if (shouldCancel != nullptr && shouldCancel())
+            return {};
+
+        auto numBlocksToDo = (int) jmin ((int64) blocksPerChunk, numBlocks - block);
+        auto numSamples = numBlocksToDo * samplesPerBlock;
+
+        if (! reader.read (reinterpret_cast<int* const*> (floatData), numChannels,
+                           block * samplesPerBlock, numSamples, false))
+            return {};
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            if (! reader.usesFloatingPointData)
+                FloatVectorOperations::convertFixedToFloat (floatData[ch], reinterpret_cast<int*> (floatData[ch]),
+                                                            1.0f / (float) std::numeric_limits<int>::max(), numSamples);
+
+            for (int i = 0; i < numBlocksToDo; ++i)
+            {
+                auto* samples = floatData[ch] + i * samplesPerBlock;
+                auto range = FloatVectorOperations::findMinAndMax (samples, samplesPerBlock);
+                float sumOfSquares = 0;
+
+                for (int j = 0; j < samplesPerBlock; ++j)
+                    sumOfSquares += samples[j] * samples[j];
+
+                exactLevels[(size_t) ((block + i) * numChannels + ch)]
+                    = { range.getStart(), range.getEnd(), std::sqrt (sumOfSquares / (float) samplesPerBlock) };
+
+                peak = jmax (peak, -range.getStart(), range.getEnd());
+            }
+        }
+    }
+
+    std::unique_ptr<AudioPeakIndex> index (new AudioPeakIndex (numChannels, reader.lengthInSamples, peak));
+    auto& finestLevel = index->levels[0];
+
+    // The levels are rounded outwards, so that the quantised range always contains the real one
+    for (size_t i = 0; i < exactLevels.size(); ++i)
+    {
+        auto& e = exactLevels[i];
+        finestLevel[i] = { (int16)  jlimit (-32768.0, 32767.0, std::floor (e.minValue / (double) peak * 32767.0)),
+                           (int16)  jlimit (-32768.0, 32767.0, std::ceil  (e.maxValue / (double) peak * 32767.0)),
+                           (uint16) jlimit (0.0, 65535.0,      std::ceil  (e.rms      / (double) peak * 65535.0)) };
+    }
+
+    index->buildUpperLevels();
+    return index;
+}
+
+void AudioPeakIndex::buildUpperLevels()
+{
+    levels.resize (1);
+
+    for (;;)
+    {
+        auto& below = levels.back();
+        auto numBlocksBelow = below.size() / (size_t) numChannels;
+
+        if (numBlocksBelow < 2)
+            break;
+
+        std::vector<Entry> level ((numBlocksBelow / 2) * (size_t) numChannels);
+
+        for (size_t i = 0; i < level.size(); ++i)
+        {
+            auto block = i / (size_t) numChannels, ch = i % (size_t) numChannels;
+            auto& a = below[(2 * block) * (size_t) numChannels + ch];
+            auto& b = below[(2 * block + 1) * (size_t) numChannels + ch];
+            auto meanSquare = ((double) a.rmsValue * a.rmsValue + (double) b.rmsValue * b.rmsValue) * 0.5;
+
+            level[i] = { jmin (a.minValue, b.minValue),
+                         jmax (a.maxValue, b.maxValue),
+                         (uint16) jmin (65535.0, std::ceil (std::sqrt (meanSquare))) };
+        }
+
+        levels.push_back (std::move (level));
+    }
+}
+
+//==============================================================================
+void AudioPeakIndex::getLevels (int64 firstBlock, int64 numBlocks,
+                                Range<float>* ranges, float* rmsLevels, int numChannelsToRead) const noexcept
+{
+    jassert (numChannelsToRead > 0 && numChannelsToRead <= numChannels);
+
+    auto first = jmax ((int64) 0, firstBlock);
+    auto end = jmin (getNumBlocks(), firstBlock + numBlocks);
+
+    for (int ch = 0; ch < numChannelsToRead; ++ch)
+    {
+        if (ranges != nullptr)    ranges[ch] = {};
+        if (rmsLevels != nullptr) rmsLevels[ch] = 0;
+    }
+
+    if (end <= first)
+        return;
+
+    auto numBlocksUsed = end - first;
+    auto rangeScale = scale / 32767.0f;
+    auto rmsScale = scale / 65535.0f;
+    bool isFirstEntry = true;
+
+    auto addEntry = [&] (int level, int64 index)
+    {
+        auto* entries = levels[(size_t) level].data() + index * numChannels;
+
+        for (int ch = 0; ch < numChannelsToRead; ++ch)
+        {
+            auto& e = entries[ch];
+
+            if (ranges != nullptr)
+            {
+                Range<float> r (e.minValue * rangeScale, e.maxValue * rangeScale);
+                ranges[ch] = isFirstEntry ? r : ranges[ch].getUnionWith (r);
+            }
+
+            if (rmsLevels != nullptr)
+            {
+                auto rms = e.rmsValue * rmsScale;
+                rmsLevels[ch] += rms * rms * (float) (1 << level);
+            }
+        }
+
+        isFirstEntry = false;
+    };
+
+    // Walks up the pyramid, taking the entries at each end of the range that
+    // don't pair up with a neighbour inside it
+    for (int level = 0; first < end; ++level)
+    {
+        if ((first & 1) != 0)   addEntry (level, first++);
+        if ((end & 1) != 0)     addEntry (level, --end);
+
+        first >>= 1;
+        end >>= 1;
+    }
+
+    if (rmsLevels != nullptr)
+        for (int ch = 0; ch < numChannelsToRead; ++ch)
+            rmsLevels[ch] = std::sqrt (rmsLevels[ch] / (float) numBlocksUsed);
+}
+
+bool AudioPeakIndex::matches (const AudioFormatReader& reader) const noexcept
+{
+    return numChannels == (int) reader.numChannels
+            && lengthInSamples == reader.lengthInSamples;
+}
+
+size_t AudioPeakIndex::getMemoryUsage() const noexcept
+{
+    size_t total = sizeof (*this);
+
+    for (auto& level : levels)
+        total += level.size() * sizeof (Entry);
+
+    return total;
+}
+
+//==============================================================================
+static const int peakIndexMagic = (int) ByteOrder::littleEndianInt ("JPKI");
+static const int peakIndexVersion = 1;
+
+bool AudioPeakIndex::writeTo (OutputStream& output) const
+{
+    if (! (output.writeInt (peakIndexMagic)
+            && output.writeInt (peakIndexVersion)
+            && output.writeInt (numChannels)
+            && output.writeInt64 (lengthInSamples)
+            && output.writeInt (samplesPerBlock)
+            && output.writeFloat (scale)))
+        return false;
+
+    // Only the finest level is stored, because the others are quick to rebuild
+    auto& finestLevel = levels[0];
+    const size_t entriesPerChunk = 4096;
+    HeapBlock<uint16> chunk (entriesPerChunk * 3);
+
+    for (size_t i = 0; i < finestLevel.size(); i += entriesPerChunk)
+    {
+        auto numEntries = jmin (entriesPerChunk, finestLevel.size() - i);
+
+        for (size_t j = 0; j < numEntries; ++j)
+        {
+            auto& e = finestLevel[i + j];
+            chunk[j * 3]     = ByteOrder::swapIfBigEndian ((uint16) e.minValue);
+            chunk[j * 3 + 1] = ByteOrder::swapIfBigEndian ((uint16) e.maxValue);
+            chunk[j * 3 + 2] = ByteOrder::swapIfBigEndian (e.rmsValue);
+        }
+
+        if (! output.write (chunk, numEntries * 3 * sizeof (uint16)))
+            return false;
+    }
+
+    return true;
+}
+
+std::unique_ptr<AudioPeakIndex> AudioPeakIndex::createFrom (InputStream& input)
+{
+    if (input.readInt() != peakIndexMagic || input.readInt() != peakIndexVersion)
+        return {};
+
+    auto numChannels = input.readInt();
+    auto lengthInSamples = input.readInt64();
+    auto blockSize = input.readInt();
+    auto scale = input.readFloat();
+
+    if (numChannels <= 0 || numChannels > 1024 || lengthInSamples < 0
+         || blockSize != samplesPerBlock || ! (scale > 0))
+        return {};
+
+    // The header may come from a truncated or corrupt file, so make sure that there's
+    // enough data to back up its size before allocating anything for it.
+    auto bytesPerBlock = (int64) numChannels * 3 * (int64) sizeof (uint16);
+    auto bytesRemaining = input.getNumBytesRemaining();
+
+    if (bytesRemaining < 0 || lengthInSamples / samplesPerBlock > bytesRemaining / bytesPerBlock)
+        return {};
+
+    std::unique_ptr<AudioPeakIndex> index (new AudioPeakIndex (numChannels, lengthInSamples, scale));
+    auto& finestLevel = index->levels[0];
+    const size_t entriesPerChunk = 4096;
+    HeapBlock<uint16> chunk (entriesPerChunk * 3);
+
+    for (size_t i = 0; i < finestLevel.size(); i += entriesPerChunk)
+    {
+        auto numEntries = jmin (entriesPerChunk, finestLevel.size() - i);
+        auto numBytes = (int) (numEntries * 3 * sizeof (uint16));
+
+        if (input.read (chunk, numBytes) != numBytes)
+            return {};
+
+        for (size_t j = 0; j < numEntries; ++j)
+            finestLevel[i + j] = { (int16) ByteOrder::swapIfBigEndian (chunk[j * 3]),
+                                   (int16) ByteOrder::swapIfBigEndian (chunk[j * 3 + 1]),
+                                   ByteOrder::swapIfBigEndian (chunk[j * 3 + 2]) };
+    }
+
+    index->buildUpperLevels();
+    return index;
+}
+
+//==============================================================================
+File AudioPeakIndex::getSidecarFileFor (const File& audioFile)
+{
+    return audioFile.getSiblingFile (audioFile.getFileName() + ".peaks");
+}
+
+std::unique_ptr<AudioPeakIndex> AudioPeakIndex::loadSidecar (const File& audioFile, const AudioFormatReader& reader)
+{
+    auto sidecar = getSidecarFileFor (audioFile);
+
+    if (! sidecar.existsAsFile() || sidecar.getLastModificationTime() < audioFile.getLastModificationTime())
+        return {};
+
+    FileInputStream in (sidecar);
+
+    if (! in.openedOk())
+        return {};
+
+    auto index = createFrom (in);
+
+    if (index != nullptr && ! index->matches (reader))
+        return {};
+
+    return index;
+}
+
+bool AudioPeakIndex::writeSidecar (const File& audioFile) const
+{
+    TemporaryFile temp (getSidecarFileFor (audioFile));
+
+    {
+        FileOutputStream out (temp.getFile());
+
+        if (! (out.openedOk() && writeTo (out)))
+            return false;
+
+        out.flush();
+
+        if (out.getStatus().failed())
+            return false;
+    }
+
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct AudioPeakIndexTests  : public UnitTest
+{
+    AudioPeakIndexTests()  : UnitTest ("Audio peak index", "Audio") {}
+
+    enum { numChannels = 2, numSamples = 100000 };
+
+    void createTestFile (OutputStream* out)
+    {
+        AudioBuffer<float> buffer (numChannels, numSamples);
+        auto r = getRandom();
+
+        // random noise with a slowly-changing envelope, so that different blocks have different levels
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (ch, i, (r.nextFloat() * 2.0f - 1.0f) * std::abs (std::sin ((float) i * 0.0001f * (float) (ch + 1))));
+
+        WavAudioFormat wav;
+        std::unique_ptr<AudioFormatWriter> writer (wav.createWriterFor (out, 44100.0, numChannels, 16, {}, 0));
+        writer->writeFromAudioSampleBuffer (buffer, 0, numSamples);
+    }
+
+    void expectLevelsMatch (AudioFormatReader& indexedReader, AudioFormatReader& plainReader, bool allowNegativeStart)
+    {
+        auto r = getRandom();
+        const float tolerance = 2.0f / 32767.0f;
+
+        for (int i = 0; i < 200; ++i)
+        {
+            auto start = allowNegativeStart ? (int64) r.nextInt (numSamples + 1000) - 500
+                                            : (int64) r.nextInt (numSamples + 500);
+            auto length = (int64) r.nextInt (numSamples / (1 + r.nextInt (100)));
+            Range<float> expected[numChannels], actual[numChannels];
+
+            plainReader.readMaxLevels (start, length, expected, numChannels);
+            indexedReader.readMaxLevels (start, length, actual, numChannels);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                expect (actual[ch].getStart() <= expected[ch].getStart() + 1.0e-6f);
+                expect (actual[ch].getEnd()   >= expected[ch].getEnd()   - 1.0e-6f);
+                expectWithinAbsoluteError (actual[ch].getStart(), expected[ch].getStart(), tolerance);
+                expectWithinAbsoluteError (actual[ch].getEnd(),   expected[ch].getEnd(),   tolerance);
+            }
+        }
+    }
+
+    void runTest() override
+    {
+        WavAudioFormat wav;
+        MemoryBlock fileData;
+        createTestFile (new MemoryOutputStream (fileData, false));
+
+        auto createReader = [&] { return std::unique_ptr<AudioFormatReader> (wav.createReaderFor (new MemoryInputStream (fileData, false), true)); };
+
+        std::shared_ptr<const AudioPeakIndex> index;
+
+        beginTest ("Building");
+        {
+            auto reader = createReader();
+            index = AudioPeakIndex::createFrom (*reader);
+
+            expect (index != nullptr);
+            expect (index->matches (*reader));
+            expectEquals (index->getNumBlocks(), (int64) (numSamples / AudioPeakIndex::samplesPerBlock));
+            expectEquals (index->getNumLevels(), 9);
+
+            expect (AudioPeakIndex::createFrom (*reader, [] { return true; }) == nullptr);
+        }
+
+        beginTest ("Max levels");
+        {
+            auto indexedReader = createReader();
+            auto plainReader = createReader();
+            indexedReader->setPeakIndex (index);
+
+            expectLevelsMatch (*indexedReader, *plainReader, true);
+        }
+
+        beginTest ("RMS levels");
+        {
+            auto reader = createReader();
+            AudioBuffer<float> buffer (numChannels, numSamples);
+            reader->read (&buffer, 0, numSamples, 0, true, true);
+
+            auto r = getRandom();
+
+            for (int i = 0; i < 50; ++i)
+            {
+                auto firstBlock = r.nextInt ((int) index->getNumBlocks());
+                auto numBlocks = 1 + r.nextInt ((int) index->getNumBlocks() - firstBlock);
+                float rms[numChannels];
+
+                index->getLevels (firstBlock, numBlocks, nullptr, rms, numChannels);
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                    expectWithinAbsoluteError (rms[ch], buffer.getRMSLevel (ch, firstBlock * AudioPeakIndex::samplesPerBlock,
+                                                                            numBlocks * AudioPeakIndex::samplesPerBlock), 1.0e-3f);
+            }
+        }
+
+        beginTest ("Serialisation");
+        {
+            MemoryOutputStream out;
+            expect (index->writeTo (out));
+
+            MemoryInputStream in (out.getData(), out.getDataSize(), false);
+            auto loaded = AudioPeakIndex::createFrom (in);
+            expect (loaded != nullptr);
+            expectEquals (loaded->getNumLevels(), index->getNumLevels());
+
+            Range<float> original[numChannels], reloaded[numChannels];
+            index->getLevels (3, 301, original, nullptr, numChannels);
+            loaded->getLevels (3, 301, reloaded, nullptr, numChannels);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                expect (original[ch] == reloaded[ch]);
+
+            MemoryInputStream truncated (out.getData(), out.getDataSize() / 2, false);
+            expect (AudioPeakIndex::createFrom (truncated) == nullptr);
+
+            // a header that claims far more data than the stream holds
+            MemoryBlock corrupt (out.getData(), out.getDataSize());
+            auto hugeLength = ByteOrder::swapIfBigEndian ((int64) 1 << 50);
+            corrupt.copyFrom (&hugeLength, 12, sizeof (hugeLength));
+            MemoryInputStream corruptStream (corrupt, false);
+            expect (AudioPeakIndex::createFrom (corruptStream) == nullptr);
+        }
+
+        beginTest ("Sidecar files");
+        {
+            TemporaryFile temp (".wav");
+            createTestFile (new FileOutputStream (temp.getFile()));
+            auto sidecar = AudioPeakIndex::getSidecarFileFor (temp.getFile());
+
+            {
+                std::unique_ptr<AudioFormatReader> reader (wav.createReaderFor (temp.getFile().createInputStream(), true));
+                expect (AudioPeakIndex::loadSidecar (temp.getFile(), *reader) == nullptr);
+                expect (AudioPeakIndex::createFrom (*reader)->writeSidecar (temp.getFile()));
+            }
+
+            std::unique_ptr<MemoryMappedAudioFormatReader> mappedReader (wav.createMemoryMappedReader (temp.getFile()));
+            mappedReader->mapEntireFile();
+            mappedReader->setPeakIndex (AudioPeakIndex::loadSidecar (temp.getFile(), *mappedReader));
+            expect (mappedReader->getPeakIndex() != nullptr);
+
+            std::unique_ptr<AudioFormatReader> plainReader (wav.createReaderFor (temp.getFile().createInputStream(), true));
+            // (a memory-mapped reader can't scan a range that starts before the beginning of the file)
+            expectLevelsMatch (*mappedReader, *plainReader, false);
+
+            sidecar.deleteFile();
+        }
+    }
+};
+
+static AudioPeakIndexTests audioPeakIndexTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,146 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A pyramid of min/max/RMS summaries of an audio file, at power-of-two decimations.
+
+    The finest level summarises each block of samplesPerBlock samples, and each
+    level above that halves the resolution of the one below, so that the levels
+    of any range of the file can be found by combining a handful of entries
+    rather than decoding all of its samples.
+
+    Building an index means reading the whole file once, so you'll probably want
+    to do that on a background thread, and then write it to a sidecar file next to
+    the audio file with writeSidecar(), so that it can be reloaded quickly next
+    time with loadSidecar().
+
+    Once an index has been attached to a reader with AudioFormatReader::setPeakIndex(),
+    AudioFormatReader::readMaxLevels() will use it for any whole blocks in the range
+    it's asked for, and only read the samples at the edges of the range. An
+    AudioThumbnail that's reading from a file will also look for a sidecar file
+    and use it if it finds one.
+
+    The levels are stored as 16-bit values, so the ranges it returns may be up to
+    one quantisation step wider than the exact values.
+
+    @see AudioFormatReader::setPeakIndex
+
+    @tags{Audio}
+*/
+class JUCE_API  AudioPeakIndex
+{
+public:
+    //==============================================================================
+    /** Reads a whole file and builds an index for it.
+
+        If the shouldCancel function is supplied, it'll be called regularly while
+        reading, and if it returns true, this will give up and return nullptr.
+    */
+    static std::unique_ptr<AudioPeakIndex> createFrom (AudioFormatReader& reader,
+                                                       const std::function<bool()>& shouldCancel = {});
+
+    /** Recreates an index that was saved with writeTo().
+        Returns nullptr if the stream doesn't contain a valid index, or if its length isn't
+        known, as the size of the index is checked against it before anything is allocated.
+    */
+    static std::unique_ptr<AudioPeakIndex> createFrom (InputStream& serialisedData);
+
+    /** Writes the index to a stream, in a format that createFrom (InputStream&) can read. */
+    bool writeTo (OutputStream& output) const;
+
+    //==============================================================================
+    /** Returns the file that writeSidecar() and loadSidecar() use for a given audio file. */
+    static File getSidecarFileFor (const File& audioFile);
+
+    /** Loads the sidecar index for an audio file, if there is one.
+
+        This returns nullptr if the sidecar file is missing, or if it's older than the
+        audio file, or if it doesn't match the reader's length and number of channels.
+    */
+    static std::unique_ptr<AudioPeakIndex> loadSidecar (const File& audioFile, const AudioFormatReader& reader);
+
+    /** Saves this index as the sidecar file for an audio file. */
+    bool writeSidecar (const File& audioFile) const;
+
+    //==============================================================================
+    /** Returns true if this index has the same length and number of channels as the reader. */
+    bool matches (const AudioFormatReader& reader) const noexcept;
+
+    /** Returns the number of channels that the index contains. */
+    int getNumChannels() const noexcept                 { return numChannels; }
+
+    /** Returns the length of the file that the index was built from. */
+    int64 getLengthInSamples() const noexcept           { return lengthInSamples; }
+
+    /** Returns the number of whole blocks at the finest level of the index.
+        Any samples after the last whole block aren't covered by the index.
+    */
+    int64 getNumBlocks() const noexcept                 { return lengthInSamples / samplesPerBlock; }
+
+    /** Returns the number of levels in the pyramid. */
+    int getNumLevels() const noexcept                   { return (int) levels.size(); }
+
+    /** Finds the levels of a range of whole blocks.
+
+        @param firstBlock       the index of the first block, where block n covers the samples
+                                from n * samplesPerBlock to (n + 1) * samplesPerBlock
+        @param numBlocks        the number of blocks to combine
+        @param ranges           if this isn't nullptr, it must contain numChannelsToRead
+                                elements, which will be filled with the min and max levels
+        @param rmsLevels        if this isn't nullptr, it must contain numChannelsToRead
+                                elements, which will be filled with the RMS levels
+        @param numChannelsToRead  the number of channels to read, which must not be more than
+                                the number of channels in the index
+    */
+    void getLevels (int64 firstBlock, int64 numBlocks,
+                    Range<float>* ranges, float* rmsLevels, int numChannelsToRead) const noexcept;
+
+    /** Returns the number of bytes that the index is currently using. */
+    size_t getMemoryUsage() const noexcept;
+
+    /** The number of samples summarised by each entry at the finest level of the pyramid. */
+    enum { samplesPerBlock = 256 };
+
+private:
+    //==============================================================================
+    struct Entry
+    {
+        int16 minValue, maxValue;
+        uint16 rmsValue;
+    };
+
+    int numChannels = 0;
+    int64 lengthInSamples = 0;
+    float scale = 1.0f;
+    std::vector<std::vector<Entry>> levels;
+
+    AudioPeakIndex (int numChannels, int64 lengthInSamples, float scale);
+    void buildUpperLevels();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioPeakIndex)
+};
+
+} // namespace juce
@@ -50,6 +50,9 @@ BufferingAudioReader::BufferingAudioReader (AudioFormatReader* sourceReader,
 BufferingAudioReader::~BufferingAudioReader()
 {
     thread.removeTimeSliceClient (this);
+
+    const ScopedLock sl (decodingLock);
+    stopDecodeJobs();
 }
 
 void BufferingAudioReader::setReadTimeout (int timeoutMilliseconds) noexcept
@@ -57,6 +60,39 @@ void BufferingAudioReader::setReadTimeout (int timeoutMilliseconds) noexcept
     timeoutMs = timeoutMilliseconds;
 }
 
+void BufferingAudioReader::setReadAheadDepth (int samplesToBuffer) noexcept
+{
+    numBlocks = 1 + (samplesToBuffer / samplesPerBlock);
+}
+
+void BufferingAudioReader::setParallelDecoding (ThreadPool* pool,
+                                                std::function<AudioFormatReader*()> createSourceReader,
+                                                int maxSimultaneousJobs)
+{
+    jassert (pool == nullptr || createSourceReader != nullptr);
+
+    const ScopedLock sl (decodingLock);
+
+    stopDecodeJobs();
+    spareDecodingReaders.clear();
+
+    decodingPool = pool;
+    createDecodingReader = std::move (createSourceReader);
+    maxDecodingJobs = jmax (1, maxSimultaneousJobs);
+}
+
+BufferingAudioReader::Statistics BufferingAudioReader::getStatistics() const
+{
+    const ScopedLock sl (lock);
+    return statistics;
+}
+
+void BufferingAudioReader::resetStatistics()
+{
+    const ScopedLock sl (lock);
+    statistics = {};
+}
+
 bool BufferingAudioReader::readSamples (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
                                         int64 startSampleInFile, int numSamples)
 {
@@ -65,7 +101,16 @@ bool BufferingAudioReader::readSamples (int** destSamples, int numDestChannels,
                                        startSampleInFile, numSamples, lengthInSamples);
 
     const ScopedLock sl (lock);
-    nextReadPosition = startSampleInFile;
+
+    auto previousReadPosition = nextReadPosition.exchange (startSampleInFile);
+
+    if (startSampleInFile != previousReadPosition)
+        isReadingBackwards = startSampleInFile < previousReadPosition;
+
+    if (numSamples <= 0)
+        return true;
+
+    double waitStartTime = 0;
 
     while (numSamples > 0)
     {
@@ -93,12 +138,19 @@ bool BufferingAudioReader::readSamples (int** destSamples, int numDestChannels,
         }
         else
         {
+            if (waitStartTime == 0)
+            {
+                waitStartTime = Time::getMillisecondCounterHiRes();
+                thread.moveToFrontOfQueue (this);
+            }
+
             if (timeoutMs >= 0 && Time::getMillisecondCounter() >= startTime + (uint32) timeoutMs)
             {
                 for (int j = 0; j < numDestChannels; ++j)
                     if (auto dest = (float*) destSamples[j])
                         FloatVectorOperations::clear (dest + startOffsetInDestBuffer, numSamples);
 
+                ++statistics.numTimeouts;
                 break;
             }
             else
@@ -109,6 +161,19 @@ bool BufferingAudioReader::readSamples (int** destSamples, int numDestChannels,
         }
     }
 
+    if (waitStartTime != 0)
+    {
+        auto waitTime = Time::getMillisecondCounterHiRes() - waitStartTime;
+
+        ++statistics.numMisses;
+        statistics.totalWaitMs += waitTime;
+        statistics.maxWaitMs = jmax (statistics.maxWaitMs, waitTime);
+    }
+    else
+    {
+        ++statistics.numHits;
+    }
+
     return true;
 }
 
@@ -128,35 +193,162 @@ BufferingAudioReader::BufferedBlock* BufferingAudioReader::getBlockContaining (i
     return nullptr;
 }
 
+Range<int64> BufferingAudioReader::getRangeToBuffer() const noexcept
+{
+    auto pos = nextReadPosition.load();
+    auto length = (int64) numBlocks.load() * samplesPerBlock;
+
+    if (isReadingBackwards)
+    {
+        auto endPos = ((pos + 1024) / samplesPerBlock + 1) * samplesPerBlock;
+        return { jmax ((int64) 0, endPos - length), endPos };
+    }
+
+    auto startPos = ((pos - 1024) / samplesPerBlock) * samplesPerBlock;
+    return { startPos, startPos + length };
+}
+
+//==============================================================================
+struct BufferingAudioReader::DecodeJob  : public ThreadPoolJob
+{
+    DecodeJob (AudioFormatReader* r, int64 pos)
+        : ThreadPoolJob ("BufferingAudioReader"), reader (r), position (pos)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        block.reset (new BufferedBlock (*reader, position, samplesPerBlock));
+        isFinished = true;
+        return jobHasFinished;
+    }
+
+    std::unique_ptr<AudioFormatReader> reader;
+    const int64 position;
+    std::unique_ptr<BufferedBlock> block;
+    std::atomic<bool> isFinished { false };
+
+    JUCE_DECLARE_NON_COPYABLE (DecodeJob)
+};
+
+bool BufferingAudioReader::startDecodeJobs (Range<int64> rangeToBuffer, OwnedArray<BufferedBlock>& newBlocks)
+{
+    bool anyFinished = false;
+
+    for (int i = decodeJobs.size(); --i >= 0;)
+    {
+        auto* job = decodeJobs.getUnchecked (i);
+
+        // A job that has finished running may still be being tidied up by the pool, and
+        // mustn't be deleted until the pool has let go of it
+        if (job->isFinished && ! decodingPool->contains (job))
+        {
+            if (job->block->range.intersects (rangeToBuffer))
+                newBlocks.add (job->block.release());
+
+            spareDecodingReaders.add (job->reader.release());
+            decodeJobs.remove (i);
+            anyFinished = true;
+        }
+    }
+
+    auto isBufferedOrInProgress = [&] (int64 pos)
+    {
+        for (auto* b : newBlocks)
+            if (b->range.contains (pos))
+                return true;
+
+        for (auto* job : decodeJobs)
+            if (job->position == pos)
+                return true;
+
+        return false;
+    };
+
+    // The blocks nearest to the read position, in the direction it's moving, are started first
+    auto numBlocksToBuffer = (int) (rangeToBuffer.getLength() / samplesPerBlock);
+
+    for (int i = 0; i < numBlocksToBuffer && decodeJobs.size() < maxDecodingJobs; ++i)
+    {
+        auto pos = isReadingBackwards ? rangeToBuffer.getEnd() - (i + 1) * samplesPerBlock
+                                      : rangeToBuffer.getStart() + i * samplesPerBlock;
+
+        if (isBufferedOrInProgress (pos))
+            continue;
+
+        auto* reader = spareDecodingReaders.size() > 0 ? spareDecodingReaders.removeAndReturn (spareDecodingReaders.size() - 1)
+                                                       : createDecodingReader();
+
+        if (reader == nullptr)
+            break;
+
+        auto* job = decodeJobs.add (new DecodeJob (reader, pos));
+        decodingPool->addJob (job, false);
+    }
+
+    return anyFinished;
+}
+
+void BufferingAudioReader::stopDecodeJobs()
+{
+    for (auto* job : decodeJobs)
+        decodingPool->removeJob (job, false, -1);
+
+    decodeJobs.clear();
+}
+
+//==============================================================================
 int BufferingAudioReader::useTimeSlice()
 {
-    return readNextBufferChunk() ? 1 : 100;
+    if (readNextBufferChunk())
+        return 1;
+
+    const ScopedLock sl (decodingLock);
+    return decodeJobs.isEmpty() ? 100 : 1;
 }
 
 bool BufferingAudioReader::readNextBufferChunk()
 {
-    auto pos = nextReadPosition.load();
-    auto startPos = ((pos - 1024) / samplesPerBlock) * samplesPerBlock;
-    auto endPos = startPos + numBlocks * samplesPerBlock;
+    auto rangeToBuffer = getRangeToBuffer();
 
     OwnedArray<BufferedBlock> newBlocks;
 
     for (int i = blocks.size(); --i >= 0;)
-        if (blocks.getUnchecked(i)->range.intersects (Range<int64> (startPos, endPos)))
+        if (blocks.getUnchecked(i)->range.intersects (rangeToBuffer))
             newBlocks.add (blocks.getUnchecked(i));
 
-    if (newBlocks.size() == numBlocks)
     {
-        newBlocks.clear (false);
-        return false;
-    }
+        const ScopedLock sl (decodingLock);
 
-    for (auto p = startPos; p < endPos; p += samplesPerBlock)
-    {
-        if (getBlockContaining (p) == nullptr)
+        if (decodingPool != nullptr)
+        {
+            if (! startDecodeJobs (rangeToBuffer, newBlocks) && newBlocks.size() == blocks.size())
+            {
+                newBlocks.clear (false);
+                return false;
+            }
+        }
+        else
         {
-            newBlocks.add (new BufferedBlock (*source, p, samplesPerBlock));
-            break; // just do one block
+            auto numBlocksToBuffer = (int) (rangeToBuffer.getLength() / samplesPerBlock);
+
+            if (newBlocks.size() == numBlocksToBuffer && newBlocks.size() == blocks.size())
+            {
+                newBlocks.clear (false);
+                return false;
+            }
+
+            for (int i = 0; i < numBlocksToBuffer; ++i)
+            {
+                auto p = isReadingBackwards ? rangeToBuffer.getEnd() - (i + 1) * samplesPerBlock
+                                            : rangeToBuffer.getStart() + i * samplesPerBlock;
+
+                if (getBlockContaining (p) == nullptr)
+                {
+                    newBlocks.add (new BufferedBlock (*source, p, samplesPerBlock));
+                    break; // just do one block
+                }
+            }
         }
     }
 
@@ -171,4 +363,154 @@ bool BufferingAudioReader::readNextBufferChunk()
     return true;
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct BufferingAudioReaderTests  : public UnitTest
+{
+    BufferingAudioReaderTests()  : UnitTest ("BufferingAudioReader", "Audio") {}
+
+    enum { numChannels = 2, numSamples = 441000, blockSize = 32768, chunkSize = 1000 };
+
+    MemoryBlock createTestFile (int length)
+    {
+        AudioBuffer<float> buffer (numChannels, length);
+        auto r = getRandom();
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < length; ++i)
+                buffer.setSample (ch, i, r.nextFloat() - 0.5f);
+
+        MemoryBlock block;
+        WavAudioFormat wav;
+
+        {
+            std::unique_ptr<AudioFormatWriter> writer (wav.createWriterFor (new MemoryOutputStream (block, false),
+                                                                            44100.0, numChannels, 24, {}, 0));
+            writer->writeFromAudioSampleBuffer (buffer, 0, length);
+        }
+
+        return block;
+    }
+
+    void expectChunksMatch (AudioFormatReader& reader, AudioFormatReader& expectedReader, bool backwards)
+    {
+        AudioBuffer<float> expected (numChannels, chunkSize), actual (numChannels, chunkSize);
+        bool allMatched = true;
+
+        for (int i = 0; i < numSamples / chunkSize; ++i)
+        {
+            auto pos = backwards ? numSamples - (i + 1) * chunkSize : i * chunkSize;
+
+            expectedReader.read (&expected, 0, chunkSize, pos, true, true);
+            reader.read (&actual, 0, chunkSize, pos, true, true);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                allMatched = allMatched && memcmp (expected.getReadPointer (ch), actual.getReadPointer (ch), sizeof (float) * chunkSize) == 0;
+        }
+
+        expect (allMatched);
+    }
+
+    void runTest() override
+    {
+        auto file = createTestFile (numSamples);
+        WavAudioFormat wav;
+
+        auto createReader = [&]() -> AudioFormatReader* { return wav.createReaderFor (new MemoryInputStream (file, false), true); };
+        std::unique_ptr<AudioFormatReader> sourceReader (createReader());
+
+        TimeSliceThread thread ("BufferingAudioReader test");
+        thread.startThread();
+
+        beginTest ("Reading forwards and backwards");
+        {
+            BufferingAudioReader reader (createReader(), thread, 2 * blockSize);
+            reader.setReadTimeout (-1);
+
+            expectChunksMatch (reader, *sourceReader, false);
+            expectChunksMatch (reader, *sourceReader, true);
+
+            auto stats = reader.getStatistics();
+            expectEquals (stats.numHits + stats.numMisses, (int64) (2 * (numSamples / chunkSize)));
+            expectEquals (stats.numTimeouts, (int64) 0);
+
+            reader.resetStatistics();
+            expectEquals (reader.getStatistics().numHits, (int64) 0);
+        }
+
+        beginTest ("Read-ahead follows the direction of reading");
+        {
+            BufferingAudioReader reader (createReader(), thread, 2 * blockSize);
+            reader.setReadTimeout (-1);
+
+            AudioBuffer<float> buffer (numChannels, chunkSize);
+            const int64 pos = 10 * blockSize + 5000;
+
+            reader.read (&buffer, 0, chunkSize, pos, true, true);
+            reader.read (&buffer, 0, chunkSize, pos - chunkSize, true, true);
+            Thread::sleep (300);
+
+            // this block is only buffered if the reader has noticed that it's going backwards
+            reader.resetStatistics();
+            reader.read (&buffer, 0, chunkSize, pos - 40000, true, true);
+            expectEquals (reader.getStatistics().numHits, (int64) 1);
+        }
+
+        beginTest ("Parallel decoding");
+        {
+            ThreadPool pool (2);
+            BufferingAudioReader reader (createReader(), thread, 4 * blockSize);
+            reader.setReadTimeout (-1);
+            reader.setParallelDecoding (&pool, createReader, 3);
+
+            expectChunksMatch (reader, *sourceReader, false);
+            expectChunksMatch (reader, *sourceReader, true);
+
+            reader.setParallelDecoding (nullptr, {}, 0);
+            expectChunksMatch (reader, *sourceReader, false);
+        }
+
+        beginTest ("Many short parallel decodes");
+        {
+            // Blocks beyond the end of a short file are quick to decode, so lots of jobs
+            // finish while their readers are collecting the ones before them
+            auto shortFile = createTestFile (1000);
+            auto createShortReader = [&]() -> AudioFormatReader* { return wav.createReaderFor (new MemoryInputStream (shortFile, false), true); };
+            std::unique_ptr<AudioFormatReader> shortSourceReader (createShortReader());
+
+            ThreadPool pool (4);
+            OwnedArray<BufferingAudioReader> readers;
+
+            for (int i = 0; i < 4; ++i)
+            {
+                auto* reader = readers.add (new BufferingAudioReader (createShortReader(), thread, 2 * blockSize));
+                reader->setReadTimeout (-1);
+                reader->setParallelDecoding (&pool, createShortReader, 4);
+            }
+
+            auto random = getRandom();
+            AudioBuffer<float> expected (numChannels, chunkSize), actual (numChannels, chunkSize);
+            bool allMatched = true;
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                auto pos = (int64) random.nextInt (64) * blockSize + random.nextInt (blockSize - chunkSize);
+
+                shortSourceReader->read (&expected, 0, chunkSize, pos, true, true);
+                readers[i % readers.size()]->read (&actual, 0, chunkSize, pos, true, true);
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                    allMatched = allMatched && memcmp (expected.getReadPointer (ch), actual.getReadPointer (ch), sizeof (float) * chunkSize) == 0;
+            }
+
+            expect (allMatched);
+        }
+    }
+};
+
+static BufferingAudioReaderTests bufferingAudioReaderTests;
+
+#endif
+
 } // namespace juce
@@ -32,6 +32,13 @@ namespace juce
     An AudioFormatReader that uses a background thread to pre-read data from
     another reader.
 
+    The reader keeps a window of blocks around the position that was last read.
+    It notices whether the reads are moving forwards or backwards through the
+    source, and extends the window in that direction.
+
+    When the source is expensive to decode, the blocks can also be decoded in
+    parallel on a ThreadPool - see setParallelDecoding().
+
     @see AudioFormatReader
 
     @tags{Audio}
@@ -63,6 +70,51 @@ public:
     */
     void setReadTimeout (int timeoutMilliseconds) noexcept;
 
+    /** Changes the number of samples that are read ahead of the current position.
+        The initial value is the samplesToBuffer parameter that was given to the constructor.
+    */
+    void setReadAheadDepth (int samplesToBuffer) noexcept;
+
+    /** Lets the reader decode several blocks at once on a ThreadPool.
+
+        Each job that's running needs a source reader of its own, so you need to supply a
+        function that creates new readers for the same audio data as the original source
+        (e.g. by opening the same file again). Each job reads a block from an arbitrary
+        position, so this is only worthwhile for formats which can seek quickly.
+
+        @param pool                  the pool to run the jobs on, or nullptr to go back to
+                                     decoding everything on the TimeSliceThread. The pool
+                                     must not be deleted while this reader is using it.
+        @param createSourceReader    a function that returns a new reader for the same audio
+                                     data, which the caller will take ownership of
+        @param maxSimultaneousJobs   the maximum number of blocks to decode at once
+    */
+    void setParallelDecoding (ThreadPool* pool,
+                              std::function<AudioFormatReader*()> createSourceReader,
+                              int maxSimultaneousJobs);
+
+    /** Some counters describing how well the read-ahead is keeping up. */
+    struct Statistics
+    {
+        /** The number of readSamples() calls where all the data was already buffered. */
+        int64 numHits = 0;
+
+        /** The number of readSamples() calls that had to wait for some of their data. */
+        int64 numMisses = 0;
+
+        /** The number of readSamples() calls that timed out and returned some silence. */
+        int64 numTimeouts = 0;
+
+        /** The total and longest time spent waiting in readSamples(), in milliseconds. */
+        double totalWaitMs = 0, maxWaitMs = 0;
+    };
+
+    /** Returns the counters for all the reads since the last call to resetStatistics(). */
+    Statistics getStatistics() const;
+
+    /** Resets all the counters returned by getStatistics(). */
+    void resetStatistics();
+
     bool readSamples (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
                       int64 startSampleInFile, int numSamples) override;
 
@@ -70,8 +122,10 @@ private:
     std::unique_ptr<AudioFormatReader> source;
     TimeSliceThread& thread;
     std::atomic<int64> nextReadPosition { 0 };
-    const int numBlocks;
+    std::atomic<bool> isReadingBackwards { false };
+    std::atomic<int> numBlocks;
     int timeoutMs = 0;
+    Statistics statistics;
 
     enum { samplesPerBlock = 32768 };
 
@@ -86,9 +140,20 @@ private:
     CriticalSection lock;
     OwnedArray<BufferedBlock> blocks;
 
+    struct DecodeJob;
+    CriticalSection decodingLock;
+    ThreadPool* decodingPool = nullptr;
+    std::function<AudioFormatReader*()> createDecodingReader;
+    int maxDecodingJobs = 0;
+    OwnedArray<DecodeJob> decodeJobs;
+    OwnedArray<AudioFormatReader> spareDecodingReaders;
+
     BufferedBlock* getBlockContaining (int64 pos) const noexcept;
+    Range<int64> getRangeToBuffer() const noexcept;
     int useTimeSlice() override;
     bool readNextBufferChunk();
+    bool startDecodeJobs (Range<int64> rangeToBuffer, OwnedArray<BufferedBlock>& newBlocks);
+    void stopDecodeJobs();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BufferingAudioReader)
 };
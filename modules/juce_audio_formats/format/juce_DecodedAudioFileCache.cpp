@@ -0,0 +1,215 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+static const char* const decodedAudioFileCacheSuffix = ".decoded.wav";
+
+DecodedAudioFileCache::DecodedAudioFileCache (AudioFormatManager& fm, const File& directory)
+    : formatManager (fm), cacheDirectory (directory)
+{
+}
+
+DecodedAudioFileCache::~DecodedAudioFileCache() {}
+
+//==============================================================================
+MemoryMappedAudioFormatReader* DecodedAudioFileCache::createMemoryMappedReader (const File& audioFile)
+{
+    if (! audioFile.existsAsFile())
+        return nullptr;
+
+    if (auto* format = formatManager.findFormatForFileExtension (audioFile.getFileExtension()))
+        if (auto* directReader = format->createMemoryMappedReader (audioFile))
+            return directReader;
+
+    auto cacheFile = getCacheFileFor (audioFile);
+
+    if (! cacheFile.existsAsFile() && ! decodeIntoCache (audioFile, cacheFile))
+        return nullptr;
+
+    WavAudioFormat wavFormat;
+    return wavFormat.createMemoryMappedReader (cacheFile);
+}
+
+File DecodedAudioFileCache::getCacheFileFor (const File& audioFile) const
+{
+    auto key = audioFile.getFullPathName().hashCode64()
+                 ^ (audioFile.getSize() * 31)
+                 ^ (audioFile.getLastModificationTime().toMilliseconds() * 97);
+
+    return cacheDirectory.getChildFile (audioFile.getFileNameWithoutExtension()
+                                          + "_" + String::toHexString (key)
+                                          + decodedAudioFileCacheSuffix);
+}
+
+void DecodedAudioFileCache::clear()
+{
+    for (auto& f : cacheDirectory.findChildFiles (File::findFiles, false, String ("*") + decodedAudioFileCacheSuffix))
+        f.deleteFile();
+}
+
+bool DecodedAudioFileCache::decodeIntoCache (const File& audioFile, const File& cacheFile)
+{
+    std::unique_ptr<AudioFormatReader> reader (formatManager.createReaderFor (audioFile));
+
+    if (reader == nullptr || reader->lengthInSamples <= 0 || ! cacheDirectory.createDirectory())
+        return false;
+
+    // Integer data keeps its bit-depth, but anything else gets stored as floats, so that
+    // the decoded samples are kept exactly as they came out of the decoder
+    auto bitsPerSample = (! reader->usesFloatingPointData && (reader->bitsPerSample == 16 || reader->bitsPerSample == 24))
+                            ? (int) reader->bitsPerSample : 32;
+
+    // The data is written to a temporary file first, so that if a reader for the same file
+    // is being created on another thread, it'll never find a half-written cache file
+    TemporaryFile tempFile (cacheFile);
+
+    {
+        std::unique_ptr<FileOutputStream> out (tempFile.getFile().createOutputStream());
+
+        if (out == nullptr)
+            return false;
+
+        WavAudioFormat wavFormat;
+        std::unique_ptr<AudioFormatWriter> writer (wavFormat.createWriterFor (out.get(), reader->sampleRate,
+                                                                              reader->numChannels, bitsPerSample,
+                                                                              {}, 0));
+        if (writer == nullptr)
+            return false;
+
+        out.release();
+
+        if (! writer->writeFromAudioReader (*reader, 0, -1))
+            return false;
+    }
+
+    return tempFile.overwriteTargetFileWithTemporary();
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS && JUCE_USE_FLAC
+
+struct DecodedAudioFileCacheTests  : public UnitTest
+{
+    DecodedAudioFileCacheTests()  : UnitTest ("DecodedAudioFileCache", "Audio") {}
+
+    enum { numTestChannels = 2, numTestSamples = 30000 };
+
+    static bool writeTestFile (AudioFormat& format, const File& file, const AudioBuffer<float>& buffer)
+    {
+        std::unique_ptr<AudioFormatWriter> writer (format.createWriterFor (file.createOutputStream(), 44100.0,
+                                                                           numTestChannels, 16, {}, 0));
+        return writer != nullptr && writer->writeFromAudioSampleBuffer (buffer, 0, buffer.getNumSamples());
+    }
+
+    void expectReadersMatch (AudioFormatReader& expected, MemoryMappedAudioFormatReader& mapped)
+    {
+        expectEquals (mapped.lengthInSamples, expected.lengthInSamples);
+        expectEquals ((int) mapped.numChannels, (int) expected.numChannels);
+        expect (mapped.mapEntireFile());
+
+        AudioBuffer<float> a (numTestChannels, numTestSamples), b (numTestChannels, numTestSamples);
+        expected.read (&a, 0, numTestSamples, 0, true, true);
+        mapped.read (&b, 0, numTestSamples, 0, true, true);
+
+        for (int ch = 0; ch < numTestChannels; ++ch)
+            expect (memcmp (a.getReadPointer (ch), b.getReadPointer (ch), sizeof (float) * numTestSamples) == 0);
+
+        for (int i = 0; i < 10; ++i)
+        {
+            auto pos = getRandom().nextInt (numTestSamples);
+            float sample[numTestChannels];
+            mapped.getSample (pos, sample);
+
+            for (int ch = 0; ch < numTestChannels; ++ch)
+                expectEquals (sample[ch], a.getSample (ch, pos));
+        }
+    }
+
+    void runTest() override
+    {
+        auto dir = File::createTempFile ("decodedcache");
+        dir.createDirectory();
+
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        DecodedAudioFileCache cache (formatManager, dir.getChildFile ("cache"));
+
+        AudioBuffer<float> buffer (numTestChannels, numTestSamples);
+        auto r = getRandom();
+
+        for (int ch = 0; ch < numTestChannels; ++ch)
+            for (int i = 0; i < numTestSamples; ++i)
+                buffer.setSample (ch, i, r.nextFloat() - 0.5f);
+
+        beginTest ("Compressed files");
+        {
+            auto flacFile = dir.getChildFile ("test.flac");
+            FlacAudioFormat flac;
+            expect (writeTestFile (flac, flacFile, buffer));
+
+            std::unique_ptr<MemoryMappedAudioFormatReader> mapped (cache.createMemoryMappedReader (flacFile));
+            std::unique_ptr<AudioFormatReader> original (formatManager.createReaderFor (flacFile));
+            expect (mapped != nullptr && original != nullptr);
+            expect (mapped->getFile() == cache.getCacheFileFor (flacFile));
+            expectReadersMatch (*original, *mapped);
+
+            // a second reader should use the same cached file
+            auto cacheTime = cache.getCacheFileFor (flacFile).getLastModificationTime();
+            mapped.reset (cache.createMemoryMappedReader (flacFile));
+            expect (mapped != nullptr);
+            expect (cache.getCacheFileFor (flacFile).getLastModificationTime() == cacheTime);
+            mapped.reset();
+
+            cache.clear();
+            expect (! cache.getCacheFileFor (flacFile).exists());
+        }
+
+        beginTest ("Uncompressed files");
+        {
+            WavAudioFormat wav;
+            AiffAudioFormat aiff;
+
+            for (auto* format : { static_cast<AudioFormat*> (&wav), static_cast<AudioFormat*> (&aiff) })
+            {
+                auto file = dir.getChildFile ("test" + format->getFileExtensions()[0]);
+                expect (writeTestFile (*format, file, buffer));
+
+                std::unique_ptr<MemoryMappedAudioFormatReader> mapped (cache.createMemoryMappedReader (file));
+                std::unique_ptr<AudioFormatReader> original (formatManager.createReaderFor (file));
+                expect (mapped != nullptr && original != nullptr);
+                expect (mapped->getFile() == file);
+                expect (! cache.getCacheFileFor (file).exists());
+                expectReadersMatch (*original, *mapped);
+            }
+        }
+
+        dir.deleteRecursively();
+    }
+};
+
+static DecodedAudioFileCacheTests decodedAudioFileCacheTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Gives fast random access to compressed audio files, by decoding them into
+    uncompressed files which can be memory-mapped.
+
+    Formats such as FLAC, Ogg-Vorbis and MP3 can't be memory-mapped, and reading from
+    random positions in them means seeking and decoding the same data over and over
+    again. This class decodes each file once, stores the result as a WAV file in a
+    cache directory, and hands out MemoryMappedAudioFormatReaders for that copy.
+
+    Files whose format already supports memory-mapping, like WAV and AIFF, aren't
+    copied - you just get a memory-mapped reader for the original file.
+
+    The cached copies are named using the original file's path, size and
+    modification time, so if a file is changed, it'll get decoded again. The
+    cache directory should be one that's used only for this purpose.
+
+    @see MemoryMappedAudioFormatReader, AudioFormat::createMemoryMappedReader
+
+    @tags{Audio}
+*/
+class JUCE_API  DecodedAudioFileCache
+{
+public:
+    //==============================================================================
+    /** Creates a cache which keeps its files in the given directory.
+
+        The AudioFormatManager is used to open the files, and must not be deleted
+        before the cache.
+    */
+    DecodedAudioFileCache (AudioFormatManager& formatManager, const File& cacheDirectory);
+
+    /** Destructor. This doesn't delete any of the cached files. */
+    ~DecodedAudioFileCache();
+
+    //==============================================================================
+    /** Returns a memory-mapped reader for an audio file.
+
+        If the file's format can be memory-mapped directly, this just returns a reader
+        for it. Otherwise, the file will be decoded into the cache directory if it's not
+        already there, which may take a while for a long file, and the reader that's
+        returned reads from the decoded copy.
+
+        As with any MemoryMappedAudioFormatReader, you'll need to call mapEntireFile() or
+        mapSectionOfFile() on the reader before using it.
+
+        @returns a new reader, which the caller must delete, or nullptr if the file
+                 couldn't be read or decoded
+    */
+    MemoryMappedAudioFormatReader* createMemoryMappedReader (const File& audioFile);
+
+    /** Returns the file in the cache directory that the decoded copy of a file is
+        stored in. The file may or may not exist.
+    */
+    File getCacheFileFor (const File& audioFile) const;
+
+    /** Returns the directory in which the decoded files are kept. */
+    const File& getCacheDirectory() const noexcept          { return cacheDirectory; }
+
+    /** Deletes all the decoded files from the cache directory. */
+    void clear();
+
+private:
+    //==============================================================================
+    AudioFormatManager& formatManager;
+    const File cacheDirectory;
+
+    bool decodeIntoCache (const File& audioFile, const File& cacheFile);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DecodedAudioFileCache)
+};
+
+} // namespace juce
@@ -53,10 +53,49 @@ SamplerSound::SamplerSound (const String& soundName,
     }
 }
 
+SamplerSound::SamplerSound (const String& soundName,
+                            AudioFormatReader* source,
+                            const BigInteger& notes,
+                            int midiNoteForNormalPitch,
+                            double attackTimeSecs,
+                            double releaseTimeSecs,
+                            double maxSampleLengthSeconds,
+                            double preloadTimeSeconds)
+    : name (soundName),
+      sourceSampleRate (source != nullptr ? source->sampleRate : 0.0),
+      midiNotes (notes),
+      midiRootNote (midiNoteForNormalPitch),
+      streamingSource (source)
+{
+    if (sourceSampleRate > 0 && source->lengthInSamples > 0)
+    {
+        length = jmin ((int) source->lengthInSamples,
+                       (int) (maxSampleLengthSeconds * sourceSampleRate));
+
+        preloadLength = jmin (length + 4, jmax (0, (int) (preloadTimeSeconds * sourceSampleRate)));
+
+        data.reset (new AudioBuffer<float> (jmin (2, (int) source->numChannels), preloadLength));
+        source->read (data.get(), 0, preloadLength, 0, true, true);
+
+        params.attack  = static_cast<float> (attackTimeSecs);
+        params.release = static_cast<float> (releaseTimeSecs);
+    }
+
+    // if it's short enough to fit into the preload buffer, there's nothing to stream
+    if (preloadLength >= length + 4)
+        streamingSource.reset();
+}
+
 SamplerSound::~SamplerSound()
 {
 }
 
+void SamplerSound::readFromStreamingSource (AudioBuffer<float>& buffer, int64 startSample, int numSamples)
+{
+    const ScopedLock sl (streamingSourceLock);
+    streamingSource->read (&buffer, 0, numSamples, startSample, true, true);
+}
+
 bool SamplerSound::appliesToNote (int midiNoteNumber)
 {
     return midiNotes[midiNoteNumber];
@@ -67,18 +106,156 @@ bool SamplerSound::appliesToChannel (int /*midiChannel*/)
     return true;
 }
 
+//==============================================================================
+// Reads ahead of a voice's play position on a TimeSliceThread, into a circular buffer.
+// The play position is owned by the audio thread, and the end of the valid data by the
+// streaming thread. Each new note bumps a generation number, and the buffer is only used
+// once the streaming thread has caught up with the generation of the current note.
+struct SamplerVoice::DiskStream  : public TimeSliceClient
+{
+    DiskStream (TimeSliceThread& t, int bufferSize)
+        : thread (t),
+          buffer (2, nextPowerOfTwo (jmax (bufferSize, 2 * chunkSize))),
+          tempBuffer (2, chunkSize)
+    {
+        buffer.clear();
+        thread.addTimeSliceClient (this);
+    }
+
+    ~DiskStream() override
+    {
+        thread.removeTimeSliceClient (this);
+    }
+
+    // Called by the audio thread when a note starts or stops
+    void setSound (SamplerSound* newSound, double sourceSamplesPerSecond)
+    {
+        playPosition = 0;
+        samplesPerMillisecond = (float) (sourceSamplesPerSecond / 1000.0);
+
+        const SpinLock::ScopedLockType sl (soundLock);
+        sound = newSound;
+        ++requestedGeneration;
+    }
+
+    // Called by the audio thread at the start of each block, to find out how far
+    // into the sound it can play
+    int64 getAvailableEnd (const SamplerSound& s, int64 position) noexcept
+    {
+        playPosition = position;
+
+        if (filledGeneration.load() != requestedGeneration)
+            return s.preloadLength;
+
+        return validEnd.load();
+    }
+
+    float getSample (const SamplerSound& s, int channel, int64 position) const noexcept
+    {
+        if (position < s.preloadLength)
+            return s.data->getSample (channel, (int) position);
+
+        return buffer.getSample (channel, (int) (position & (buffer.getNumSamples() - 1)));
+    }
+
+    //==============================================================================
+    int useTimeSlice() override
+    {
+        SynthesiserSound::Ptr soundToRead;
+        int generation;
+
+        {
+            const SpinLock::ScopedLockType sl (soundLock);
+            soundToRead = sound;
+            generation = requestedGeneration;
+        }
+
+        auto* s = static_cast<SamplerSound*> (soundToRead.get());
+
+        if (generation != filledGeneration.load())
+        {
+            validEnd = s != nullptr ? s->preloadLength : 0;
+            filledGeneration = generation;
+        }
+
+        if (s == nullptr || ! s->isStreaming())
+            return 20;
+
+        auto start = validEnd.load();
+        auto end = jmin ((int64) s->length + 4, playPosition.load() + buffer.getNumSamples());
+        auto numToRead = (int) jmin ((int64) chunkSize, end - start);
+
+        if (numToRead <= 0)
+            return 5;
+
+        s->readFromStreamingSource (tempBuffer, start, numToRead);
+
+        auto bufferSize = buffer.getNumSamples();
+        auto bufferPos = (int) (start & (bufferSize - 1));
+        auto numBeforeWrap = jmin (numToRead, bufferSize - bufferPos);
+
+        for (int i = 0; i < s->data->getNumChannels(); ++i)
+        {
+            buffer.copyFrom (i, bufferPos, tempBuffer, i, 0, numBeforeWrap);
+
+            if (numToRead > numBeforeWrap)
+                buffer.copyFrom (i, 0, tempBuffer, i, numBeforeWrap, numToRead - numBeforeWrap);
+        }
+
+        validEnd = start + numToRead;
+        return 0;
+    }
+
+    int getMillisecondsUntilDeadline() override
+    {
+        if (filledGeneration.load() != requestedGeneration)
+            return 0;
+
+        auto rate = samplesPerMillisecond.load();
+
+        if (rate <= 0)
+            return std::numeric_limits<int>::max();
+
+        auto samplesAhead = validEnd.load() - playPosition.load();
+        return jmax (0, (int) jmin ((double) std::numeric_limits<int>::max(), (double) samplesAhead / rate));
+    }
+
+    //==============================================================================
+    enum { chunkSize = 8192 };
+
+    TimeSliceThread& thread;
+    AudioBuffer<float> buffer, tempBuffer;
+
+    SpinLock soundLock;
+    SynthesiserSound::Ptr sound;
+    std::atomic<int> requestedGeneration { 0 }, filledGeneration { 0 };
+    std::atomic<int64> playPosition { 0 }, validEnd { 0 };
+    std::atomic<float> samplesPerMillisecond { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE (DiskStream)
+};
+
 //==============================================================================
 SamplerVoice::SamplerVoice() {}
+
+SamplerVoice::SamplerVoice (TimeSliceThread& streamingThread, int streamBufferSize)
+    : stream (new DiskStream (streamingThread, streamBufferSize))
+{
+}
+
 SamplerVoice::~SamplerVoice() {}
 
 bool SamplerVoice::canPlaySound (SynthesiserSound* sound)
 {
-    return dynamic_cast<const SamplerSound*> (sound) != nullptr;
+    if (auto* s = dynamic_cast<const SamplerSound*> (sound))
+        return stream != nullptr || ! s->isStreaming();
+
+    return false;
 }
 
 void SamplerVoice::startNote (int midiNoteNumber, float velocity, SynthesiserSound* s, int /*currentPitchWheelPosition*/)
 {
-    if (auto* sound = dynamic_cast<const SamplerSound*> (s))
+    if (auto* sound = dynamic_cast<SamplerSound*> (s))
     {
         pitchRatio = std::pow (2.0, (midiNoteNumber - sound->midiRootNote) / 12.0)
                         * sound->sourceSampleRate / getSampleRate();
@@ -90,6 +267,9 @@ void SamplerVoice::startNote (int midiNoteNumber, float velocity, SynthesiserSou
         adsr.setSampleRate (sound->sourceSampleRate);
         adsr.setParameters (sound->params);
 
+        if (stream != nullptr && sound->isStreaming())
+            stream->setSound (sound, pitchRatio * getSampleRate());
+
         adsr.noteOn();
     }
     else
@@ -108,6 +288,9 @@ void SamplerVoice::stopNote (float /*velocity*/, bool allowTailOff)
     {
         clearCurrentNote();
         adsr.reset();
+
+        if (stream != nullptr)
+            stream->setSound (nullptr, 0.0);
     }
 }
 
@@ -119,6 +302,12 @@ void SamplerVoice::renderNextBlock (AudioBuffer<float>& outputBuffer, int startS
 {
     if (auto* playingSound = static_cast<SamplerSound*> (getCurrentlyPlayingSound().get()))
     {
+        if (playingSound->isStreaming())
+        {
+            renderStreamedBlock (*playingSound, outputBuffer, startSample, numSamples);
+            return;
+        }
+
         auto& data = *playingSound->data;
         const float* const inL = data.getReadPointer (0);
         const float* const inR = data.getNumChannels() > 1 ? data.getReadPointer (1) : nullptr;
@@ -163,4 +352,204 @@ void SamplerVoice::renderNextBlock (AudioBuffer<float>& outputBuffer, int startS
     }
 }
 
+void SamplerVoice::renderStreamedBlock (SamplerSound& sound, AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+{
+    jassert (stream != nullptr); // this voice can't play sounds that are streamed!
+
+    auto availableEnd = stream->getAvailableEnd (sound, (int64) sourceSamplePosition);
+    auto isStereo = sound.data->getNumChannels() > 1;
+    bool hasUnderrun = false;
+
+    float* outL = outputBuffer.getWritePointer (0, startSample);
+    float* outR = outputBuffer.getNumChannels() > 1 ? outputBuffer.getWritePointer (1, startSample) : nullptr;
+
+    while (--numSamples >= 0)
+    {
+        auto pos = (int64) sourceSamplePosition;
+        auto alpha = (float) (sourceSamplePosition - pos);
+        auto invAlpha = 1.0f - alpha;
+        float l = 0, r = 0;
+
+        if (pos + 1 < availableEnd)
+        {
+            l = stream->getSample (sound, 0, pos) * invAlpha + stream->getSample (sound, 0, pos + 1) * alpha;
+            r = isStereo ? stream->getSample (sound, 1, pos) * invAlpha + stream->getSample (sound, 1, pos + 1) * alpha
+                         : l;
+        }
+        else
+        {
+            hasUnderrun = true;
+        }
+
+        auto envelopeValue = adsr.getNextSample();
+
+        l *= lgain * envelopeValue;
+        r *= rgain * envelopeValue;
+
+        if (outR != nullptr)
+        {
+            *outL++ += l;
+            *outR++ += r;
+        }
+        else
+        {
+            *outL++ += (l + r) * 0.5f;
+        }
+
+        sourceSamplePosition += pitchRatio;
+
+        if (sourceSamplePosition > sound.length)
+        {
+            stopNote (0.0f, false);
+            break;
+        }
+    }
+
+    if (hasUnderrun)
+        ++numUnderruns;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct SamplerStreamingTests  : public UnitTest
+{
+    SamplerStreamingTests()  : UnitTest ("Sampler streaming", "Audio") {}
+
+    enum { sampleRate = 44100, sampleLength = 3 * sampleRate, blockSize = 512 };
+
+    MemoryBlock createTestFile()
+    {
+        AudioBuffer<float> buffer (2, sampleLength);
+        auto r = getRandom();
+
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < sampleLength; ++i)
+                buffer.setSample (ch, i, r.nextFloat() - 0.5f);
+
+        MemoryBlock block;
+        WavAudioFormat wav;
+
+        {
+            std::unique_ptr<AudioFormatWriter> writer (wav.createWriterFor (new MemoryOutputStream (block, false),
+                                                                            sampleRate, 2, 24, {}, 0));
+            writer->writeFromAudioSampleBuffer (buffer, 0, sampleLength);
+        }
+
+        return block;
+    }
+
+    static AudioFormatReader* createReader (const MemoryBlock& file)
+    {
+        WavAudioFormat wav;
+        return wav.createReaderFor (new MemoryInputStream (file, false), true);
+    }
+
+    static void setUpSynth (Synthesiser& synth, SamplerVoice* voice, SamplerSound* sound)
+    {
+        synth.addVoice (voice);
+        synth.addSound (sound);
+        synth.setCurrentPlaybackSampleRate (sampleRate);
+    }
+
+    static void renderBlock (Synthesiser& synth, AudioBuffer<float>& buffer, bool startNote)
+    {
+        MidiBuffer midi;
+
+        if (startNote)
+            midi.addEvent (MidiMessage::noteOn (1, 60, 1.0f), 0);
+
+        buffer.clear();
+        synth.renderNextBlock (buffer, midi, 0, blockSize);
+    }
+
+    // Waits until a voice's streaming thread has read up to the given position
+    static bool waitForStream (SamplerVoice& voice, int64 endNeeded)
+    {
+        auto& stream = *voice.stream;
+        auto timeout = Time::getMillisecondCounter() + 10000;
+
+        while (stream.filledGeneration.load() != stream.requestedGeneration.load()
+                 || stream.validEnd.load() < endNeeded)
+        {
+            if (Time::getMillisecondCounter() > timeout)
+                return false;
+
+            Thread::sleep (1);
+        }
+
+        return true;
+    }
+
+    void runTest() override
+    {
+        auto file = createTestFile();
+        BigInteger allNotes;
+        allNotes.setRange (0, 128, true);
+
+        beginTest ("Streamed sounds match sounds held in memory");
+        {
+            TimeSliceThread thread ("sampler streaming test");
+            thread.startThread();
+
+            std::unique_ptr<AudioFormatReader> reader (createReader (file));
+            Synthesiser inMemory, streamed;
+            auto* streamingVoice = new SamplerVoice (thread, 16384);
+
+            setUpSynth (inMemory, new SamplerVoice(), new SamplerSound ("test", *reader, allNotes, 60, 0.0, 0.1, 10.0));
+            setUpSynth (streamed, streamingVoice, new SamplerSound ("test", createReader (file), allNotes, 60, 0.0, 0.1, 10.0, 0.1));
+
+            expect (static_cast<SamplerSound*> (streamed.getSound (0).get())->isStreaming());
+
+            AudioBuffer<float> expected (2, blockSize), actual (2, blockSize);
+
+            for (int block = 0; block < sampleLength / blockSize; ++block)
+            {
+                // the reading is allowed to take as long as it needs, as this is only
+                // checking that what's streamed is what would have been played from memory
+                if (block > 0)
+                    expect (waitForStream (*streamingVoice, (block + 1) * blockSize + 1));
+
+                renderBlock (inMemory, expected, block == 0);
+                renderBlock (streamed, actual, block == 0);
+
+                for (int ch = 0; ch < 2; ++ch)
+                    expect (memcmp (expected.getReadPointer (ch), actual.getReadPointer (ch), sizeof (float) * blockSize) == 0);
+            }
+
+            expectEquals (streamingVoice->getNumUnderruns(), 0);
+        }
+
+        beginTest ("Underruns");
+        {
+            // (this thread is never started, so nothing will be read beyond the preloaded part)
+            TimeSliceThread thread ("sampler streaming test");
+            Synthesiser synth;
+            auto* voice = new SamplerVoice (thread);
+            setUpSynth (synth, voice, new SamplerSound ("test", createReader (file), allNotes, 60, 0.0, 0.1, 10.0, 0.05));
+
+            AudioBuffer<float> buffer (2, blockSize);
+            auto preloadBlocks = (int) (0.05 * sampleRate) / blockSize;
+
+            for (int block = 0; block < preloadBlocks; ++block)
+            {
+                renderBlock (synth, buffer, block == 0);
+                expect (buffer.getMagnitude (0, blockSize) > 0.0f);
+            }
+
+            expectEquals (voice->getNumUnderruns(), 0);
+
+            for (int block = 0; block < 10; ++block)
+                renderBlock (synth, buffer, false);
+
+            expectEquals (buffer.getMagnitude (0, blockSize), 0.0f);
+            expectEquals (voice->getNumUnderruns(), 10);
+        }
+    }
+};
+
+static SamplerStreamingTests samplerStreamingTests;
+
+#endif
+
 } // namespace juce
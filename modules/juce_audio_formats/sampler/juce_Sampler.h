@@ -31,8 +31,9 @@ namespace juce
 /**
     A subclass of SynthesiserSound that represents a sampled audio clip.
 
-    This is a pretty basic sampler, and just attempts to load the whole audio stream
-    into memory.
+    This is a pretty basic sampler. It can either load the whole audio stream into
+    memory, or just load the beginning of it and stream the rest from its source while
+    it's being played, which lets you use samples that are too big to keep in memory.
 
     To use it, create a Synthesiser, add some SamplerVoice objects to it, then
     give it some SampledSound objects to play.
@@ -71,6 +72,40 @@ public:
                   double releaseTimeSecs,
                   double maxSampleLengthSeconds);
 
+    /** Creates a sampled sound which streams its audio from a reader while it plays.
+
+        Only the first part of the audio is loaded into memory when the sound is created.
+        The rest of it is read from the source as it's needed, which means that the sound
+        can only be played by SamplerVoices that were created with a TimeSliceThread to do
+        this streaming.
+
+        The preload time needs to be long enough to cover the time it takes for a voice's
+        streaming thread to start reading from the source after a note begins. If the
+        streaming falls behind, the voice will play silence, and will report an underrun.
+
+        @param name         a name for the sample
+        @param source       the audio to play. The sound takes ownership of this reader, and
+                            will keep reading from it until the sound is deleted. It may be a
+                            MemoryMappedAudioFormatReader, as long as the part of the file that
+                            is going to be played has been mapped
+        @param midiNotes    the set of midi keys that this sound should be played on
+        @param midiNoteForNormalPitch   the midi note at which the sample should be played
+                                        with its natural rate
+        @param attackTimeSecs   the attack (fade-in) time, in seconds
+        @param releaseTimeSecs  the decay (fade-out) time, in seconds
+        @param maxSampleLengthSeconds   a maximum length of audio to play, in seconds
+        @param preloadTimeSeconds       the length of audio at the start of the sample
+                                        to load into memory, in seconds
+    */
+    SamplerSound (const String& name,
+                  AudioFormatReader* source,
+                  const BigInteger& midiNotes,
+                  int midiNoteForNormalPitch,
+                  double attackTimeSecs,
+                  double releaseTimeSecs,
+                  double maxSampleLengthSeconds,
+                  double preloadTimeSeconds);
+
     /** Destructor. */
     ~SamplerSound() override;
 
@@ -79,10 +114,16 @@ public:
     const String& getName() const noexcept                  { return name; }
 
     /** Returns the audio sample data.
+        For a sound that's streamed, this only contains the part that has been preloaded.
         This could return nullptr if there was a problem loading the data.
     */
     AudioBuffer<float>* getAudioData() const noexcept       { return data.get(); }
 
+    /** Returns true if the part of the sample that isn't held in memory is streamed from
+        its source while it's being played.
+    */
+    bool isStreaming() const noexcept                       { return streamingSource != nullptr; }
+
     //==============================================================================
     /** Changes the parameters of the ADSR envelope which will be applied to the sample. */
     void setEnvelopeParameters (ADSR::Parameters parametersToUse)    { params = parametersToUse; }
@@ -99,10 +140,15 @@ private:
     std::unique_ptr<AudioBuffer<float>> data;
     double sourceSampleRate;
     BigInteger midiNotes;
-    int length = 0, midiRootNote = 0;
+    int length = 0, midiRootNote = 0, preloadLength = 0;
 
     ADSR::Parameters params;
 
+    std::unique_ptr<AudioFormatReader> streamingSource;
+    CriticalSection streamingSourceLock;
+
+    void readFromStreamingSource (AudioBuffer<float>&, int64 startSample, int numSamples);
+
     JUCE_LEAK_DETECTOR (SamplerSound)
 };
 
@@ -125,6 +171,19 @@ public:
     /** Creates a SamplerVoice. */
     SamplerVoice();
 
+    /** Creates a SamplerVoice which can also play SamplerSounds that are streamed.
+
+        The voice will use the thread you give it to read ahead of the position that it's
+        playing. Voices that share a thread have their reads scheduled so that the ones
+        that are closest to running out of data are served first. The thread must not be
+        deleted before the voice, and must be started before any notes are played.
+
+        @param streamingThread      the thread to use for reading from the sounds
+        @param streamBufferSize     the number of samples of the sound to buffer ahead
+                                    of the play position
+    */
+    explicit SamplerVoice (TimeSliceThread& streamingThread, int streamBufferSize = 32768);
+
     /** Destructor. */
     ~SamplerVoice() override;
 
@@ -139,6 +198,16 @@ public:
 
     void renderNextBlock (AudioBuffer<float>&, int startSample, int numSamples) override;
 
+    //==============================================================================
+    /** Returns the number of blocks in which a streamed sound couldn't be played
+        because the data hadn't been read from its source in time.
+        @see resetNumUnderruns
+    */
+    int getNumUnderruns() const noexcept                { return numUnderruns; }
+
+    /** Resets the count returned by getNumUnderruns() to zero. */
+    void resetNumUnderruns() noexcept                   { numUnderruns = 0; }
+
 private:
     //==============================================================================
     double pitchRatio = 0;
@@ -147,6 +216,14 @@ private:
 
     ADSR adsr;
 
+    struct DiskStream;
+    std::unique_ptr<DiskStream> stream;
+    std::atomic<int> numUnderruns { 0 };
+
+    void renderStreamedBlock (SamplerSound&, AudioBuffer<float>&, int startSample, int numSamples);
+
+    friend struct SamplerStreamingTests;
+
     JUCE_LEAK_DETECTOR (SamplerVoice)
 };
 
@@ -213,14 +213,34 @@ private:
     AudioThumbnail& owner;
     std::unique_ptr<InputSource> source;
     std::unique_ptr<AudioFormatReader> reader;
+    std::shared_ptr<const AudioPeakIndex> peakIndex;
+    bool hasLookedForPeakIndex = false;
     CriticalSection readerLock;
     uint32 lastReaderUseTime = 0;
 
     void createReader()
     {
         if (reader == nullptr && source != nullptr)
+        {
             if (auto* audioFileStream = source->createInputStream())
+            {
+                auto* fileStream = dynamic_cast<FileInputStream*> (audioFileStream);
+                auto file = fileStream != nullptr ? fileStream->getFile() : File();
+
                 reader.reset (owner.formatManagerToUse.createReaderFor (audioFileStream));
+
+                if (reader != nullptr)
+                {
+                    // If the file has a sidecar peak index, we'll load it once and keep hold of it,
+                    // because the reader may be deleted and re-created many times
+                    if (! hasLookedForPeakIndex && file != File())
+                        peakIndex = AudioPeakIndex::loadSidecar (file, *reader);
+
+                    hasLookedForPeakIndex = true;
+                    reader->setPeakIndex (peakIndex);
+                }
+            }
+        }
     }
 
     bool readNextBlock()
@@ -44,7 +44,10 @@ namespace juce
     The thumbnail stores an internal low-res version of the wave data, and this can
     be loaded and saved to avoid having to scan the file again.
 
-    @see AudioThumbnailCache, AudioThumbnailBase
+    If the source is a file that has a sidecar AudioPeakIndex, the thumbnail will use
+    that rather than reading all the samples.
+
+    @see AudioThumbnailCache, AudioThumbnailBase, AudioPeakIndex
 
     @tags{Audio}
 */
@@ -161,6 +161,8 @@ void AudioProcessorPlayer::audioDeviceIOCallback (const float** const inputChann
 
             if (! processor->isSuspended())
             {
+                AudioProcessLoadMeasurer::ScopedTimer timer (loadMeasurer);
+
                 if (processor->isUsingDoublePrecision())
                 {
                     conversionBuffer.makeCopyOf (buffer, true);
@@ -199,6 +201,7 @@ void AudioProcessorPlayer::audioDeviceAboutToStart (AudioIODevice* const device)
     numOutputChans = numChansOut;
 
     messageCollector.reset (sampleRate);
+    loadMeasurer.reset (sampleRate, blockSize);
     channels.calloc (jmax (numChansIn, numChansOut) + 2);
 
     if (processor != nullptr)
@@ -223,6 +226,12 @@ void AudioProcessorPlayer::audioDeviceStopped()
     blockSize = 0;
     isPrepared = false;
     tempBuffer.setSize (1, 1);
+    loadMeasurer.reset();
+}
+
+AudioProcessLoadMeasurer::Statistics AudioProcessorPlayer::getLoadStatistics() const
+{
+    return loadMeasurer.getStatistics();
 }
 
 void AudioProcessorPlayer::handleIncomingMidiMessage (MidiInput*, const MidiMessage& message)
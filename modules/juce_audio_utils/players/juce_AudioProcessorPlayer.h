@@ -91,6 +91,12 @@ public:
     */
     inline bool getDoublePrecisionProcessing() { return isDoublePrecision; }
 
+    /** Returns a snapshot of how long the processor has been taking to render each block
+        since the audio device was started. This can be called from any thread.
+        @see AudioProcessLoadMeasurer::getStatistics
+    */
+    AudioProcessLoadMeasurer::Statistics getLoadStatistics() const;
+
     //==============================================================================
     /** @internal */
     void audioDeviceIOCallback (const float**, int, float**, int, int) override;
@@ -117,6 +123,7 @@ private:
     MidiBuffer incomingMidi;
     MidiMessageCollector messageCollector;
     MidiOutput* midiOutput = nullptr;
+    AudioProcessLoadMeasurer loadMeasurer;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioProcessorPlayer)
 };
@@ -1193,6 +1193,26 @@ public:
         expect (tempFile.exists());
         expect (! tempFile2.exists());
 
+        beginTest ("Preallocation");
+        {
+            FileOutputStream fo (tempFile);
+            expect (fo.openedOk());
+
+            // not every filesystem can do this, but when it works it mustn't change the file
+            if (fo.preallocate (100000).wasOk())
+            {
+                expectEquals (tempFile.getSize(), (int64) 10);
+                expect (fo.preallocate (5).wasOk());
+                expectEquals (tempFile.getSize(), (int64) 10);
+            }
+
+            fo.write ("0123456789", 10);
+            fo.flush();
+            expectEquals (tempFile.getSize(), (int64) 20);
+        }
+
+        expect (tempFile.loadFileAsString() == "abcdefghij0123456789");
+
         expect (demoFolder.deleteRecursively());
         expect (! demoFolder.exists());
     }
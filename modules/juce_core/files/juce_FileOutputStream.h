@@ -96,6 +96,16 @@ public:
     */
     Result truncate();
 
+    /** Asks the OS to reserve space on the disk for the file to grow to a given size.
+
+        This doesn't change the size of the file, but when you know roughly how much you're
+        going to write (e.g. when recording), it lets the filesystem allocate the space in
+        one go, which keeps the file contiguous and avoids the cost of extending it later.
+        Not all platforms and filesystems can do this, in which case it'll return an error,
+        and the file will just grow as normal.
+    */
+    Result preallocate (int64 totalNumBytes);
+
     //==============================================================================
     void flush() override;
     int64 getPosition() override;
@@ -585,6 +585,39 @@ Result FileOutputStream::truncate()
     return getResultForReturnValue (ftruncate (getFD (fileHandle), (off_t) currentPosition));
 }
 
+Result FileOutputStream::preallocate (int64 totalNumBytes)
+{
+    if (fileHandle == nullptr)
+        return status;
+
+   #if JUCE_LINUX
+    return getResultForReturnValue (fallocate (getFD (fileHandle), FALLOC_FL_KEEP_SIZE, 0, (off_t) totalNumBytes));
+   #elif JUCE_MAC || JUCE_IOS
+    // F_PEOFPOSMODE reserves space past the end of the file, so only ask for what's missing
+    struct stat info;
+
+    if (fstat (getFD (fileHandle), &info) != 0)
+        return getResultForErrno();
+
+    auto numBytesNeeded = totalNumBytes - (int64) info.st_size;
+
+    if (numBytesNeeded <= 0)
+        return Result::ok();
+
+    fstore_t store = { F_ALLOCATECONTIG, F_PEOFPOSMODE, 0, (off_t) numBytesNeeded, 0 };
+
+    if (fcntl (getFD (fileHandle), F_PREALLOCATE, &store) != -1)
+        return Result::ok();
+
+    // if there's no contiguous space, try again allowing the space to be fragmented
+    store.fst_flags = F_ALLOCATEALL;
+    return getResultForReturnValue (fcntl (getFD (fileHandle), F_PREALLOCATE, &store));
+   #else
+    ignoreUnused (totalNumBytes);
+    return Result::fail ("Preallocation isn't supported on this platform");
+   #endif
+}
+
 //==============================================================================
 String SystemStats::getEnvironmentVariable (const String& name, const String& defaultValue)
 {
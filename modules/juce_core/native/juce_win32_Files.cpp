@@ -373,6 +373,29 @@ Result FileOutputStream::truncate()
                                               : WindowsFileHelpers::getResultForLastError();
 }
 
+Result FileOutputStream::preallocate (int64 totalNumBytes)
+{
+    if (fileHandle == nullptr)
+        return status;
+
+   #if JUCE_MINGW
+    ignoreUnused (totalNumBytes);
+    return Result::fail ("Preallocation isn't supported on this platform");
+   #else
+    // a smaller allocation than the file's current size would truncate it
+    LARGE_INTEGER currentSize;
+
+    if (GetFileSizeEx ((HANDLE) fileHandle, &currentSize) && currentSize.QuadPart >= totalNumBytes)
+        return Result::ok();
+
+    FILE_ALLOCATION_INFO info;
+    info.AllocationSize.QuadPart = totalNumBytes;
+
+    return SetFileInformationByHandle ((HANDLE) fileHandle, FileAllocationInfo, &info, sizeof (info))
+             ? Result::ok() : WindowsFileHelpers::getResultForLastError();
+   #endif
+}
+
 //==============================================================================
 void MemoryMappedFile::openInternal (const File& file, AccessMode mode, bool exclusive)
 {
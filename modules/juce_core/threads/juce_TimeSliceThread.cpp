@@ -101,17 +101,27 @@ TimeSliceClient* TimeSliceThread::getClient (const int i) const
 //==============================================================================
 TimeSliceClient* TimeSliceThread::getNextClient (int index) const
 {
+    auto now = Time::getCurrentTime();
     Time soonest;
     TimeSliceClient* client = nullptr;
+    int earliestDeadline = 0;
 
     for (int i = clients.size(); --i >= 0;)
     {
         auto* c = clients.getUnchecked ((i + index) % clients.size());
 
-        if (client == nullptr || c->nextCallTime < soonest)
+        // Clients that are already due get called in order of their deadlines, and then
+        // in order of how long they've been waiting
+        auto deadline = c->nextCallTime <= now ? c->getMillisecondsUntilDeadline()
+                                               : std::numeric_limits<int>::max();
+
+        if (client == nullptr
+             || deadline < earliestDeadline
+             || (deadline == earliestDeadline && c->nextCallTime < soonest))
         {
             client = c;
             soonest = c->nextCallTime;
+            earliestDeadline = deadline;
         }
     }
 
@@ -181,4 +191,56 @@ void TimeSliceThread::run()
     }
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class TimeSliceThreadTests  : public UnitTest
+{
+public:
+    TimeSliceThreadTests() : UnitTest ("TimeSliceThread", "Threads") {}
+
+    struct TestClient  : public TimeSliceClient
+    {
+        TestClient (Array<int>& order, int d)  : callOrder (order), deadline (d) {}
+
+        int useTimeSlice() override
+        {
+            callOrder.add (deadline);
+            return -1;
+        }
+
+        int getMillisecondsUntilDeadline() override   { return deadline; }
+
+        Array<int>& callOrder;
+        const int deadline;
+    };
+
+    void runTest() override
+    {
+        beginTest ("Deadlines");
+        {
+            Array<int> callOrder;
+            OwnedArray<TestClient> clients;
+            TimeSliceThread thread ("TimeSliceThread test");
+
+            for (auto deadline : { 30, 10, std::numeric_limits<int>::max(), 40, 20 })
+                thread.addTimeSliceClient (clients.add (new TestClient (callOrder, deadline)));
+
+            thread.startThread();
+
+            for (int i = 0; i < 200 && thread.getNumClients() > 0; ++i)
+                Thread::sleep (5);
+
+            thread.stopThread (1000);
+
+            expectEquals (callOrder.size(), 5);
+            expect (callOrder == Array<int> (10, 20, 30, 40, std::numeric_limits<int>::max()));
+        }
+    }
+};
+
+static TimeSliceThreadTests timeSliceThreadTests;
+
+#endif
+
 } // namespace juce
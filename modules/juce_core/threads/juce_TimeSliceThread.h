@@ -63,6 +63,22 @@ public:
     */
     virtual int useTimeSlice() = 0;
 
+    /** Can be overridden to tell the TimeSliceThread how urgently this client needs its
+        next time-slice.
+
+        When more than one client is due to be called, the thread will call the one with the
+        earliest deadline first, and clients with the same deadline will take turns. The
+        default implementation returns std::numeric_limits<int>::max(), i.e. no deadline, so
+        if none of your clients override this, they'll just be called round-robin.
+
+        This is called on the TimeSliceThread, while it's choosing which client to call next,
+        so it needs to be quick.
+
+        @returns    the number of milliseconds before this client will run into trouble if it
+                    isn't given another time-slice
+    */
+    virtual int getMillisecondsUntilDeadline()       { return std::numeric_limits<int>::max(); }
+
 
 private:
     friend class TimeSliceThread;
@@ -104,6 +120,8 @@ public:
     /** Adds a client to the list.
         The client's callbacks will start after the number of milliseconds specified
         by millisecondsBeforeStarting (and this may happen before this method has returned).
+
+        @see TimeSliceClient::getMillisecondsUntilDeadline
     */
     void addTimeSliceClient (TimeSliceClient* clientToAdd, int millisecondsBeforeStarting = 0);
 
@@ -495,12 +495,17 @@ public:
         }
         else
         {
-            for (size_t i = 0; i < numSamples; ++i)
+            SampleType scalers[256];
+
+            for (size_t i = 0; i < numSamples;)
             {
-                const auto scaler = value.getNextValue();
+                auto n = jmin (numSamples - i, (size_t) numElementsInArray (scalers));
+                value.getNextValues (scalers, (int) n);
 
                 for (size_t ch = 0; ch < numChannels; ++ch)
-                    channelPtr (ch)[i] *= scaler;
+                    FloatVectorOperations::multiply (channelPtr (ch) + i, scalers, (int) n);
+
+                i += n;
             }
         }
 
@@ -520,13 +525,17 @@ public:
         else
         {
             auto n = jmin (numSamples, src.numSamples) * sizeFactor;
+            SampleType scalers[256];
 
-            for (size_t i = 0; i < n; ++i)
+            for (size_t i = 0; i < n;)
             {
-                const auto scaler = value.getNextValue();
+                auto num = jmin (n - i, (size_t) numElementsInArray (scalers));
+                value.getNextValues (scalers, (int) num);
 
                 for (size_t ch = 0; ch < numChannels; ++ch)
-                    channelPtr (ch)[i] = scaler * src.getChannelPointer (ch)[i];
+                    FloatVectorOperations::multiply (channelPtr (ch) + i, src.getChannelPointer (ch) + i, scalers, (int) num);
+
+                i += num;
             }
         }
 